@@ -1,2 +1,3 @@
 glslc vert.vert -o vert.spv
 glslc frag.frag -o frag.spv
+glslc cull.comp -o cull.spv
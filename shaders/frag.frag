@@ -12,28 +12,14 @@ layout(binding = 0) uniform FrameUBO {
     mat4 proj;
     vec4 globalAlbedo;
     vec4 lightDir;
+    vec4 frustumPlanes[6];
 } frame;
 
-struct ObjectData {
-    mat4 model;
-    vec4 albedo;
-};
-
-layout(std430, binding = 1) readonly buffer ObjectBuffer {
-    ObjectData objects[];
-};
-
-layout(push_constant) uniform ObjectPC {
-    uint objectIndex;
-} pc;
-
 layout(binding = 2) uniform sampler2D uTexture;
 
 void main() {
-    ObjectData obj = objects[pc.objectIndex];
-
     vec4 texColor = texture(uTexture, fragUV);
-    vec4 base = texColor * vec4(fragColor, 1.0) * obj.albedo;
+    vec4 base = texColor * vec4(fragColor, 1.0) * fragAlbedo;
 
     vec3 N = normalize(fragNormal);
     vec3 L = normalize(-frame.lightDir.xyz); // lightDir points FROM light
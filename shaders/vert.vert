@@ -5,20 +5,39 @@ layout(binding = 0) uniform FrameUBO {
     mat4 proj;
     vec4 globalAlbedo;
     vec4 lightDir;
+    vec4 frustumPlanes[6];
 } frame;
 
+// Matches ObjectDataGPU (64 bytes)
 struct ObjectData {
-    mat4 model;
+    vec4 modelRows[3]; // affine world matrix rows
+    uint normal[3];    // normal matrix columns, snorm 10:10:10 (unless uniform scale)
+    uint material;     // material index | UNIFORM_SCALE_BIT
+};
+
+const uint UNIFORM_SCALE_BIT = 0x80000000u;
+
+struct MaterialData {
     vec4 albedo;
 };
 
-layout(std430, binding = 1) readonly buffer ObjectBuffer {
+// Per-frame: instance slot -> object id (DrawBatcher order)
+layout(std430, binding = 1) readonly buffer InstanceBuffer {
+    uint instanceObjects[];
+};
+
+// Persistent, indexed by object id; only changed records are uploaded
+layout(std430, binding = 3) readonly buffer ObjectBuffer {
     ObjectData objects[];
 };
 
-layout(push_constant) uniform ObjectPC {
-    uint objectIndex;
-} pc;
+layout(std430, binding = 4) readonly buffer MaterialBuffer {
+    MaterialData materials[];
+};
+
+// Set per VertexFormat pipeline: packed formats store the normal octahedral-encoded in
+// snorm16 x2 (.z reads 0); positions, colors and UVs are widened by the input formats
+layout(constant_id = 0) const bool OCT_NORMALS = false;
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
@@ -30,20 +49,46 @@ layout(location = 1) out vec2 fragUV;
 layout(location = 2) out vec4 fragAlbedo;
 layout(location = 3) out vec3 fragNormal; // world-space
 
+vec3 unpack_snorm10(uint v) {
+    ivec3 q = ivec3(bitfieldExtract(int(v), 0, 10),
+                    bitfieldExtract(int(v), 10, 10),
+                    bitfieldExtract(int(v), 20, 10));
+    return vec3(q) / 511.0;
+}
+
+vec3 decode_octahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return n; // normalized after the normal matrix
+}
+
 void main() {
-    ObjectData obj = objects[pc.objectIndex];
+    // Instance slot is the draw's firstInstance + instance
+    ObjectData obj = objects[instanceObjects[gl_InstanceIndex]];
+
+    vec4 p = vec4(inPosition, 1.0);
+    vec3 worldPos = vec3(dot(obj.modelRows[0], p), dot(obj.modelRows[1], p), dot(obj.modelRows[2], p));
 
-    mat4 model = obj.model;
+    gl_Position = frame.proj * frame.view * vec4(worldPos, 1.0);
 
-    gl_Position = frame.proj * frame.view * model * vec4(inPosition, 1.0);
+    vec3 localNormal = OCT_NORMALS ? decode_octahedral(inNormal.xy) : inNormal;
 
-    // Transform normal to world space
-    // If you want performance:
-    // Precompute normal matrix CPU-side and store it in ObjectDataGPU
-    mat3 normalMat = transpose(inverse(mat3(model)));
-    fragNormal = normalize(normalMat * inNormal);
+    // The normal matrix is precomputed on the CPU; with uniform scale it is the model's
+    // 3x3 part, and normalize() removes the scale either way
+    vec3 n;
+    if ((obj.material & UNIFORM_SCALE_BIT) != 0u) {
+        n = vec3(dot(obj.modelRows[0].xyz, localNormal),
+                 dot(obj.modelRows[1].xyz, localNormal),
+                 dot(obj.modelRows[2].xyz, localNormal));
+    } else {
+        n = mat3(unpack_snorm10(obj.normal[0]),
+                 unpack_snorm10(obj.normal[1]),
+                 unpack_snorm10(obj.normal[2])) * localNormal;
+    }
+    fragNormal = normalize(n);
 
     fragColor  = inColor;
     fragUV     = inUV;
-    fragAlbedo = obj.albedo;
+    fragAlbedo = materials[obj.material & ~UNIFORM_SCALE_BIT].albedo;
 }
@@ -0,0 +1,300 @@
+// src/bench/bench-main.cpp
+//
+// Headless frame-loop benchmark. Renders a fixed number of warm-up and measured frames
+// for each requested scene size and writes CPU/GPU frame time percentiles as JSON.
+//
+//   ankh_bench [--sizes=1,64,1024,4096] [--warmup=60] [--frames=300]
+//              [--out=ankh_bench.json | --out=-] [shared options]
+//
+// Shared options (--model=, --validation, --no-indirect, ...) are listed with
+// apply_config_arg in utils/config.hpp. Validation is off unless --validation is given.
+// Run from the directory holding shaders/ (same as Ankh).
+
+#include "profiling/gpu-profiler.hpp"
+#include "renderer/renderer.hpp"
+#include "utils/config.hpp"
+#include "utils/logging.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    struct BenchOptions
+    {
+        std::vector<uint32_t> sizes{1, 64, 1024, 4096};
+        uint32_t warmupFrames = 60;
+        uint32_t measuredFrames = 300;
+        std::string outPath = "ankh_bench.json";
+    };
+
+    std::vector<uint32_t> parse_sizes(std::string_view list)
+    {
+        std::vector<uint32_t> sizes;
+
+        while (!list.empty())
+        {
+            const size_t comma = list.find(',');
+            const std::string item{list.substr(0, comma)};
+
+            if (!item.empty())
+            {
+                sizes.push_back(static_cast<uint32_t>(std::stoul(item)));
+            }
+
+            if (comma == std::string_view::npos)
+            {
+                break;
+            }
+
+            list.remove_prefix(comma + 1);
+        }
+
+        return sizes;
+    }
+
+    BenchOptions parse_args(int argc, char **argv)
+    {
+        BenchOptions opts{};
+
+        const auto value_of = [](std::string_view arg, std::string_view key)
+        { return std::string{arg.substr(key.size())}; };
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg{argv[i]};
+
+            if (arg.starts_with("--sizes="))
+            {
+                opts.sizes = parse_sizes(value_of(arg, "--sizes="));
+            }
+            else if (arg.starts_with("--warmup="))
+            {
+                opts.warmupFrames = static_cast<uint32_t>(std::stoul(value_of(arg, "--warmup=")));
+            }
+            else if (arg.starts_with("--frames="))
+            {
+                opts.measuredFrames =
+                    static_cast<uint32_t>(std::stoul(value_of(arg, "--frames=")));
+            }
+            else if (arg.starts_with("--out="))
+            {
+                opts.outPath = value_of(arg, "--out=");
+            }
+            else if (!ankh::apply_config_arg(arg)) // shared options, see utils/config.hpp
+            {
+                ANKH_LOG_WARN("[Bench] Ignoring unknown argument: " + std::string(arg));
+            }
+        }
+
+        if (opts.sizes.empty())
+        {
+            ANKH_THROW_MSG("--sizes must list at least one object count");
+        }
+
+        if (opts.measuredFrames == 0)
+        {
+            ANKH_THROW_MSG("--frames must be greater than zero");
+        }
+
+        return opts;
+    }
+
+    // Nearest-rank percentile over an ascending-sorted sample set
+    double percentile(const std::vector<double> &sorted, double p)
+    {
+        const double rank = std::ceil(p / 100.0 * static_cast<double>(sorted.size()));
+        const size_t index = static_cast<size_t>(std::max(rank, 1.0)) - 1;
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    nlohmann::json summarize(std::vector<double> samples)
+    {
+        if (samples.empty())
+        {
+            return nullptr;
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        const double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
+
+        return {
+            {"samples", samples.size()},
+            {"mean", sum / static_cast<double>(samples.size())},
+            {"min", samples.front()},
+            {"p50", percentile(samples, 50.0)},
+            {"p95", percentile(samples, 95.0)},
+            {"p99", percentile(samples, 99.0)},
+            {"max", samples.back()},
+        };
+    }
+
+    nlohmann::json run_size(ankh::Renderer &renderer, const BenchOptions &opts, uint32_t objects)
+    {
+        renderer.set_object_count(objects);
+
+        for (uint32_t i = 0; i < opts.warmupFrames; ++i)
+        {
+            renderer.draw_frame();
+        }
+
+        // Drain warm-up frames so their GPU times do not leak into the measured window
+        renderer.finish_frames();
+        renderer.gpu_profiler().clear_history();
+        renderer.gpu_profiler().reset_averages();
+
+        std::vector<double> cpuMs;
+        cpuMs.reserve(opts.measuredFrames);
+        std::vector<double> fenceWaitMs;
+        fenceWaitMs.reserve(opts.measuredFrames);
+
+        std::vector<double> packetsRebuilt;
+        packetsRebuilt.reserve(opts.measuredFrames);
+
+        std::vector<double> changed;
+        changed.reserve(opts.measuredFrames);
+        std::vector<double> uploaded;
+        uploaded.reserve(opts.measuredFrames);
+
+        for (uint32_t i = 0; i < opts.measuredFrames; ++i)
+        {
+            renderer.draw_frame();
+
+            // Frame CPU work and fence wait are separate series: the wait is the GPU (or
+            // frames-in-flight limit) holding the CPU back, not CPU cost
+            cpuMs.push_back(renderer.last_cpu_frame_ms());
+            fenceWaitMs.push_back(renderer.last_fence_wait_ms());
+            packetsRebuilt.push_back(static_cast<double>(renderer.draw_packets_rebuilt()));
+            changed.push_back(static_cast<double>(renderer.changed_object_count()));
+            uploaded.push_back(static_cast<double>(renderer.uploaded_object_count()));
+        }
+
+        renderer.finish_frames();
+
+        nlohmann::json passes = nlohmann::json::object();
+        for (const auto &scope : renderer.gpu_profiler().scope_timings())
+        {
+            if (scope.samples != 0)
+            {
+                passes[scope.name] = scope.avgMs;
+            }
+        }
+
+        ANKH_LOG_INFO("[Bench] " + std::to_string(objects) + " objects done");
+
+        const uint32_t visible = renderer.visible_object_count();
+        const uint32_t batches = renderer.draw_batch_count();
+
+        return {
+            {"objects", objects},
+            {"visible", visible},
+            {"batches", batches},
+            {"cpu_ms", summarize(std::move(cpuMs))},
+            {"fence_wait_ms", summarize(std::move(fenceWaitMs))},
+            {"gpu_ms", summarize(renderer.gpu_profiler().frame_history())},
+            {"packets_rebuilt", summarize(std::move(packetsRebuilt))},
+            {"changed_objects", summarize(std::move(changed))},
+            {"uploaded_objects", summarize(std::move(uploaded))},
+            {"gpu_pass_avg_ms", std::move(passes)},
+        };
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        ankh::log::init();
+
+        // Validation skews timings; off unless --validation asks for it
+        ankh::config().validation = false;
+
+        const BenchOptions opts = parse_args(argc, argv);
+
+        // Info and warning lines go to stdout; with --out=- it carries the report alone
+        if (opts.outPath == "-")
+        {
+            ankh::log::SetLevel(ankh::log::Level::Error);
+        }
+
+        auto &cfg = ankh::config();
+        cfg.headless = true;
+        cfg.maxObjects =
+            std::max(cfg.maxObjects, *std::max_element(opts.sizes.begin(), opts.sizes.end()));
+
+        ankh::Renderer renderer;
+        renderer.gpu_profiler().set_history_enabled(true);
+
+        nlohmann::json report{
+            {"device", renderer.device_name()},
+#ifndef NDEBUG
+            {"build", "Debug"},
+#else
+            {"build", "Release"},
+#endif
+            {"validation", cfg.validation},
+            {"extent", {cfg.Width, cfg.Height}},
+            {"framesInFlight", cfg.framesInFlight},
+            {"model", cfg.modelPath},
+            {"indirectDraw", renderer.indirect_draw()},
+            {"gpuCulling", renderer.gpu_culling()},
+            {"cpuCulling", cfg.cpuCulling},
+            {"animate", cfg.animate},
+            {"optimizeMeshes", cfg.optimizeMeshes},
+            {"compactVertices", cfg.compactVertices},
+            {"vertexBytes", renderer.vertex_buffer_bytes()},
+            {"indexBytes", renderer.index_buffer_bytes()},
+            {"meshlets", cfg.meshlets},
+            {"maxClusterDraws", cfg.maxClusterDraws},
+            {"lodLevels", cfg.lodLevels},
+            {"lodPixelError", cfg.lodPixelError},
+            {"jobThreads", renderer.job_threads()},
+            {"recordThreads", renderer.record_threads()},
+            {"warmupFrames", opts.warmupFrames},
+            {"measuredFrames", opts.measuredFrames},
+            {"gpuTimestamps", renderer.gpu_profiler().supported()},
+        };
+
+        nlohmann::json runs = nlohmann::json::array();
+
+        for (uint32_t objects : opts.sizes)
+        {
+            runs.push_back(run_size(renderer, opts, objects));
+        }
+
+        report["runs"] = std::move(runs);
+
+        if (opts.outPath == "-")
+        {
+            std::cout << report.dump(2) << std::endl;
+        }
+        else
+        {
+            std::ofstream out(opts.outPath);
+            if (!out)
+            {
+                ANKH_THROW_MSG("Failed to open benchmark output: " + opts.outPath);
+            }
+
+            out << report.dump(2) << '\n';
+            std::cerr << "ankh_bench: wrote " << opts.outPath << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
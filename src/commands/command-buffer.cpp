@@ -7,13 +7,13 @@
 namespace ankh
 {
 
-    CommandBuffer::CommandBuffer(VkDevice device, VkCommandPool pool)
+    CommandBuffer::CommandBuffer(VkDevice device, VkCommandPool pool, VkCommandBufferLevel level)
         : m_device(device)
         , m_pool(pool)
     {
         VkCommandBufferAllocateInfo ai{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
         ai.commandPool = m_pool;
-        ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        ai.level = level;
         ai.commandBufferCount = 1;
 
         ANKH_VK_CHECK(vkAllocateCommandBuffers(m_device, &ai, &m_buffer));
@@ -54,10 +54,12 @@ namespace ankh
         return *this;
     }
 
-    void CommandBuffer::begin(VkCommandBufferUsageFlags flags)
+    void CommandBuffer::begin(VkCommandBufferUsageFlags flags,
+                              const VkCommandBufferInheritanceInfo *inheritance)
     {
         VkCommandBufferBeginInfo bi{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
         bi.flags = flags;
+        bi.pInheritanceInfo = inheritance;
 
         ANKH_VK_CHECK(vkBeginCommandBuffer(m_buffer, &bi));
     }
@@ -8,7 +8,9 @@ namespace ankh
     class CommandBuffer
     {
     public:
-        CommandBuffer(VkDevice device, VkCommandPool pool);
+        CommandBuffer(VkDevice device,
+                      VkCommandPool pool,
+                      VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
         ~CommandBuffer();
 
         CommandBuffer(const CommandBuffer &) = delete;
@@ -20,9 +22,11 @@ namespace ankh
         VkCommandBuffer handle() const { return m_buffer; }
 
         /**
-         * Internally uses VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT by default
+         * Internally uses VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT by default.
+         * 'inheritance' is required for secondary command buffers.
          */
-        void begin(VkCommandBufferUsageFlags flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        void begin(VkCommandBufferUsageFlags flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                   const VkCommandBufferInheritanceInfo *inheritance = nullptr);
         void end();
         void reset(VkCommandBufferResetFlags flags = 0);
 
@@ -29,6 +29,11 @@ namespace ankh
         }
     }
 
+    void CommandPool::reset(VkCommandPoolResetFlags flags)
+    {
+        ANKH_VK_CHECK(vkResetCommandPool(m_device, m_pool, flags));
+    }
+
     CommandPool::CommandPool(CommandPool &&other) noexcept
         : m_device(other.m_device)
         , m_pool(other.m_pool)
@@ -20,6 +20,9 @@ namespace ankh
         VkCommandPool handle() const { return m_pool; }
         VkDevice device() const { return m_device; }
 
+        // Recycle every command buffer allocated from this pool at once
+        void reset(VkCommandPoolResetFlags flags = 0);
+
       private:
         VkDevice m_device{VK_NULL_HANDLE};
         VkCommandPool m_pool{VK_NULL_HANDLE};
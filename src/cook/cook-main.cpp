@@ -0,0 +1,377 @@
+// src/cook/cook-main.cpp
+//
+// Offline asset cooker. Converts glTF files into engine-native packages (.ankhpkg, see
+// scene/cooked-package.hpp): imported, optimized, simplified and split into meshlets
+// once here instead of at every application start. Inputs are cooked in parallel; an
+// input whose content hash (the glTF, its external buffers and images, the cook options
+// and the cooker version) matches the existing package is skipped.
+//
+//   ankh_cook [--out-dir=DIR] [--force] [shared options] input.gltf|input.glb...
+//
+// Of the shared options (apply_config_arg in utils/config.hpp), --job-threads=N,
+// --lod-levels=N, --no-mesh-opt, --no-vertex-compression and --no-meshlets apply.
+//
+// Packages are written next to their input unless --out-dir is given; inputs that would
+// write the same package are rejected up front. Exits non-zero if any input failed.
+
+#include "cook/package-writer.hpp"
+#include "jobs/job-system.hpp"
+#include "scene/model-loader.hpp"
+#include "utils/config.hpp"
+#include "utils/file-io.hpp"
+#include "utils/logging.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    struct CookOptions
+    {
+        std::vector<std::string> inputs;
+        std::string outDir; // empty: next to each input
+        bool force = false;
+    };
+
+    enum class CookResult
+    {
+        Cooked,
+        UpToDate,
+        Failed,
+    };
+
+    CookOptions parse_args(int argc, char **argv)
+    {
+        CookOptions opts{};
+
+        const auto value_of = [](std::string_view arg, std::string_view key)
+        { return std::string{arg.substr(key.size())}; };
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg{argv[i]};
+
+            if (arg.starts_with("--out-dir="))
+            {
+                opts.outDir = value_of(arg, "--out-dir=");
+            }
+            else if (arg == "--force")
+            {
+                opts.force = true;
+            }
+            else if (arg.starts_with("--"))
+            {
+                if (!ankh::apply_config_arg(arg))
+                {
+                    ANKH_LOG_WARN("[Cook] Ignoring unknown argument: " + std::string(arg));
+                }
+            }
+            else
+            {
+                opts.inputs.emplace_back(arg);
+            }
+        }
+
+        if (opts.inputs.empty())
+        {
+            ANKH_THROW_MSG("usage: ankh_cook [options] input.gltf|input.glb...");
+        }
+
+        return opts;
+    }
+
+    // Part of every source hash. Bump it whenever import or processing (optimization,
+    // simplification, meshlets, encoding) changes what the same inputs and options cook
+    // to, so existing packages are rebuilt instead of reported up to date.
+    constexpr uint32_t kCookerVersion = 2;
+
+    // 64-bit FNV-1a
+    constexpr uint64_t kHashSeed = 0xcbf29ce484222325ull;
+
+    uint64_t hash_bytes(uint64_t hash, const void *data, std::size_t size)
+    {
+        const auto *bytes = static_cast<const unsigned char *>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    uint64_t hash_string(uint64_t hash, std::string_view s)
+    {
+        // Length first, so consecutive strings can't run into each other
+        const uint64_t length = s.size();
+        hash = hash_bytes(hash, &length, sizeof(length));
+        return hash_bytes(hash, s.data(), s.size());
+    }
+
+    // glTF URIs are percent-encoded relative paths
+    std::string decode_uri(std::string_view uri)
+    {
+        std::string path;
+        path.reserve(uri.size());
+
+        const auto hex = [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; };
+
+        for (std::size_t i = 0; i < uri.size(); ++i)
+        {
+            if (uri[i] == '%' && i + 2 < uri.size() && hex(uri[i + 1]) && hex(uri[i + 2]))
+            {
+                const std::string code{uri.substr(i + 1, 2)};
+                path.push_back(static_cast<char>(std::stoi(code, nullptr, 16)));
+                i += 2;
+            }
+            else
+            {
+                path.push_back(uri[i]);
+            }
+        }
+
+        return path;
+    }
+
+    // Files a glTF references outside itself: buffers and images that are not data URIs
+    std::vector<std::string> external_uris(const std::vector<char> &file)
+    {
+        std::string_view json{file.data(), file.size()};
+
+        // .glb: 12-byte header, then the JSON chunk (length, type, data)
+        if (file.size() >= 20 && std::memcmp(file.data(), "glTF", 4) == 0)
+        {
+            uint32_t length = 0;
+            std::memcpy(&length, file.data() + 12, sizeof(length));
+            json = std::string_view{file.data() + 20,
+                                    std::min<std::size_t>(length, file.size() - 20)};
+        }
+
+        const nlohmann::json doc = nlohmann::json::parse(json, nullptr, false);
+        if (doc.is_discarded())
+        {
+            return {}; // reported by the import
+        }
+
+        std::vector<std::string> uris;
+        for (const char *key : {"buffers", "images"})
+        {
+            const auto it = doc.find(key);
+            if (it == doc.end() || !it->is_array())
+            {
+                continue;
+            }
+
+            for (const auto &entry : *it)
+            {
+                const auto uri = entry.find("uri");
+                if (uri != entry.end() && uri->is_string() &&
+                    !uri->get_ref<const std::string &>().starts_with("data:"))
+                {
+                    uris.push_back(decode_uri(uri->get_ref<const std::string &>()));
+                }
+            }
+        }
+
+        return uris;
+    }
+
+    // Everything a package is derived from: the glTF, the files it references, the
+    // options the cooker applies and the cooker itself
+    uint64_t source_hash(const fs::path &input, const ankh::PackageHeader &options)
+    {
+        uint64_t hash = kHashSeed;
+        hash = hash_bytes(hash, &kCookerVersion, sizeof(kCookerVersion));
+        hash = hash_bytes(hash, &options.version, sizeof(options.version));
+        hash = hash_bytes(hash, &options.flags, sizeof(options.flags));
+        hash = hash_bytes(hash, &options.lodLevels, sizeof(options.lodLevels));
+
+        const std::vector<char> file = ankh::read_binary(input.string());
+        hash = hash_bytes(hash, file.data(), file.size());
+
+        for (const std::string &uri : external_uris(file))
+        {
+            hash = hash_string(hash, uri);
+
+            const fs::path dependency = input.parent_path() / fs::path(uri);
+            std::error_code ec;
+            if (fs::is_regular_file(dependency, ec))
+            {
+                const std::vector<char> bytes = ankh::read_binary(dependency.string());
+                hash = hash_bytes(hash, bytes.data(), bytes.size());
+            }
+        }
+
+        return hash;
+    }
+
+    fs::path output_path(const fs::path &input, const CookOptions &opts)
+    {
+        const fs::path outDir = opts.outDir.empty() ? input.parent_path() : fs::path(opts.outDir);
+        return outDir / (input.stem().string() + ankh::PACKAGE_EXTENSION);
+    }
+
+    // Inputs are cooked concurrently, so two that map to one package (same stem under
+    // --out-dir, or an input given twice) would race on the file. Refuse before cooking.
+    void check_unique_outputs(const CookOptions &opts)
+    {
+        std::map<fs::path, const std::string *> owners;
+        for (const std::string &input : opts.inputs)
+        {
+            const fs::path output = fs::absolute(output_path(input, opts)).lexically_normal();
+            const auto [it, inserted] = owners.emplace(output, &input);
+            if (!inserted)
+            {
+                ANKH_THROW_MSG("ankh_cook: " + *it->second + " and " + input +
+                               " would both be cooked to " + output.string());
+            }
+        }
+    }
+
+    CookResult cook(const fs::path &input,
+                    const CookOptions &opts,
+                    const ankh::PackageHeader &options,
+                    ankh::JobSystem &jobs)
+    {
+        const fs::path output = output_path(input, opts);
+        const fs::path outDir = output.parent_path();
+
+        ankh::PackageHeader header = options;
+        header.sourceHash = source_hash(input, options);
+
+        ankh::PackageHeader existing{};
+        if (!opts.force && ankh::read_package_header(output.string(), existing) &&
+            existing.sourceHash == header.sourceHash)
+        {
+            ANKH_LOG_INFO("[Cook] " + output.string() + " is up to date");
+            return CookResult::UpToDate;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        ankh::MeshPool meshes;
+        ankh::MaterialPool materials;
+        const ankh::Model model =
+            ankh::ModelLoader::load_gltf(input.string(), meshes, materials, &jobs);
+
+        if (model.nodes().empty())
+        {
+            ANKH_THROW_MSG("no nodes imported from " + input.string());
+        }
+
+        // Same processing the renderer applies at load time
+        const uint32_t lodLevels = options.lodLevels;
+        const bool meshlets = (options.flags & ankh::PACKAGE_MESHLETS_BIT) != 0;
+        const std::vector<ankh::MeshHandle> handles = meshes.handles();
+
+        jobs.parallel_for(0,
+                          static_cast<uint32_t>(handles.size()),
+                          1,
+                          [&](uint32_t first, uint32_t last)
+                          {
+                              for (uint32_t i = first; i < last; ++i)
+                              {
+                                  ankh::Mesh &mesh = meshes.get(handles[i]);
+                                  if (lodLevels != 0)
+                                  {
+                                      mesh.build_lods(lodLevels);
+                                  }
+                                  if (meshlets)
+                                  {
+                                      mesh.build_meshlets(ankh::MESHLET_MIN_MESH_TRIANGLES);
+                                  }
+                              }
+                          });
+
+        if (!outDir.empty()) // empty: an input in the working directory
+        {
+            fs::create_directories(outDir);
+        }
+        ankh::write_package(output.string(), header, model, meshes, materials, jobs);
+
+        const double ms = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+
+        ANKH_LOG_INFO("[Cook] " + input.string() + " -> " + output.string() + " (" +
+                      std::to_string(handles.size()) + " meshes, " +
+                      std::to_string(fs::file_size(output)) + " bytes, " +
+                      std::to_string(static_cast<uint64_t>(ms)) + " ms)");
+        return CookResult::Cooked;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        ankh::log::init();
+
+        const CookOptions opts = parse_args(argc, argv);
+        check_unique_outputs(opts);
+        const auto &cfg = ankh::config();
+
+        ankh::PackageHeader options{};
+        options.flags = (cfg.optimizeMeshes ? ankh::PACKAGE_OPTIMIZED_BIT : 0u) |
+                        (cfg.compactVertices ? ankh::PACKAGE_COMPACT_VERTICES_BIT : 0u) |
+                        (cfg.meshlets ? ankh::PACKAGE_MESHLETS_BIT : 0u);
+        options.lodLevels = std::min(cfg.lodLevels, ankh::MAX_MESH_LODS - 1);
+
+        ankh::JobSystem jobs(cfg.jobThreads);
+
+        // One input per job; each one spreads its own import and encoding over the
+        // same pool
+        std::vector<CookResult> results(opts.inputs.size(), CookResult::Failed);
+
+        jobs.parallel_for(0,
+                          static_cast<uint32_t>(opts.inputs.size()),
+                          1,
+                          [&](uint32_t first, uint32_t last)
+                          {
+                              for (uint32_t i = first; i < last; ++i)
+                              {
+                                  try
+                                  {
+                                      results[i] = cook(opts.inputs[i], opts, options, jobs);
+                                  }
+                                  catch (const std::exception &e)
+                                  {
+                                      ANKH_LOG_ERROR("[Cook] " + opts.inputs[i] +
+                                                     " failed: " + e.what());
+                                  }
+                              }
+                          });
+
+        uint32_t counts[3] = {};
+        for (CookResult result : results)
+        {
+            ++counts[static_cast<uint32_t>(result)];
+        }
+
+        std::cerr << "ankh_cook: " << counts[0] << " cooked, " << counts[1] << " up to date, "
+                  << counts[2] << " failed" << std::endl;
+
+        if (counts[static_cast<uint32_t>(CookResult::Failed)] != 0)
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,345 @@
+// src/cook/package-writer.cpp
+#include "cook/package-writer.hpp"
+
+#include "jobs/job-system.hpp"
+#include "utils/logging.hpp"
+#include "utils/vertex-format.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace ankh
+{
+    namespace
+    {
+        // Lays out tables and blobs back to back, each aligned to PACKAGE_ALIGNMENT
+        class PackageLayout
+        {
+          public:
+            PackageRange reserve(uint64_t size)
+            {
+                PackageRange range{m_end, size};
+                m_end = (m_end + size + PACKAGE_ALIGNMENT - 1) & ~(PACKAGE_ALIGNMENT - 1);
+                return range;
+            }
+
+            template <typename T>
+            PackageRange reserve_table(std::size_t count)
+            {
+                return reserve(sizeof(T) * count);
+            }
+
+            uint64_t size() const
+            {
+                return m_end;
+            }
+
+          private:
+            uint64_t m_end{(sizeof(PackageHeader) + PACKAGE_ALIGNMENT - 1) &
+                           ~(PACKAGE_ALIGNMENT - 1)};
+        };
+
+        template <typename T>
+        void write_table(std::vector<uint8_t> &file,
+                         const PackageRange &range,
+                         const std::vector<T> &table)
+        {
+            if (!table.empty())
+            {
+                std::memcpy(file.data() + range.offset, table.data(), range.size);
+            }
+        }
+
+        void write_indices(const std::vector<uint32_t> &indices, IndexWidth width, uint8_t *dst)
+        {
+            if (width == IndexWidth::U32)
+            {
+                std::memcpy(dst, indices.data(), sizeof(uint32_t) * indices.size());
+                return;
+            }
+
+            auto *out = reinterpret_cast<uint16_t *>(dst);
+            for (std::size_t i = 0; i < indices.size(); ++i)
+            {
+                out[i] = static_cast<uint16_t>(indices[i]);
+            }
+        }
+
+        // RGB(A)8 to tightly packed RGBA8
+        void write_rgba8(const CpuImage &image, uint8_t *dst)
+        {
+            const std::size_t texels = static_cast<std::size_t>(image.width) * image.height;
+            const std::span<const uint8_t> src = image.bytes();
+
+            if (image.components == 4)
+            {
+                std::memcpy(dst, src.data(), 4 * texels);
+                return;
+            }
+
+            for (std::size_t i = 0; i < texels; ++i)
+            {
+                dst[4 * i + 0] = src[3 * i + 0];
+                dst[4 * i + 1] = src[3 * i + 1];
+                dst[4 * i + 2] = src[3 * i + 2];
+                dst[4 * i + 3] = 255;
+            }
+        }
+
+        bool convertible(const CpuImage &image)
+        {
+            const std::size_t texels = static_cast<std::size_t>(std::max(image.width, 0)) *
+                                       static_cast<std::size_t>(std::max(image.height, 0));
+
+            return texels != 0 && (image.components == 3 || image.components == 4) &&
+                   image.bytes().size() >= texels * static_cast<std::size_t>(image.components);
+        }
+    } // namespace
+
+    void write_package(const std::string &path,
+                       PackageHeader header,
+                       const Model &model,
+                       const MeshPool &mesh_pool,
+                       const MaterialPool &material_pool,
+                       JobSystem &jobs)
+    {
+        const bool compact = (header.flags & PACKAGE_COMPACT_VERTICES_BIT) != 0;
+
+        // --- Tables, with handles renumbered densely ---
+        const std::vector<MeshHandle> meshHandles = mesh_pool.handles();
+
+        std::vector<uint32_t> meshIndex;
+        std::vector<PackageMesh> meshes(meshHandles.size());
+        std::vector<PackageLod> lods;
+        std::vector<Meshlet> clusters;
+
+        for (uint32_t i = 0; i < meshHandles.size(); ++i)
+        {
+            const MeshHandle h = meshHandles[i];
+            const Mesh &mesh = mesh_pool.get(h);
+
+            if (h >= meshIndex.size())
+            {
+                meshIndex.resize(static_cast<std::size_t>(h) + 1, PACKAGE_NONE);
+            }
+            meshIndex[h] = i;
+
+            PackageMesh &pm = meshes[i];
+            pm.vertexCount = static_cast<uint32_t>(mesh.vertex_count());
+            pm.vertexFormat = static_cast<uint8_t>(compact ? mesh.vertex_format()
+                                                           : VertexFormat::Float);
+            pm.indexWidth = static_cast<uint8_t>(mesh.index_width());
+            pm.boundsValid = mesh.bounds().valid ? 1 : 0;
+            pm.boundsMin = mesh.bounds().min;
+            pm.boundsMax = mesh.bounds().max;
+            pm.sphere = mesh.bounds().sphere;
+
+            pm.firstLod = static_cast<uint32_t>(lods.size());
+            pm.lodCount = static_cast<uint8_t>(1 + mesh.lods().size());
+            lods.push_back(PackageLod{{}, static_cast<uint32_t>(mesh.index_count()), 0.0f});
+            for (const MeshLod &lod : mesh.lods())
+            {
+                const uint32_t count = static_cast<uint32_t>(lod.indices.size());
+                lods.push_back(PackageLod{{}, count, lod.error});
+            }
+
+            pm.firstCluster = static_cast<uint32_t>(clusters.size());
+            pm.clusterCount = static_cast<uint32_t>(mesh.meshlets().size());
+            clusters.insert(clusters.end(), mesh.meshlets().begin(), mesh.meshlets().end());
+        }
+
+        std::vector<uint32_t> materialIndex(material_pool.size(), PACKAGE_NONE);
+        std::vector<PackageMaterial> materials;
+        std::vector<PackageImage> images;
+        std::vector<const CpuImage *> imageSources;
+        std::unordered_map<const CpuImage *, uint32_t> imageIndex; // shared images stored once
+
+        for (MaterialHandle h = 1; h < material_pool.size(); ++h)
+        {
+            if (!material_pool.valid(h))
+            {
+                continue;
+            }
+
+            const Material &mat = material_pool.get(h);
+            materialIndex[h] = static_cast<uint32_t>(materials.size());
+
+            PackageMaterial pm{};
+            pm.albedo = mat.albedo();
+
+            if (mat.has_base_color_image())
+            {
+                const CpuImage &image = *mat.base_color_image();
+                if (const auto it = imageIndex.find(&image); it != imageIndex.end())
+                {
+                    pm.image = it->second;
+                }
+                else if (convertible(image))
+                {
+                    imageIndex.emplace(&image, static_cast<uint32_t>(images.size()));
+                    pm.image = static_cast<uint32_t>(images.size());
+                    images.push_back(PackageImage{{},
+                                                  static_cast<uint32_t>(image.width),
+                                                  static_cast<uint32_t>(image.height)});
+                    imageSources.push_back(&image);
+                }
+                else
+                {
+                    ANKH_LOG_WARN("[Cook] Base color image is not 8-bit RGB/RGBA; "
+                                  "material cooked without it");
+                }
+            }
+
+            materials.push_back(pm);
+        }
+
+        std::vector<PackageNode> nodes;
+        nodes.reserve(model.nodes().size());
+        for (const ModelNode &node : model.nodes())
+        {
+            PackageNode pn{};
+            pn.localTransform = node.local_transform;
+            pn.parent = node.parent;
+            if (node.mesh < meshIndex.size())
+            {
+                pn.mesh = meshIndex[node.mesh];
+            }
+            if (node.material < materialIndex.size())
+            {
+                pn.material = materialIndex[node.material];
+            }
+            nodes.push_back(pn);
+        }
+
+        // --- Layout: header, tables, then blobs ---
+        PackageLayout layout;
+        header.magic = PACKAGE_MAGIC;
+        header.version = PACKAGE_VERSION;
+        header.nodes = layout.reserve_table<PackageNode>(nodes.size());
+        header.meshes = layout.reserve_table<PackageMesh>(meshes.size());
+        header.lods = layout.reserve_table<PackageLod>(lods.size());
+        header.clusters = layout.reserve_table<Meshlet>(clusters.size());
+        header.materials = layout.reserve_table<PackageMaterial>(materials.size());
+        header.images = layout.reserve_table<PackageImage>(images.size());
+
+        for (PackageMesh &pm : meshes)
+        {
+            const VertexFormat format = static_cast<VertexFormat>(pm.vertexFormat);
+            const uint32_t indexSize = index_size(static_cast<IndexWidth>(pm.indexWidth));
+
+            pm.vertices = layout.reserve(uint64_t{vertex_stride(format)} * pm.vertexCount);
+            for (uint32_t l = 0; l < pm.lodCount; ++l)
+            {
+                PackageLod &lod = lods[pm.firstLod + l];
+                lod.indices = layout.reserve(uint64_t{indexSize} * lod.indexCount);
+            }
+        }
+
+        for (PackageImage &image : images)
+        {
+            image.pixels = layout.reserve(uint64_t{4} * image.width * image.height);
+        }
+
+        // --- Contents ---
+        std::vector<uint8_t> file(static_cast<std::size_t>(layout.size()), 0);
+
+        std::memcpy(file.data(), &header, sizeof(header));
+        write_table(file, header.nodes, nodes);
+        write_table(file, header.meshes, meshes);
+        write_table(file, header.lods, lods);
+        write_table(file, header.clusters, clusters);
+        write_table(file, header.materials, materials);
+        write_table(file, header.images, images);
+
+        jobs.parallel_for(0,
+                          static_cast<uint32_t>(meshes.size()),
+                          1,
+                          [&](uint32_t first, uint32_t last)
+                          {
+                              for (uint32_t i = first; i < last; ++i)
+                              {
+                                  const Mesh &mesh = mesh_pool.get(meshHandles[i]);
+                                  const PackageMesh &pm = meshes[i];
+                                  const IndexWidth width = static_cast<IndexWidth>(pm.indexWidth);
+
+                                  encode_vertices(static_cast<VertexFormat>(pm.vertexFormat),
+                                                  mesh.vertices().data(),
+                                                  mesh.vertex_count(),
+                                                  file.data() + pm.vertices.offset);
+
+                                  write_indices(mesh.indices(),
+                                                width,
+                                                file.data() + lods[pm.firstLod].indices.offset);
+                                  for (uint32_t l = 1; l < pm.lodCount; ++l)
+                                  {
+                                      write_indices(mesh.lods()[l - 1].indices,
+                                                    width,
+                                                    file.data() +
+                                                        lods[pm.firstLod + l].indices.offset);
+                                  }
+                              }
+                          });
+
+        jobs.parallel_for(0,
+                          static_cast<uint32_t>(images.size()),
+                          1,
+                          [&](uint32_t first, uint32_t last)
+                          {
+                              for (uint32_t i = first; i < last; ++i)
+                              {
+                                  write_rgba8(*imageSources[i],
+                                              file.data() + images[i].pixels.offset);
+                              }
+                          });
+
+        // --- Write and replace ---
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                ANKH_THROW_MSG("Failed to open package for writing: " + temporary);
+            }
+
+            out.write(reinterpret_cast<const char *>(file.data()),
+                      static_cast<std::streamsize>(file.size()));
+            if (!out)
+            {
+                ANKH_THROW_MSG("Failed to write package: " + temporary);
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temporary, path, ec);
+        if (ec)
+        {
+            const std::string reason = ec.message();
+            std::filesystem::remove(temporary, ec);
+            ANKH_THROW_MSG("Failed to replace package " + path + ": " + reason);
+        }
+    }
+
+    bool read_package_header(const std::string &path, PackageHeader &header)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            return false;
+        }
+
+        PackageHeader stored{};
+        in.read(reinterpret_cast<char *>(&stored), sizeof(stored));
+        if (!in || stored.magic != PACKAGE_MAGIC || stored.version != PACKAGE_VERSION)
+        {
+            return false;
+        }
+
+        header = stored;
+        return true;
+    }
+
+} // namespace ankh
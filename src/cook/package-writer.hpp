@@ -0,0 +1,32 @@
+// src/cook/package-writer.hpp
+#pragma once
+
+#include "scene/cooked-package.hpp"
+#include "scene/material-pool.hpp"
+#include "scene/mesh-pool.hpp"
+#include "scene/model.hpp"
+
+#include <string>
+
+namespace ankh
+{
+    class JobSystem;
+
+    // Write 'model' and the meshes/materials it references as a cooked package (see
+    // scene/cooked-package.hpp). Meshes keep whatever levels of detail and meshlets they
+    // were built with; vertices use their selected VertexFormat when 'header' has
+    // PACKAGE_COMPACT_VERTICES_BIT. Geometry and pixels are encoded in parallel, and the
+    // file is written next to 'path' and renamed over it, so readers never see a partial
+    // package. Throws on I/O errors.
+    void write_package(const std::string &path,
+                       PackageHeader header,
+                       const Model &model,
+                       const MeshPool &mesh_pool,
+                       const MaterialPool &material_pool,
+                       JobSystem &jobs);
+
+    // Header of an existing package, or false if 'path' is missing, unreadable or from
+    // another PACKAGE_VERSION
+    bool read_package_header(const std::string &path, PackageHeader &header);
+
+} // namespace ankh
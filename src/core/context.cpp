@@ -22,10 +22,13 @@ namespace ankh
             m_debug_messenger = std::make_unique<DebugMessenger>(m_instance->handle());
         }
 
-        m_surface = std::make_unique<Surface>(m_instance->handle(), window);
+        if (window)
+        {
+            m_surface = std::make_unique<Surface>(m_instance->handle(), window);
+        }
 
-        m_physical_device =
-            std::make_unique<PhysicalDevice>(m_instance->handle(), m_surface->handle());
+        m_physical_device = std::make_unique<PhysicalDevice>(m_instance->handle(),
+                                                             surface_handle());
 
         m_device = std::make_unique<Device>(*m_physical_device);
 
@@ -23,6 +23,8 @@ namespace ankh
     class Context
     {
       public:
+        // Pass nullptr for headless rendering: no surface is created and the
+        // device is picked without presentation support.
         explicit Context(GLFWwindow *window);
 
         Context(const Context &) = delete;
@@ -52,6 +54,11 @@ namespace ankh
         VkDevice device_handle() const;
         VkSurfaceKHR surface_handle() const;
 
+        bool headless() const
+        {
+            return m_surface == nullptr;
+        }
+
         VkQueue transfer_queue() const;
         VkQueue graphics_queue() const;
         VkQueue present_queue() const;
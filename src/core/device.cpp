@@ -36,8 +36,9 @@ namespace ankh
         VkPhysicalDeviceSynchronization2Features sync2Sup{};
         sync2Sup.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
 
-        VkPhysicalDeviceTimelineSemaphoreFeatures timelineSup{};
-        timelineSup.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        // Vulkan 1.2 features: timeline semaphores (required), draw indirect count (optional)
+        VkPhysicalDeviceVulkan12Features timelineSup{};
+        timelineSup.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
         timelineSup.pNext = &sync2Sup;
 
         VkPhysicalDeviceFeatures2 featsSup{};
@@ -56,9 +57,12 @@ namespace ankh
         sync2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
         sync2.synchronization2 = VK_TRUE;
 
-        VkPhysicalDeviceTimelineSemaphoreFeatures timeline{};
-        timeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        m_draw_indirect_count = timelineSup.drawIndirectCount == VK_TRUE;
+
+        VkPhysicalDeviceVulkan12Features timeline{};
+        timeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
         timeline.timelineSemaphore = VK_TRUE;
+        timeline.drawIndirectCount = m_draw_indirect_count ? VK_TRUE : VK_FALSE;
         timeline.pNext = &sync2;
 
         VkPhysicalDeviceFeatures2 feats{};
@@ -70,10 +74,21 @@ namespace ankh
         feats.features.wideLines = VK_TRUE;
         feats.features.samplerAnisotropy = VK_TRUE;
 
+        // Indirect draws: one vkCmdDrawIndexedIndirect for all objects, object index via
+        // firstInstance. Optional; DrawPass falls back to direct draws without them.
+        m_multi_draw_indirect = featsSup.features.multiDrawIndirect == VK_TRUE;
+        m_draw_indirect_first_instance = featsSup.features.drawIndirectFirstInstance == VK_TRUE;
+
+        feats.features.multiDrawIndirect = m_multi_draw_indirect ? VK_TRUE : VK_FALSE;
+        feats.features.drawIndirectFirstInstance =
+            m_draw_indirect_first_instance ? VK_TRUE : VK_FALSE;
+
         // ---------------------------
         // 3) Create device
         // ---------------------------
+        // Headless devices render offscreen only and must not require VK_KHR_swapchain
         const char *extensions[] = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+        const uint32_t extensionCount = phys.supports_present() ? 1u : 0u;
 
         VkDeviceCreateInfo ci{};
         ci.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -84,8 +99,8 @@ namespace ankh
         ci.pEnabledFeatures = nullptr;
         ci.pNext = &feats;
 
-        ci.enabledExtensionCount = 1;
-        ci.ppEnabledExtensionNames = extensions;
+        ci.enabledExtensionCount = extensionCount;
+        ci.ppEnabledExtensionNames = extensionCount ? extensions : nullptr;
 
         const char *layers[] = {"VK_LAYER_KHRONOS_validation"};
         if (ankh::config().validation)
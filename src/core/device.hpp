@@ -27,6 +27,22 @@ namespace ankh
             return m_present_queue;
         }
 
+        // Optional features enabled when the physical device supports them
+        bool multi_draw_indirect() const
+        {
+            return m_multi_draw_indirect;
+        }
+
+        bool draw_indirect_first_instance() const
+        {
+            return m_draw_indirect_first_instance;
+        }
+
+        bool draw_indirect_count() const
+        {
+            return m_draw_indirect_count;
+        }
+
         // TODO: add dedicated transfer queue support
         VkQueue transfer_queue() const
         {
@@ -38,6 +54,10 @@ namespace ankh
         VkQueue m_graphics_queue{};
         VkQueue m_present_queue{};
         VkQueue m_transfer_queue{};
+
+        bool m_multi_draw_indirect{false};
+        bool m_draw_indirect_first_instance{false};
+        bool m_draw_indirect_count{false};
     };
 
 } // namespace ankh
@@ -10,9 +10,16 @@ namespace ankh
 
     static std::vector<const char *> get_required_extensions()
     {
-        uint32_t count = 0;
-        const char **glfw_extensions = glfwGetRequiredInstanceExtensions(&count);
-        std::vector<const char *> exts(glfw_extensions, glfw_extensions + count);
+        std::vector<const char *> exts;
+
+        // Headless runs never initialise GLFW and need no surface extensions
+        if (!ankh::config().headless)
+        {
+            uint32_t count = 0;
+            const char **glfw_extensions = glfwGetRequiredInstanceExtensions(&count);
+            exts.assign(glfw_extensions, glfw_extensions + count);
+        }
+
         if (ankh::config().validation)
         {
             exts.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -74,7 +74,10 @@ namespace ankh
             }
 
             VkBool32 presentSupport = VK_FALSE;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            if (surface != VK_NULL_HANDLE)
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            }
 
             if (presentSupport)
             {
@@ -100,6 +103,12 @@ namespace ankh
             indices.transferFamily = indices.graphicsFamily;
         }
 
+        if (surface == VK_NULL_HANDLE)
+        {
+            // Headless: nothing is presented, so "present" work stays on the graphics queue
+            indices.presentFamily = indices.graphicsFamily;
+        }
+
         return indices;
     }
 
@@ -126,19 +135,25 @@ namespace ankh
                 continue;
             }
 
-            if (!check_device_extension_support(dev))
-            {
-                continue;
-            }
+            const bool headless = (surface == VK_NULL_HANDLE);
 
-            auto swapSupport = query_swapchain_support(dev, surface);
-            if (swapSupport.formats.empty() || swapSupport.presentModes.empty())
+            if (!headless)
             {
-                continue;
+                if (!check_device_extension_support(dev))
+                {
+                    continue;
+                }
+
+                auto swapSupport = query_swapchain_support(dev, surface);
+                if (swapSupport.formats.empty() || swapSupport.presentModes.empty())
+                {
+                    continue;
+                }
             }
 
             m_device = dev;
             m_indices = indices;
+            m_supports_present = !headless;
             vkGetPhysicalDeviceProperties(m_device, &m_props);
             break;
         }
@@ -7,6 +7,8 @@ namespace ankh
     class PhysicalDevice
     {
       public:
+        // surface may be VK_NULL_HANDLE for headless rendering; presentation support
+        // is then neither required nor checked.
         PhysicalDevice(VkInstance instance, VkSurfaceKHR surface);
 
         VkPhysicalDevice handle() const
@@ -24,10 +26,16 @@ namespace ankh
             return m_props;
         }
 
+        bool supports_present() const noexcept
+        {
+            return m_supports_present;
+        }
+
       private:
         VkPhysicalDevice m_device{};
         QueueFamilyIndices m_indices;
         VkPhysicalDeviceProperties m_props{};
+        bool m_supports_present{false};
     };
 
 } // namespace ankh
@@ -10,7 +10,7 @@ namespace ankh
     DescriptorPool::DescriptorPool(VkDevice device, uint32_t max_sets)
         : m_device(device)
     {
-        VkDescriptorPoolSize poolSizes[3]{};
+        VkDescriptorPoolSize poolSizes[4]{};
 
         // dynamic uniform buffers
         poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
@@ -24,9 +24,13 @@ namespace ankh
         poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
         poolSizes[2].descriptorCount = max_sets;
 
+        // storage buffers
+        poolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[3].descriptorCount = 2 * max_sets;
+
         VkDescriptorPoolCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        info.poolSizeCount = 3;
+        info.poolSizeCount = 4;
         info.pPoolSizes = poolSizes;
         info.maxSets = max_sets;
 
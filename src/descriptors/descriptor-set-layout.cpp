@@ -18,13 +18,13 @@ namespace ankh
         frameUBO.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
         frameUBO.pImmutableSamplers = nullptr;
 
-        // Binding 1: Object buffer (storage buffer)
-        VkDescriptorSetLayoutBinding objectBuffer{};
-        objectBuffer.binding = 1;
-        objectBuffer.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-        objectBuffer.descriptorCount = 1;
-        objectBuffer.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-        objectBuffer.pImmutableSamplers = nullptr;
+        // Binding 1: per-frame instance -> object id list (storage buffer)
+        VkDescriptorSetLayoutBinding instanceBuffer{};
+        instanceBuffer.binding = 1;
+        instanceBuffer.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        instanceBuffer.descriptorCount = 1;
+        instanceBuffer.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        instanceBuffer.pImmutableSamplers = nullptr;
 
         // Binding 2: combined image sampler
         VkDescriptorSetLayoutBinding sampler{};
@@ -34,7 +34,27 @@ namespace ankh
         sampler.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         sampler.pImmutableSamplers = nullptr;
 
-        std::array<VkDescriptorSetLayoutBinding, 3> bindings = {frameUBO, objectBuffer, sampler};
+        // Binding 3: persistent object buffer (storage buffer, indexed by object id)
+        VkDescriptorSetLayoutBinding objectBuffer{};
+        objectBuffer.binding = 3;
+        objectBuffer.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        objectBuffer.descriptorCount = 1;
+        objectBuffer.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        objectBuffer.pImmutableSamplers = nullptr;
+
+        // Binding 4: material table (storage buffer, indexed by material handle)
+        VkDescriptorSetLayoutBinding materialBuffer{};
+        materialBuffer.binding = 4;
+        materialBuffer.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        materialBuffer.descriptorCount = 1;
+        materialBuffer.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        materialBuffer.pImmutableSamplers = nullptr;
+
+        std::array<VkDescriptorSetLayoutBinding, 5> bindings = {frameUBO,
+                                                                instanceBuffer,
+                                                                sampler,
+                                                                objectBuffer,
+                                                                materialBuffer};
 
         VkDescriptorSetLayoutCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
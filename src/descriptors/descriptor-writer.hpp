@@ -16,7 +16,7 @@ namespace ankh
                                 VkDeviceSize size,
                                 uint32_t binding = 0);
 
-        // 1: storage buffer (ObjectDataGPU array)
+        // storage buffer (instance ids at 1, ObjectDataGPU at 3, MaterialGPU at 4)
         void writeStorageBuffer(VkDescriptorSet set,
                                 VkBuffer buf,
                                 VkDeviceSize offset,
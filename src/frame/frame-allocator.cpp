@@ -20,7 +20,9 @@ namespace ankh
                                             device,
                                             totalSize,
                                             VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
-                                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                                             VMA_MEMORY_USAGE_CPU_TO_GPU,
                                             retirement,
                                             GpuSignal{},
@@ -64,14 +66,11 @@ namespace ankh
         {
 #ifndef NDEBUG
             ANKH_LOG_ERROR("[FrameAllocator] OVERFLOW\n"
-                           "  tag: {}\n"
-                           "  requested: {}\n"
-                           "  remaining: {}\n"
-                           "  capacity: {}",
-                           tag,
-                           size,
-                           m_limits.perFrameBytes - m_writeHead,
-                           m_limits.perFrameBytes);
+                           "  tag: " + std::string(tag) + "\n"
+                           "  requested: " + std::to_string(size) + "\n"
+                           "  remaining: " + std::to_string(m_limits.perFrameBytes - m_writeHead) +
+                           "\n"
+                           "  capacity: " + std::to_string(m_limits.perFrameBytes));
             ANKH_ASSERT(false && "FrameAllocator overflow");
 #endif
             return {};
@@ -20,7 +20,8 @@ namespace ankh
                                VkDescriptorSet descriptorSet,
                                VkImageView textureView,
                                VkSampler textureSampler,
-                               GpuRetirementQueue *retirement)
+                               GpuRetirementQueue *retirement,
+                               uint32_t secondaryCount)
         : m_device{device}
         , m_descriptor_set{descriptorSet}
         , m_retirement{retirement}
@@ -30,6 +31,18 @@ namespace ankh
 
         m_cmd = std::make_unique<CommandBuffer>(m_device, m_pool->handle());
 
+        m_secondary_pools.reserve(secondaryCount);
+        m_secondary_cmds.reserve(secondaryCount);
+
+        for (uint32_t i = 0; i < secondaryCount; ++i)
+        {
+            auto &pool = m_secondary_pools.emplace_back(
+                std::make_unique<CommandPool>(m_device, graphicsQueueFamilyIndex));
+
+            m_secondary_cmds.push_back(std::make_unique<CommandBuffer>(
+                m_device, pool->handle(), VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+        }
+
         m_object_capacity = ankh::config().maxObjects;
 
         VkSemaphoreCreateInfo semInfo{};
@@ -75,6 +88,8 @@ namespace ankh
         : m_device(other.m_device)
         , m_pool(std::move(other.m_pool))
         , m_cmd(std::move(other.m_cmd))
+        , m_secondary_pools(std::move(other.m_secondary_pools))
+        , m_secondary_cmds(std::move(other.m_secondary_cmds))
         , m_descriptor_set(other.m_descriptor_set)
         , m_image_available(other.m_image_available)
         , m_render_finished(other.m_render_finished)
@@ -95,6 +110,13 @@ namespace ankh
     VkCommandBuffer FrameContext::begin(GpuSignal signal)
     {
         m_cmd->reset();
+
+        // The slot's previous submission has completed, so its secondaries are free too
+        for (auto &pool : m_secondary_pools)
+        {
+            pool->reset();
+        }
+
         m_cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
         return m_cmd->handle();
     }
@@ -104,4 +126,28 @@ namespace ankh
         m_cmd->end();
     }
 
+    VkCommandBuffer FrameContext::begin_secondary(uint32_t index,
+                                                  const VkCommandBufferInheritanceInfo &inheritance)
+    {
+        ANKH_ASSERT(index < m_secondary_cmds.size());
+
+        CommandBuffer &cmd = *m_secondary_cmds[index];
+        cmd.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                      VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+                  &inheritance);
+        return cmd.handle();
+    }
+
+    void FrameContext::end_secondary(uint32_t index)
+    {
+        ANKH_ASSERT(index < m_secondary_cmds.size());
+        m_secondary_cmds[index]->end();
+    }
+
+    VkCommandBuffer FrameContext::secondary(uint32_t index) const
+    {
+        ANKH_ASSERT(index < m_secondary_cmds.size());
+        return m_secondary_cmds[index]->handle();
+    }
+
 } // namespace ankh
@@ -3,6 +3,7 @@
 
 #include "utils/types.hpp"
 #include <memory>
+#include <vector>
 #include <vk_mem_alloc.h>
 
 namespace ankh
@@ -25,7 +26,8 @@ namespace ankh
                      VkDescriptorSet descriptorSet,
                      VkImageView textureView,
                      VkSampler textureSampler,
-                     GpuRetirementQueue *retirement);
+                     GpuRetirementQueue *retirement,
+                     uint32_t secondaryCount = 0);
 
         ~FrameContext();
 
@@ -83,12 +85,28 @@ namespace ankh
         VkCommandBuffer begin(GpuSignal signal);
         void end();
 
+        // Secondary command buffers for parallel recording inside a render pass.
+        // Each one has its own pool, so different indices may be recorded on different
+        // threads. Pools are recycled by begin().
+        uint32_t secondary_count() const
+        {
+            return static_cast<uint32_t>(m_secondary_cmds.size());
+        }
+
+        VkCommandBuffer begin_secondary(uint32_t index,
+                                        const VkCommandBufferInheritanceInfo &inheritance);
+        void end_secondary(uint32_t index);
+        VkCommandBuffer secondary(uint32_t index) const;
+
       private:
         VkDevice m_device{VK_NULL_HANDLE};
 
         std::unique_ptr<CommandPool> m_pool;
         std::unique_ptr<CommandBuffer> m_cmd;
 
+        std::vector<std::unique_ptr<CommandPool>> m_secondary_pools;
+        std::vector<std::unique_ptr<CommandBuffer>> m_secondary_cmds;
+
         VkDescriptorSet m_descriptor_set{VK_NULL_HANDLE};
 
         VkSemaphore m_image_available{VK_NULL_HANDLE};
@@ -0,0 +1,249 @@
+// src/jobs/job-system.cpp
+#include "jobs/job-system.hpp"
+
+#include "utils/logging.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace ankh
+{
+
+    namespace
+    {
+        // Which system/queue the current thread belongs to
+        thread_local const JobSystem *t_system = nullptr;
+        thread_local uint32_t t_index = 0;
+
+        std::string describe(const std::exception_ptr &error)
+        {
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (const std::exception &e)
+            {
+                return e.what();
+            }
+            catch (...)
+            {
+                return "unknown exception";
+            }
+        }
+    } // namespace
+
+    JobSystem::JobSystem(uint32_t threads)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        m_queues.reserve(threads);
+        for (uint32_t i = 0; i < threads; ++i)
+        {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+
+        t_system = this;
+        t_index = 0;
+
+        m_threads.reserve(threads - 1);
+        for (uint32_t i = 1; i < threads; ++i)
+        {
+            m_threads.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard lock{m_sleep_mutex};
+            m_stop = true;
+        }
+
+        m_wake.notify_all();
+
+        for (auto &t : m_threads)
+        {
+            t.join();
+        }
+
+        if (t_system == this)
+        {
+            t_system = nullptr;
+        }
+    }
+
+    void JobSystem::run(Job job, JobCounter *counter)
+    {
+        if (counter)
+        {
+            counter->m_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        push(Entry{std::move(job), counter});
+    }
+
+    void JobSystem::wait(JobCounter &counter)
+    {
+        while (!counter.done())
+        {
+            if (!try_execute())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // finish() drops the counter's lock last; once we hold it the counter is ours again
+        std::lock_guard lock{counter.m_mutex};
+
+        if (counter.m_error)
+        {
+            std::rethrow_exception(std::exchange(counter.m_error, nullptr));
+        }
+    }
+
+    void JobSystem::push(Entry entry)
+    {
+        Queue &queue = *m_queues[local_index()];
+        {
+            std::lock_guard lock{queue.mutex};
+            queue.jobs.push_back(std::move(entry));
+        }
+
+        m_queued.fetch_add(1, std::memory_order_release);
+
+        {
+            std::lock_guard lock{m_sleep_mutex};
+        }
+        m_wake.notify_one();
+    }
+
+    bool JobSystem::try_execute()
+    {
+        Entry entry;
+
+        if (!pop_local(entry) && !steal(entry))
+        {
+            return false;
+        }
+
+        execute(entry);
+        return true;
+    }
+
+    bool JobSystem::pop_local(Entry &out)
+    {
+        Queue &queue = *m_queues[local_index()];
+        std::lock_guard lock{queue.mutex};
+
+        if (queue.jobs.empty())
+        {
+            return false;
+        }
+
+        out = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool JobSystem::steal(Entry &out)
+    {
+        const uint32_t self = local_index();
+        const uint32_t count = thread_count();
+
+        for (uint32_t n = 1; n < count; ++n)
+        {
+            Queue &victim = *m_queues[(self + n) % count];
+            std::lock_guard lock{victim.mutex};
+
+            if (victim.jobs.empty())
+            {
+                continue;
+            }
+
+            out = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    void JobSystem::execute(Entry &entry)
+    {
+        std::exception_ptr error;
+
+        try
+        {
+            entry.job();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        if (entry.counter == nullptr)
+        {
+            // Nobody waits for this job; rethrowing here would terminate a worker
+            if (error)
+            {
+                ANKH_LOG_ERROR("[JobSystem] Unobserved job failed: " + describe(error));
+            }
+            return;
+        }
+
+        if (error)
+        {
+            std::lock_guard lock{entry.counter->m_mutex};
+            if (!entry.counter->m_error)
+            {
+                entry.counter->m_error = error;
+            }
+        }
+
+        finish(*entry.counter);
+    }
+
+    void JobSystem::finish(JobCounter &counter)
+    {
+        // Under the lock, so wait() cannot return (and the counter go away) until this
+        // thread is done with it
+        std::lock_guard lock{counter.m_mutex};
+        counter.m_count.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void JobSystem::worker_loop(uint32_t index)
+    {
+        t_system = this;
+        t_index = index;
+
+        for (;;)
+        {
+            if (try_execute())
+            {
+                continue;
+            }
+
+            std::unique_lock lock{m_sleep_mutex};
+            m_wake.wait(lock,
+                        [this]
+                        { return m_stop || m_queued.load(std::memory_order_acquire) != 0; });
+
+            if (m_stop)
+            {
+                return;
+            }
+        }
+    }
+
+    uint32_t JobSystem::local_index() const
+    {
+        return t_system == this ? t_index : 0u;
+    }
+
+} // namespace ankh
@@ -0,0 +1,152 @@
+// src/jobs/job-system.hpp
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ankh
+{
+
+    using Job = std::function<void()>;
+
+    class JobSystem;
+
+    // Dependency counter / fence. Every job scheduled with this counter increments it and
+    // decrements it when done; wait() returns at zero. A counter must outlive the jobs
+    // that signal it.
+    class JobCounter
+    {
+      public:
+        JobCounter() = default;
+
+        JobCounter(const JobCounter &) = delete;
+        JobCounter &operator=(const JobCounter &) = delete;
+
+        bool done() const noexcept
+        {
+            return m_count.load(std::memory_order_acquire) == 0;
+        }
+
+      private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_count{0};
+
+        std::mutex m_mutex;
+        std::exception_ptr m_error; // first exception thrown by a signalling job
+    };
+
+    // Work-stealing thread pool.
+    // Each thread (workers plus the thread that created the system) owns a deque: it pushes
+    // and pops at the back (LIFO, cache-warm) while idle threads steal from the front of
+    // other deques. Threads that wait on a counter execute jobs instead of blocking, so
+    // nested parallel_for calls from inside jobs cannot deadlock.
+    class JobSystem
+    {
+      public:
+        // 'threads' includes the creating thread; 0 picks hardware_concurrency().
+        explicit JobSystem(uint32_t threads = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem &) = delete;
+        JobSystem &operator=(const JobSystem &) = delete;
+
+        uint32_t thread_count() const noexcept
+        {
+            return static_cast<uint32_t>(m_queues.size());
+        }
+
+        // Without a counter nobody waits for 'job': an exception it throws is logged and
+        // dropped.
+        void run(Job job, JobCounter *counter = nullptr);
+
+        // Execute jobs until 'counter' reaches zero, then rethrow the first exception
+        // thrown by any job that signalled it.
+        void wait(JobCounter &counter);
+
+        // Call fn(first, last) over [begin, end) in chunks of at most 'grain' elements and
+        // wait for all of them. Small ranges run inline on the calling thread.
+        template <typename Fn>
+        void parallel_for(uint32_t begin, uint32_t end, uint32_t grain, Fn &&fn)
+        {
+            if (end <= begin)
+            {
+                return;
+            }
+
+            grain = grain == 0 ? 1u : grain;
+
+            if (end - begin <= grain || thread_count() == 1)
+            {
+                fn(begin, end);
+                return;
+            }
+
+            JobCounter counter;
+
+            for (uint32_t first = begin; first < end; first += grain)
+            {
+                const uint32_t last = (end - first > grain) ? first + grain : end;
+                run([&fn, first, last] { fn(first, last); }, &counter);
+            }
+
+            wait(counter);
+        }
+
+      private:
+        struct Entry
+        {
+            Job job;
+            JobCounter *counter{nullptr};
+        };
+
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Entry> jobs;
+        };
+
+        void push(Entry entry);
+        bool try_execute();
+        bool pop_local(Entry &out);
+        bool steal(Entry &out);
+        void execute(Entry &entry);
+        void finish(JobCounter &counter);
+        void worker_loop(uint32_t index);
+        uint32_t local_index() const;
+
+      private:
+        // Queue i belongs to thread i; queue 0 is the creating thread (and any foreign one)
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_threads;
+
+        std::atomic<uint32_t> m_queued{0};
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_wake;
+        bool m_stop{false};
+    };
+
+    // Call fn(first, last) over [0, count): through jobs->parallel_for, or as one inline
+    // call when there is no JobSystem
+    template <typename Fn>
+    void for_range(JobSystem *jobs, uint32_t count, uint32_t grain, Fn &&fn)
+    {
+        if (jobs)
+        {
+            jobs->parallel_for(0, count, grain, fn);
+        }
+        else if (count != 0)
+        {
+            fn(0u, count);
+        }
+    }
+
+} // namespace ankh
@@ -1,13 +1,42 @@
+#include <cstdlib>
 #include <iostream>
+#include <string_view>
 
 #include "app/application.hpp"
+#include "utils/config.hpp"
 #include "utils/logging.hpp"
 
-int main()
+namespace
+{
+    void parse_args(int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg{argv[i]};
+
+            if (arg == "--headless")
+            {
+                ankh::config().headless = true;
+            }
+            else if (arg.starts_with("--frames="))
+            {
+                const std::string value{arg.substr(std::string_view{"--frames="}.size())};
+                ankh::config().headlessFrames = static_cast<uint32_t>(std::stoul(value));
+            }
+            else if (!ankh::apply_config_arg(arg)) // shared options, see utils/config.hpp
+            {
+                ANKH_LOG_WARN("Ignoring unknown argument: " + std::string(arg));
+            }
+        }
+    }
+} // namespace
+
+int main(int argc, char **argv)
 {
     try
     {
         ankh::log::init();
+        parse_args(argc, argv);
         ankh::Application app;
         app.run();
     }
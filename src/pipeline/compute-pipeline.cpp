@@ -0,0 +1,38 @@
+#include "pipeline/compute-pipeline.hpp"
+#include "shaders/shader-module.hpp"
+#include <utils/logging.hpp>
+
+namespace ankh
+{
+
+    ComputePipeline::ComputePipeline(VkDevice device,
+                                     VkPipelineLayout layout,
+                                     const std::string &spv_path)
+        : m_device(device)
+    {
+        ShaderModule comp(device, spv_path);
+
+        VkPipelineShaderStageCreateInfo stage{};
+        stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        stage.module = comp.handle();
+        stage.pName = "main";
+
+        VkComputePipelineCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        info.stage = stage;
+        info.layout = layout;
+
+        ANKH_VK_CHECK(
+            vkCreateComputePipelines(m_device, VK_NULL_HANDLE, 1, &info, nullptr, &m_pipeline));
+    }
+
+    ComputePipeline::~ComputePipeline()
+    {
+        if (m_pipeline)
+        {
+            vkDestroyPipeline(m_device, m_pipeline, nullptr);
+        }
+    }
+
+} // namespace ankh
@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include "utils/types.hpp"
+
+namespace ankh
+{
+
+    class ComputePipeline
+    {
+    public:
+        ComputePipeline(VkDevice device, VkPipelineLayout layout, const std::string &spv_path);
+
+        ~ComputePipeline();
+
+        ComputePipeline(const ComputePipeline &) = delete;
+        ComputePipeline &operator=(const ComputePipeline &) = delete;
+
+        VkPipeline handle() const { return m_pipeline; }
+
+    private:
+        VkDevice m_device{};
+        VkPipeline m_pipeline{};
+    };
+
+} // namespace ankh
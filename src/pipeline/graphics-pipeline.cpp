@@ -28,15 +28,6 @@ namespace ankh
         stages[1].module = frag.handle();
         stages[1].pName = "main";
 
-        auto bindingDesc = Vertex::getBindingDescription();
-        auto attrDescs = Vertex::getAttributeDescriptions();
-
-        VkPipelineVertexInputStateCreateInfo vi{};
-        vi.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vi.vertexBindingDescriptionCount = 1;
-        vi.pVertexBindingDescriptions = &bindingDesc;
-        vi.vertexAttributeDescriptionCount = static_cast<uint32_t>(attrDescs.size());
-        vi.pVertexAttributeDescriptions = attrDescs.data();
 
         VkPipelineInputAssemblyStateCreateInfo ia{};
         ia.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -85,31 +76,67 @@ namespace ankh
         depthStencil.depthBoundsTestEnable = VK_FALSE;
         depthStencil.stencilTestEnable = VK_FALSE;
 
-        VkGraphicsPipelineCreateInfo ci{};
-        ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        ci.stageCount = 2;
-        ci.pStages = stages;
-        ci.pVertexInputState = &vi;
-        ci.pInputAssemblyState = &ia;
-        ci.pViewportState = &vp;
-        ci.pRasterizationState = &rs;
-        ci.pMultisampleState = &ms;
-        ci.pDepthStencilState = &depthStencil;
-        ci.pColorBlendState = &cb;
-        ci.pDynamicState = &ds;
-        ci.layout = layout;
-        ci.renderPass = render_pass;
-        ci.subpass = 0;
-
-        ANKH_VK_CHECK(
-            vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &ci, nullptr, &m_pipeline));
+        // vert.vert: constant_id 0 = normals are octahedral-encoded
+        VkSpecializationMapEntry octNormalsEntry{};
+        octNormalsEntry.constantID = 0;
+        octNormalsEntry.offset = 0;
+        octNormalsEntry.size = sizeof(VkBool32);
+
+        for (uint32_t f = 0; f < VERTEX_FORMAT_COUNT; ++f)
+        {
+            const VertexFormat format = static_cast<VertexFormat>(f);
+            const VertexInputLayout input = vertex_input_layout(format);
+
+            VkPipelineVertexInputStateCreateInfo vi{};
+            vi.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+            vi.vertexBindingDescriptionCount = 1;
+            vi.pVertexBindingDescriptions = &input.binding;
+            vi.vertexAttributeDescriptionCount = static_cast<uint32_t>(input.attributes.size());
+            vi.pVertexAttributeDescriptions = input.attributes.data();
+
+            const VkBool32 octNormals = (format == VertexFormat::Float) ? VK_FALSE : VK_TRUE;
+
+            VkSpecializationInfo specialization{};
+            specialization.mapEntryCount = 1;
+            specialization.pMapEntries = &octNormalsEntry;
+            specialization.dataSize = sizeof(octNormals);
+            specialization.pData = &octNormals;
+
+            stages[0].pSpecializationInfo = &specialization;
+
+            VkGraphicsPipelineCreateInfo ci{};
+            ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+            ci.stageCount = 2;
+            ci.pStages = stages;
+            ci.pVertexInputState = &vi;
+            ci.pInputAssemblyState = &ia;
+            ci.pViewportState = &vp;
+            ci.pRasterizationState = &rs;
+            ci.pMultisampleState = &ms;
+            ci.pDepthStencilState = &depthStencil;
+            ci.pColorBlendState = &cb;
+            ci.pDynamicState = &ds;
+            ci.layout = layout;
+            ci.renderPass = render_pass;
+            ci.subpass = 0;
+
+            ANKH_VK_CHECK(vkCreateGraphicsPipelines(m_device,
+                                                    VK_NULL_HANDLE,
+                                                    1,
+                                                    &ci,
+                                                    nullptr,
+                                                    &m_pipelines[f]));
+        }
     }
 
     GraphicsPipeline::~GraphicsPipeline()
     {
-        if (m_pipeline)
+        for (VkPipeline pipeline : m_pipelines)
         {
-            vkDestroyPipeline(m_device, m_pipeline, nullptr);
+            if (pipeline)
+            {
+                vkDestroyPipeline(m_device, pipeline, nullptr);
+            }
         }
     }
 
@@ -1,9 +1,14 @@
 #pragma once
 #include "utils/types.hpp"
+#include "utils/vertex-format.hpp"
+
+#include <array>
 
 namespace ankh
 {
 
+    // The scene pipeline, built once per VertexFormat: the variants differ only in their
+    // vertex input state and the normal decode in vert.vert (specialization constant 0)
     class GraphicsPipeline
     {
     public:
@@ -13,11 +18,14 @@ namespace ankh
 
         ~GraphicsPipeline();
 
-        VkPipeline handle() const { return m_pipeline; }
+        VkPipeline handle(VertexFormat format = VertexFormat::Float) const
+        {
+            return m_pipelines[static_cast<uint32_t>(format)];
+        }
 
     private:
         VkDevice m_device{};
-        VkPipeline m_pipeline{};
+        std::array<VkPipeline, VERTEX_FORMAT_COUNT> m_pipelines{};
     };
 
 } // namespace ankh
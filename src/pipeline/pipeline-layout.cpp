@@ -8,17 +8,13 @@ namespace ankh
     PipelineLayout::PipelineLayout(VkDevice device, VkDescriptorSetLayout set_layout)
         : m_device(device)
     {
-        VkPushConstantRange pcRange{};
-        pcRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-        pcRange.offset = 0;
-        pcRange.size = sizeof(uint32_t); // objectIndex
-
+        // No push constants: the object index arrives as gl_InstanceIndex (firstInstance)
         VkPipelineLayoutCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         info.setLayoutCount = 1;
         info.pSetLayouts = &set_layout;
-        info.pushConstantRangeCount = 1;
-        info.pPushConstantRanges = &pcRange;
+        info.pushConstantRangeCount = 0;
+        info.pPushConstantRanges = nullptr;
 
         ANKH_VK_CHECK(vkCreatePipelineLayout(m_device, &info, nullptr, &m_layout));
     }
@@ -0,0 +1,284 @@
+// src/profiling/gpu-profiler.cpp
+#include "profiling/gpu-profiler.hpp"
+
+#include "utils/logging.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <fstream>
+#include <sstream>
+
+namespace ankh
+{
+
+    GpuProfiler::GpuProfiler(VkPhysicalDevice physicalDevice,
+                             VkDevice device,
+                             uint32_t queueFamilyIndex,
+                             uint32_t framesInFlight)
+        : m_device{device}
+        , m_slots(framesInFlight ? framesInFlight : 1u)
+    {
+        // Scope 0 is always the whole frame
+        m_scopes.push_back(GpuScopeTiming{"frame"});
+        m_sums.push_back(0.0);
+
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+
+        const uint32_t validBits =
+            queueFamilyIndex < familyCount ? families[queueFamilyIndex].timestampValidBits : 0u;
+
+        if (validBits == 0 || props.limits.timestampPeriod <= 0.0f)
+        {
+            ANKH_LOG_WARN("[GpuProfiler] Timestamps not supported on this queue; GPU timings "
+                          "disabled");
+            return;
+        }
+
+        m_period_ns = static_cast<double>(props.limits.timestampPeriod);
+        m_valid_mask = (validBits >= 64) ? ~0ull : ((1ull << validBits) - 1ull);
+
+        VkQueryPoolCreateInfo ci{};
+        ci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        ci.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        ci.queryCount = static_cast<uint32_t>(m_slots.size()) * kQueriesPerSlot;
+
+        ANKH_VK_CHECK(vkCreateQueryPool(m_device, &ci, nullptr, &m_pool));
+
+        for (auto &slot : m_slots)
+        {
+            slot.scopes.reserve(kMaxScopesPerFrame);
+        }
+    }
+
+    GpuProfiler::~GpuProfiler()
+    {
+        if (m_pool != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(m_device, m_pool, nullptr);
+            m_pool = VK_NULL_HANDLE;
+        }
+    }
+
+    void GpuProfiler::begin_frame(VkCommandBuffer cmd, FrameSlot slot)
+    {
+        if (!supported())
+        {
+            return;
+        }
+
+        SlotState &state = m_slots[slot];
+        state.scopes.clear();
+        state.scopes.push_back(0);
+
+        vkCmdResetQueryPool(cmd, m_pool, first_query(slot), kQueriesPerSlot);
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_pool, first_query(slot));
+    }
+
+    void GpuProfiler::end_frame(VkCommandBuffer cmd, FrameSlot slot)
+    {
+        if (!supported())
+        {
+            return;
+        }
+
+        vkCmdWriteTimestamp(cmd,
+                            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            m_pool,
+                            first_query(slot) + 1);
+
+        m_slots[slot].pending = true;
+    }
+
+    uint32_t GpuProfiler::begin_scope(VkCommandBuffer cmd, FrameSlot slot, std::string_view name)
+    {
+        if (!supported())
+        {
+            return kInvalidScope;
+        }
+
+        SlotState &state = m_slots[slot];
+
+        if (state.scopes.size() >= kMaxScopesPerFrame)
+        {
+            ANKH_LOG_WARN("[GpuProfiler] Out of timestamp queries for scope '" +
+                          std::string(name) + "'");
+            return kInvalidScope;
+        }
+
+        const uint32_t pair = static_cast<uint32_t>(state.scopes.size());
+        state.scopes.push_back(scope_id(name));
+
+        vkCmdWriteTimestamp(cmd,
+                            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                            m_pool,
+                            first_query(slot) + 2 * pair);
+
+        return pair;
+    }
+
+    void GpuProfiler::end_scope(VkCommandBuffer cmd, FrameSlot slot, uint32_t scope)
+    {
+        if (!supported() || scope == kInvalidScope)
+        {
+            return;
+        }
+
+        vkCmdWriteTimestamp(cmd,
+                            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            m_pool,
+                            first_query(slot) + 2 * scope + 1);
+    }
+
+    void GpuProfiler::collect(FrameSlot slot)
+    {
+        SlotState &state = m_slots[slot];
+
+        if (!supported() || !state.pending)
+        {
+            return;
+        }
+
+        const uint32_t queryCount = 2 * static_cast<uint32_t>(state.scopes.size());
+        std::array<uint64_t, kQueriesPerSlot> ticks{};
+
+        // No WAIT bit: the slot fence has signalled, so VK_NOT_READY only means the frame
+        // never reached the GPU (e.g. skipped after a failed acquire).
+        const VkResult res = vkGetQueryPoolResults(m_device,
+                                                   m_pool,
+                                                   first_query(slot),
+                                                   queryCount,
+                                                   sizeof(uint64_t) * queryCount,
+                                                   ticks.data(),
+                                                   sizeof(uint64_t),
+                                                   VK_QUERY_RESULT_64_BIT);
+
+        if (res == VK_NOT_READY)
+        {
+            return;
+        }
+
+        ANKH_VK_CHECK(res);
+
+        state.pending = false;
+
+        for (size_t pair = 0; pair < state.scopes.size(); ++pair)
+        {
+            const uint32_t id = state.scopes[pair];
+            const uint64_t delta = (ticks[2 * pair + 1] - ticks[2 * pair]) & m_valid_mask;
+            const double ms = static_cast<double>(delta) * m_period_ns * 1e-6;
+
+            GpuScopeTiming &timing = m_scopes[id];
+            timing.lastMs = ms;
+            ++timing.samples;
+            m_sums[id] += ms;
+            timing.avgMs = m_sums[id] / static_cast<double>(timing.samples);
+        }
+
+        ++m_resolved_frames;
+
+        if (m_history_enabled)
+        {
+            m_frame_history.push_back(m_scopes.front().lastMs);
+        }
+
+        if (m_report_interval != 0 && ++m_frames_since_report >= m_report_interval)
+        {
+            report();
+        }
+    }
+
+    void GpuProfiler::reset_averages()
+    {
+        for (size_t i = 0; i < m_scopes.size(); ++i)
+        {
+            m_scopes[i].avgMs = 0.0;
+            m_scopes[i].samples = 0;
+            m_sums[i] = 0.0;
+        }
+    }
+
+    std::string GpuProfiler::dump_json() const
+    {
+        nlohmann::json scopes = nlohmann::json::array();
+
+        for (const auto &s : m_scopes)
+        {
+            scopes.push_back({
+                {"name", s.name},
+                {"lastMs", s.lastMs},
+                {"avgMs", s.avgMs},
+                {"samples", s.samples},
+            });
+        }
+
+        nlohmann::json doc{
+            {"frames", m_resolved_frames},
+            {"scopes", std::move(scopes)},
+        };
+
+        return doc.dump(2);
+    }
+
+    void GpuProfiler::set_report_interval(uint32_t frames, std::string jsonPath)
+    {
+        m_report_interval = frames;
+        m_report_path = std::move(jsonPath);
+        m_frames_since_report = 0;
+    }
+
+    uint32_t GpuProfiler::scope_id(std::string_view name)
+    {
+        for (uint32_t i = 0; i < m_scopes.size(); ++i)
+        {
+            if (m_scopes[i].name == name)
+            {
+                return i;
+            }
+        }
+
+        m_scopes.push_back(GpuScopeTiming{std::string(name)});
+        m_sums.push_back(0.0);
+        return static_cast<uint32_t>(m_scopes.size() - 1);
+    }
+
+    void GpuProfiler::report()
+    {
+        std::ostringstream line;
+        line << "[GpuProfiler] avg over " << m_frames_since_report << " frames:";
+
+        for (const auto &s : m_scopes)
+        {
+            if (s.samples != 0)
+            {
+                line << ' ' << s.name << '=' << s.avgMs << "ms";
+            }
+        }
+
+        ANKH_LOG_INFO(line.str());
+
+        if (!m_report_path.empty())
+        {
+            std::ofstream out(m_report_path, std::ios::trunc);
+            if (out)
+            {
+                out << dump_json() << '\n';
+            }
+            else
+            {
+                ANKH_LOG_WARN("[GpuProfiler] Failed to write " + m_report_path);
+            }
+        }
+
+        m_frames_since_report = 0;
+        reset_averages();
+    }
+
+} // namespace ankh
@@ -0,0 +1,171 @@
+// src/profiling/gpu-profiler.hpp
+#pragma once
+
+#include "sync/frame-ring.hpp"
+#include "utils/types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ankh
+{
+
+    struct GpuScopeTiming
+    {
+        std::string name;
+        double lastMs{0.0};
+        double avgMs{0.0};    // average since the last report / reset_averages()
+        uint64_t samples{0};  // samples in that average
+    };
+
+    // GPU timings built on timestamp queries.
+    // Each frame slot owns its own range of queries: one pair for the whole frame plus one
+    // pair per named scope (pass). Results are read back only after the slot's fence has
+    // signalled (collect), so reading never stalls the CPU.
+    class GpuProfiler
+    {
+      public:
+        static constexpr uint32_t kMaxScopesPerFrame = 16; // including the frame scope
+        static constexpr uint32_t kInvalidScope = UINT32_MAX;
+
+        GpuProfiler(VkPhysicalDevice physicalDevice,
+                    VkDevice device,
+                    uint32_t queueFamilyIndex,
+                    uint32_t framesInFlight);
+
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler &) = delete;
+        GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+        // False when the queue family has no timestamp support; all calls are then no-ops.
+        bool supported() const noexcept
+        {
+            return m_pool != VK_NULL_HANDLE;
+        }
+
+        // Record around the whole frame. Must be called outside a render pass.
+        void begin_frame(VkCommandBuffer cmd, FrameSlot slot);
+        void end_frame(VkCommandBuffer cmd, FrameSlot slot);
+
+        // Bracket a pass between begin_frame/end_frame. Returns a handle for end_scope,
+        // or kInvalidScope when the slot ran out of queries.
+        uint32_t begin_scope(VkCommandBuffer cmd, FrameSlot slot, std::string_view name);
+        void end_scope(VkCommandBuffer cmd, FrameSlot slot, uint32_t scope);
+
+        // Read back the slot's previous frame. Call once its fence has signalled.
+        void collect(FrameSlot slot);
+
+        // Number of frames resolved so far; changes whenever last_frame_ms() is updated.
+        uint64_t resolved_frames() const noexcept
+        {
+            return m_resolved_frames;
+        }
+
+        double last_frame_ms() const noexcept
+        {
+            return m_scopes.front().lastMs;
+        }
+
+        // Frame scope first, then passes in first-seen order
+        const std::vector<GpuScopeTiming> &scope_timings() const noexcept
+        {
+            return m_scopes;
+        }
+
+        void reset_averages();
+
+        // {"frames": N, "scopes": [{"name", "lastMs", "avgMs", "samples"}, ...]}
+        std::string dump_json() const;
+
+        // Every 'frames' resolved frames: log per-pass averages, write them to 'jsonPath'
+        // (if not empty) and reset the averages. 0 disables reporting.
+        void set_report_interval(uint32_t frames, std::string jsonPath = {});
+
+        // Optionally keep every resolved frame time (benchmarks); off by default.
+        void set_history_enabled(bool enabled)
+        {
+            m_history_enabled = enabled;
+        }
+
+        const std::vector<double> &frame_history() const noexcept
+        {
+            return m_frame_history;
+        }
+
+        void clear_history()
+        {
+            m_frame_history.clear();
+        }
+
+      private:
+        static constexpr uint32_t kQueriesPerSlot = 2 * kMaxScopesPerFrame;
+
+        struct SlotState
+        {
+            bool pending{false};         // queries written, not yet read back
+            std::vector<uint32_t> scopes; // scope id per query pair, in write order
+        };
+
+        uint32_t first_query(FrameSlot slot) const noexcept
+        {
+            return slot * kQueriesPerSlot;
+        }
+
+        uint32_t scope_id(std::string_view name);
+        void report();
+
+      private:
+        VkDevice m_device{VK_NULL_HANDLE};
+        VkQueryPool m_pool{VK_NULL_HANDLE};
+
+        double m_period_ns{1.0};
+        uint64_t m_valid_mask{~0ull};
+
+        std::vector<SlotState> m_slots;
+        std::vector<GpuScopeTiming> m_scopes; // index = scope id; 0 is the frame
+        std::vector<double> m_sums;           // per scope id, since last reset
+
+        uint64_t m_resolved_frames{0};
+
+        uint32_t m_report_interval{0};
+        uint32_t m_frames_since_report{0};
+        std::string m_report_path;
+
+        bool m_history_enabled{false};
+        std::vector<double> m_frame_history;
+    };
+
+    // Brackets one pass for the lifetime of the object
+    class GpuProfileScope
+    {
+      public:
+        GpuProfileScope(GpuProfiler &profiler,
+                        VkCommandBuffer cmd,
+                        FrameSlot slot,
+                        std::string_view name)
+            : m_profiler{profiler}
+            , m_cmd{cmd}
+            , m_slot{slot}
+            , m_scope{profiler.begin_scope(cmd, slot, name)}
+        {
+        }
+
+        ~GpuProfileScope()
+        {
+            m_profiler.end_scope(m_cmd, m_slot, m_scope);
+        }
+
+        GpuProfileScope(const GpuProfileScope &) = delete;
+        GpuProfileScope &operator=(const GpuProfileScope &) = delete;
+
+      private:
+        GpuProfiler &m_profiler;
+        VkCommandBuffer m_cmd{VK_NULL_HANDLE};
+        FrameSlot m_slot{0};
+        uint32_t m_scope{GpuProfiler::kInvalidScope};
+    };
+
+} // namespace ankh
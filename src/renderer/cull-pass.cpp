@@ -0,0 +1,369 @@
+// src/renderer/cull-pass.cpp
+#include "renderer/cull-pass.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "descriptors/descriptor-writer.hpp"
+#include "frame/frame-allocator.hpp"
+#include "frame/frame-context.hpp"
+#include "memory/buffer.hpp"
+#include "pipeline/compute-pipeline.hpp"
+
+#include <utils/logging.hpp>
+
+namespace ankh
+{
+    namespace
+    {
+        struct CullPC
+        {
+            uint32_t objectCount;
+            uint32_t compact;
+            uint32_t bucketFirst[DRAW_BUCKET_COUNT]; // first command of each draw bucket
+        };
+
+        constexpr VkDeviceSize kCountBytes = sizeof(uint32_t) * DRAW_BUCKET_COUNT;
+
+        constexpr uint32_t kWorkgroupSize = 64; // local_size_x in cull.comp
+    } // namespace
+
+    CullPass::CullPass(VkDevice device,
+                       VmaAllocator allocator,
+                       uint32_t frames_in_flight,
+                       uint32_t max_objects,
+                       uint32_t max_cluster_draws,
+                       VkBuffer frame_buffer,
+                       VkDeviceSize instance_base,
+                       VkDeviceSize instance_range,
+                       VkBuffer object_buffer,
+                       VkDeviceSize object_buffer_size,
+                       bool draw_indirect_count)
+        : m_device(device)
+        , m_max_objects(max_objects)
+        , m_max_draws(max_objects + max_cluster_draws)
+        , m_draw_indirect_count(draw_indirect_count)
+        , m_slots(frames_in_flight)
+    {
+        // 0: FrameUBO (frustum planes), 1: instance ids, 2: cull input  -> dynamic, per frame
+        // 3: draw commands, 4: draw count                               -> per-slot output
+        // 5: ObjectBuffer                                               -> persistent
+        std::array<VkDescriptorSetLayoutBinding, 6> bindings{};
+        for (uint32_t i = 0; i < bindings.size(); ++i)
+        {
+            bindings[i].binding = i;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+        bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[5].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
+        VkDescriptorSetLayoutCreateInfo setInfo{};
+        setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        setInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        setInfo.pBindings = bindings.data();
+
+        ANKH_VK_CHECK(vkCreateDescriptorSetLayout(m_device, &setInfo, nullptr, &m_set_layout));
+
+        const uint32_t sets = static_cast<uint32_t>(m_slots.size());
+
+        std::array<VkDescriptorPoolSize, 3> poolSizes{};
+        poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        poolSizes[0].descriptorCount = sets;
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        poolSizes[1].descriptorCount = 2 * sets;
+        poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[2].descriptorCount = 3 * sets;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
+        poolInfo.maxSets = sets;
+
+        ANKH_VK_CHECK(vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_pool));
+
+        VkPushConstantRange pcRange{};
+        pcRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pcRange.offset = 0;
+        pcRange.size = sizeof(CullPC);
+
+        VkPipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.setLayoutCount = 1;
+        layoutInfo.pSetLayouts = &m_set_layout;
+        layoutInfo.pushConstantRangeCount = 1;
+        layoutInfo.pPushConstantRanges = &pcRange;
+
+        ANKH_VK_CHECK(vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &m_layout));
+
+        m_pipeline = std::make_unique<ComputePipeline>(m_device, m_layout, "shaders/cull.spv");
+
+        std::vector<VkDescriptorSetLayout> layouts(sets, m_set_layout);
+        std::vector<VkDescriptorSet> allocated(sets);
+
+        VkDescriptorSetAllocateInfo ai{};
+        ai.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        ai.descriptorPool = m_pool;
+        ai.descriptorSetCount = sets;
+        ai.pSetLayouts = layouts.data();
+
+        ANKH_VK_CHECK(vkAllocateDescriptorSets(m_device, &ai, allocated.data()));
+
+        const VkDeviceSize commandBytes =
+            sizeof(VkDrawIndexedIndirectCommand) * static_cast<VkDeviceSize>(m_max_draws);
+        const VkDeviceSize inputBytes =
+            sizeof(CullObjectGPU) * static_cast<VkDeviceSize>(m_max_draws);
+
+        DescriptorWriter writer{m_device};
+
+        for (uint32_t i = 0; i < sets; ++i)
+        {
+            SlotData &slot = m_slots[i];
+            slot.set = allocated[i];
+
+            slot.output = std::make_unique<Buffer>(allocator,
+                                                   m_device,
+                                                   kCommandsOffset + commandBytes,
+                                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                       VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                                       VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                   VMA_MEMORY_USAGE_GPU_ONLY);
+
+            writer.writeUniformBufferDynamic(slot.set, frame_buffer, 0, sizeof(FrameUBO), 0);
+            writer.writeStorageBufferDynamic(slot.set,
+                                             frame_buffer,
+                                             instance_base,
+                                             instance_range,
+                                             1);
+            writer.writeStorageBufferDynamic(slot.set, frame_buffer, 0, inputBytes, 2);
+            writer.writeStorageBuffer(slot.set,
+                                      slot.output->handle(),
+                                      kCommandsOffset,
+                                      commandBytes,
+                                      3);
+            writer.writeStorageBuffer(slot.set, slot.output->handle(), 0, kCountBytes, 4);
+            writer.writeStorageBuffer(slot.set, object_buffer, 0, object_buffer_size, 5);
+        }
+    }
+
+    CullPass::~CullPass()
+    {
+        m_pipeline.reset();
+
+        if (m_layout != VK_NULL_HANDLE)
+        {
+            vkDestroyPipelineLayout(m_device, m_layout, nullptr);
+        }
+
+        if (m_pool != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorPool(m_device, m_pool, nullptr);
+        }
+
+        if (m_set_layout != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorSetLayout(m_device, m_set_layout, nullptr);
+        }
+    }
+
+    void CullPass::prepare(FrameSlot slot,
+                           FrameAllocator &frame_allocator,
+                           const RenderableStore &renderables,
+                           const std::vector<uint32_t> &visible,
+                           const std::vector<uint8_t> &lods,
+                           uint32_t count,
+                           const std::vector<MeshDrawInfo> &draw_table,
+                           const std::vector<Meshlet> &clusters)
+    {
+        SlotData &data = m_slots[slot];
+        data.objectCount = 0;
+        data.buckets = {};
+
+        count = std::min({count, m_max_objects, static_cast<uint32_t>(visible.size())});
+        if (count == 0)
+        {
+            return;
+        }
+
+        // Commands for instance slot i: 0 (no GPU range), 1 (whole object) or one per
+        // cluster when drawn at level 0 and the clusters beyond the first fit 'budget'
+        const auto commands = [&](uint32_t i, uint32_t budget) -> uint32_t
+        {
+            const MeshHandle mesh = renderables.mesh(visible[i]);
+            if (mesh >= draw_table.size() || draw_table[mesh].indexCount == 0)
+            {
+                return 0;
+            }
+
+            const MeshDrawInfo &info = draw_table[mesh];
+            const uint32_t lod = i < lods.size() ? lods[i] : 0u;
+            const bool split = lod == 0 && info.clusterCount > 1 && info.clusterCount - 1 <= budget;
+            return split ? info.clusterCount : 1u;
+        };
+
+        uint32_t total = 0;
+        for (uint32_t i = 0, budget = m_max_draws - count; i < count; ++i)
+        {
+            const uint32_t n = commands(i, budget);
+            budget -= n > 1 ? n - 1 : 0;
+            total += n;
+        }
+
+        if (total == 0)
+        {
+            return;
+        }
+
+        auto span = frame_allocator.alloc("CullObjectGPU",
+                                          sizeof(CullObjectGPU) * total,
+                                          alignof(CullObjectGPU));
+        if (span.cpu == nullptr)
+        {
+            return; // FrameAllocator overflow (already reported)
+        }
+
+        auto *input = reinterpret_cast<CullObjectGPU *>(span.cpu);
+        uint32_t written = 0;
+        uint32_t lastBucket = 0;
+
+        for (uint32_t i = 0, budget = m_max_draws - count; i < count; ++i)
+        {
+            const uint32_t n = commands(i, budget);
+            if (n == 0)
+            {
+                continue;
+            }
+
+            const MeshDrawInfo &info = draw_table[renderables.mesh(visible[i])];
+
+            const uint32_t bucket = draw_bucket(info.vertexFormat, info.indexWidth);
+            ANKH_ASSERT(bucket >= lastBucket);
+            lastBucket = bucket;
+            data.buckets[bucket].count += n;
+
+            if (n == 1)
+            {
+                const MeshLodRange &range = info.lod(i < lods.size() ? lods[i] : 0u);
+
+                CullObjectGPU &co = input[written++];
+                co.sphere = info.boundingSphere;
+                co.indexCount = range.indexCount;
+                co.firstIndex = range.firstIndex;
+                co.vertexOffset = info.vertexOffset;
+                co.objectIndex = i;
+                co.cone = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+                continue;
+            }
+
+            budget -= n - 1;
+            for (uint32_t c = 0; c < n; ++c)
+            {
+                const Meshlet &cluster = clusters[info.firstCluster + c];
+
+                CullObjectGPU &co = input[written++];
+                co.sphere = cluster.sphere;
+                co.indexCount = cluster.indexCount;
+                co.firstIndex = cluster.firstIndex;
+                co.vertexOffset = info.vertexOffset;
+                co.objectIndex = i;
+                co.cone = cluster.cone;
+            }
+        }
+
+        for (uint32_t b = 1; b < DRAW_BUCKET_COUNT; ++b)
+        {
+            data.buckets[b].first = data.buckets[b - 1].first + data.buckets[b - 1].count;
+        }
+
+        data.inputOffset = span.offset;
+        data.objectCount = written;
+    }
+
+    void CullPass::record(VkCommandBuffer cmd, FrameSlot slot, const FrameContext &frame)
+    {
+        const SlotData &data = m_slots[slot];
+
+        // Reset the draw count (also when nothing is culled, so the draw sees zero)
+        vkCmdFillBuffer(cmd, data.output->handle(), 0, kCountBytes, 0);
+
+        VkMemoryBarrier2 clearToCompute{};
+        clearToCompute.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        clearToCompute.srcStageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+        clearToCompute.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        clearToCompute.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        clearToCompute.dstAccessMask =
+            VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+        VkDependencyInfo dep{};
+        dep.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dep.memoryBarrierCount = 1;
+        dep.pMemoryBarriers = &clearToCompute;
+
+        vkCmdPipelineBarrier2(cmd, &dep);
+
+        if (data.objectCount != 0)
+        {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline->handle());
+
+            const uint32_t *frameOffsets = frame.dynamic_offsets();
+            const std::array<uint32_t, 3> offsets{frameOffsets[0],
+                                                  frameOffsets[1],
+                                                  static_cast<uint32_t>(data.inputOffset)};
+
+            vkCmdBindDescriptorSets(cmd,
+                                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                                    m_layout,
+                                    0,
+                                    1,
+                                    &data.set,
+                                    static_cast<uint32_t>(offsets.size()),
+                                    offsets.data());
+
+            CullPC pc{data.objectCount, m_draw_indirect_count ? 1u : 0u, {}};
+            for (uint32_t b = 0; b < DRAW_BUCKET_COUNT; ++b)
+            {
+                pc.bucketFirst[b] = data.buckets[b].first;
+            }
+
+            vkCmdPushConstants(cmd,
+                               m_layout,
+                               VK_SHADER_STAGE_COMPUTE_BIT,
+                               0,
+                               sizeof(CullPC),
+                               &pc);
+
+            vkCmdDispatch(cmd, (data.objectCount + kWorkgroupSize - 1) / kWorkgroupSize, 1, 1);
+        }
+
+        VkMemoryBarrier2 computeToDraw{};
+        computeToDraw.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        computeToDraw.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        computeToDraw.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        computeToDraw.dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+        computeToDraw.dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+
+        dep.pMemoryBarriers = &computeToDraw;
+
+        vkCmdPipelineBarrier2(cmd, &dep);
+    }
+
+    IndirectDrawList CullPass::draw_list(FrameSlot slot) const
+    {
+        const SlotData &data = m_slots[slot];
+
+        IndirectDrawList list{};
+        list.buffer = data.output->handle();
+        list.commandsOffset = kCommandsOffset;
+        list.countOffset = 0;
+        list.maxDraws = data.objectCount;
+        list.hasCount = m_draw_indirect_count;
+        list.buckets = data.buckets;
+        return list;
+    }
+
+} // namespace ankh
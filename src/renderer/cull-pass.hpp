@@ -0,0 +1,119 @@
+// src/renderer/cull-pass.hpp
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "renderer/draw-packet.hpp"
+#include "renderer/mesh-draw-info.hpp"
+#include "scene/renderable-store.hpp"
+#include "sync/frame-ring.hpp"
+#include "utils/types.hpp"
+#include <vk_mem_alloc.h>
+
+namespace ankh
+{
+    class Buffer;
+    class ComputePipeline;
+    class FrameAllocator;
+    class FrameContext;
+
+    // Draw commands produced on the GPU, consumed by DrawPass
+    struct IndirectDrawList
+    {
+        // Commands [first, first + count) share one draw bucket's pipeline and index buffer
+        struct Range
+        {
+            uint32_t first{0};
+            uint32_t count{0};
+        };
+
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VkDeviceSize commandsOffset{0};
+        VkDeviceSize countOffset{0}; // one uint32_t draw count per draw bucket
+        uint32_t maxDraws{0};
+        bool hasCount{false}; // draw with vkCmdDrawIndexedIndirectCount (count at countOffset)
+        std::array<Range, DRAW_BUCKET_COUNT> buckets{};
+    };
+
+    // Compute frustum and cluster culling (shaders/cull.comp).
+    // Per frame the CPU writes one CullObjectGPU per object into a FrameAllocator span, or
+    // one per meshlet cluster for objects whose mesh has them (see Mesh::meshlets); the
+    // compute shader tests the transformed bounding sphere against FrameUBO's frustum
+    // planes, and clusters also against their backface cone, and compacts the survivors
+    // into a device-local indirect command buffer owned by the frame slot, plus a draw
+    // count. Large meshes thus only rasterize their visible clusters.
+    class CullPass
+    {
+      public:
+        // 'frame_buffer' is the FrameAllocator buffer; bindings 0/1 mirror the graphics set
+        // (FrameUBO at slice offset 0, instance object ids at 'instance_base').
+        // 'object_buffer' is the persistent ObjectBuffer the model matrices are read from.
+        // Up to 'max_objects' + 'max_cluster_draws' commands are culled per frame; objects
+        // whose clusters no longer fit are culled whole.
+        CullPass(VkDevice device,
+                 VmaAllocator allocator,
+                 uint32_t frames_in_flight,
+                 uint32_t max_objects,
+                 uint32_t max_cluster_draws,
+                 VkBuffer frame_buffer,
+                 VkDeviceSize instance_base,
+                 VkDeviceSize instance_range,
+                 VkBuffer object_buffer,
+                 VkDeviceSize object_buffer_size,
+                 bool draw_indirect_count);
+
+        ~CullPass();
+
+        CullPass(const CullPass &) = delete;
+        CullPass &operator=(const CullPass &) = delete;
+
+        // Write this frame's cull input for the first 'count' entries of 'visible'.
+        // Instance slot i is renderables[visible[i]], drawn with level of detail lods[i]
+        // (0 when 'lods' is shorter). Objects are culled (and drawn) one command each, or
+        // one per cluster at level 0 ('clusters' is GpuMeshPool::cluster_table);
+        // DrawBatcher's instancing applies to the CPU-built draw paths. 'visible' must be
+        // grouped by draw bucket in ascending order (DrawBatcher::order is), so each
+        // bucket's commands land in one range of the output.
+        void prepare(FrameSlot slot,
+                     FrameAllocator &frame_allocator,
+                     const RenderableStore &renderables,
+                     const std::vector<uint32_t> &visible,
+                     const std::vector<uint8_t> &lods,
+                     uint32_t count,
+                     const std::vector<MeshDrawInfo> &draw_table,
+                     const std::vector<Meshlet> &clusters);
+
+        // Must be recorded outside a render pass, before the draw that consumes draw_list().
+        void record(VkCommandBuffer cmd, FrameSlot slot, const FrameContext &frame);
+
+        IndirectDrawList draw_list(FrameSlot slot) const;
+
+      private:
+        // Count lives at offset 0; commands start at the next storage-offset-safe boundary
+        static constexpr VkDeviceSize kCommandsOffset = 256;
+
+        struct SlotData
+        {
+            std::unique_ptr<Buffer> output;
+            VkDescriptorSet set{VK_NULL_HANDLE};
+            VkDeviceSize inputOffset{0};
+            uint32_t objectCount{0};
+            std::array<IndirectDrawList::Range, DRAW_BUCKET_COUNT> buckets{};
+        };
+
+        VkDevice m_device{VK_NULL_HANDLE};
+        uint32_t m_max_objects{0};
+        uint32_t m_max_draws{0}; // objects + cluster draws
+        bool m_draw_indirect_count{false};
+
+        VkDescriptorSetLayout m_set_layout{VK_NULL_HANDLE};
+        VkDescriptorPool m_pool{VK_NULL_HANDLE};
+        VkPipelineLayout m_layout{VK_NULL_HANDLE};
+        std::unique_ptr<ComputePipeline> m_pipeline;
+
+        std::vector<SlotData> m_slots;
+    };
+
+} // namespace ankh
@@ -0,0 +1,168 @@
+// src/renderer/draw-batcher.cpp
+#include "renderer/draw-batcher.hpp"
+
+#include "renderer/mesh-draw-info.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace ankh
+{
+
+    void DrawBatcher::build(const RenderableStore &renderables,
+                            const std::vector<uint32_t> &visible,
+                            const std::vector<uint8_t> &visible_lods,
+                            const std::vector<MeshDrawInfo> &draw_table,
+                            uint32_t max_objects,
+                            uint64_t scene_revision,
+                            uint64_t mesh_revision)
+    {
+        const uint32_t count = static_cast<uint32_t>(visible.size());
+        const bool hasLods = visible_lods.size() == visible.size();
+
+        const bool unchanged = m_built && scene_revision == m_last_scene_revision &&
+                               mesh_revision == m_last_mesh_revision &&
+                               count == m_last_visible.size() &&
+                               (count == 0 || std::memcmp(visible.data(),
+                                                          m_last_visible.data(),
+                                                          sizeof(uint32_t) * count) == 0) &&
+                               (hasLods ? visible_lods == m_last_lods : m_last_lods.empty());
+
+        if (unchanged)
+        {
+            m_packets_rebuilt = 0;
+            return;
+        }
+
+        m_last_visible.assign(visible.begin(), visible.end());
+        if (hasLods)
+        {
+            m_last_lods.assign(visible_lods.begin(), visible_lods.end());
+        }
+        else
+        {
+            m_last_lods.clear();
+        }
+        m_last_scene_revision = scene_revision;
+        m_last_mesh_revision = mesh_revision;
+        m_built = true;
+
+        m_keys.clear();
+        m_order.clear();
+
+        m_keys.reserve(count);
+        m_order.reserve(count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (visible[i] >= max_objects)
+            {
+                continue; // no object record to draw it with
+            }
+
+            const MeshHandle mesh = renderables.mesh(visible[i]);
+
+            if (mesh >= draw_table.size() || draw_table[mesh].indexCount == 0)
+            {
+                continue; // nothing to draw for this mesh
+            }
+
+            // Levels past the mesh's coarsest one share its key (and packet)
+            const uint32_t lod =
+                std::min(hasLods ? visible_lods[i] : 0u, draw_table[mesh].lodCount - 1);
+
+            // Pipeline variant and index buffer the mesh is drawn with
+            const uint32_t bucket =
+                draw_bucket(draw_table[mesh].vertexFormat, draw_table[mesh].indexWidth);
+
+            m_keys.push_back(sort_key(bucket, renderables.material(visible[i]), mesh, lod));
+            m_order.push_back(visible[i]);
+        }
+
+        radix_sort();
+        compile_packets(draw_table);
+
+        m_packets_rebuilt = static_cast<uint32_t>(m_packets.size());
+    }
+
+    void DrawBatcher::compile_packets(const std::vector<MeshDrawInfo> &draw_table)
+    {
+        m_packets.clear();
+        m_lods.resize(m_keys.size());
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_keys.size()); ++i)
+        {
+            const uint32_t lod = static_cast<uint32_t>(m_keys[i] & 0xFu);
+            m_lods[i] = static_cast<uint8_t>(lod);
+
+            if (i == 0 || m_keys[i] != m_keys[i - 1])
+            {
+                const MeshDrawInfo &info = draw_table[static_cast<MeshHandle>(m_keys[i] >> 4)];
+                const MeshLodRange &range = info.lods[lod];
+
+                DrawPacket &p = m_packets.emplace_back();
+                p.indexCount = range.indexCount;
+                p.firstIndex = range.firstIndex;
+                p.vertexOffset = info.vertexOffset;
+                p.firstObject = i;
+                p.state = static_cast<uint32_t>(m_keys[i] >> 36);
+            }
+
+            ++m_packets.back().objectCount;
+        }
+    }
+
+    void DrawBatcher::radix_sort()
+    {
+        const size_t n = m_keys.size();
+        if (n < 2)
+        {
+            return;
+        }
+
+        m_keys_tmp.resize(n);
+        m_order_tmp.resize(n);
+
+        // Bits that differ between any two keys; passes over constant bytes are skipped,
+        // so a scene with few materials and meshes sorts in one or two passes.
+        uint64_t varying = 0;
+        for (size_t i = 1; i < n; ++i)
+        {
+            varying |= m_keys[i] ^ m_keys[0];
+        }
+
+        for (uint32_t shift = 0; shift < 64; shift += 8)
+        {
+            if (((varying >> shift) & 0xFFu) == 0)
+            {
+                continue;
+            }
+
+            std::array<uint32_t, 256> offsets{};
+            for (uint64_t key : m_keys)
+            {
+                ++offsets[(key >> shift) & 0xFFu];
+            }
+
+            uint32_t sum = 0;
+            for (uint32_t &o : offsets)
+            {
+                const uint32_t c = o;
+                o = sum;
+                sum += c;
+            }
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                const uint32_t dst = offsets[(m_keys[i] >> shift) & 0xFFu]++;
+                m_keys_tmp[dst] = m_keys[i];
+                m_order_tmp[dst] = m_order[i];
+            }
+
+            m_keys.swap(m_keys_tmp);
+            m_order.swap(m_order_tmp);
+        }
+    }
+
+} // namespace ankh
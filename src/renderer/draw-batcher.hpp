@@ -0,0 +1,106 @@
+// src/renderer/draw-batcher.hpp
+#pragma once
+
+#include "renderer/draw-packet.hpp"
+#include "scene/renderable-store.hpp"
+#include "scene/renderable.hpp"
+#include "utils/types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ankh
+{
+    struct MeshDrawInfo;
+
+    // Batching stage between SceneRenderer (visible list) and DrawPass.
+    // Visible renderables are sorted by a packed (bucket, material, mesh, lod) key with an
+    // LSD radix sort, and each run of equal keys is compiled into one DrawPacket. The sort
+    // is stable, so objects inside a packet keep their scene order.
+    // Packets only depend on the visible list and its levels of detail, the renderables'
+    // handles and the mesh ranges, so they are rebuilt only when one of those changes;
+    // transforms don't matter.
+    class DrawBatcher
+    {
+      public:
+        // Key layout, most significant first: draw bucket (4 bits), material (24),
+        // mesh (32), lod (4)
+        static uint64_t sort_key(uint32_t bucket,
+                                 MaterialHandle material,
+                                 MeshHandle mesh,
+                                 uint32_t lod = 0)
+        {
+            return (static_cast<uint64_t>(bucket & 0xFu) << 60) |
+                   (static_cast<uint64_t>(material & 0xFFFFFFu) << 36) |
+                   (static_cast<uint64_t>(mesh) << 4) | static_cast<uint64_t>(lod & 0xFu);
+        }
+
+        // Batch the entries of 'visible' (indices into renderables), drawing entry i with
+        // level 'visible_lods[i]' (0 for all when empty). Renderables with an index >=
+        // 'max_objects' (no ObjectBuffer record) or whose mesh has no GPU range in
+        // 'draw_table' are dropped.
+        // 'scene_revision' / 'mesh_revision' identify the renderables and draw_table
+        // contents (SceneRenderer::revision, GpuMeshPool::revision); when they and the
+        // visible list match the previous call, the packets are reused as-is.
+        void build(const RenderableStore &renderables,
+                   const std::vector<uint32_t> &visible,
+                   const std::vector<uint8_t> &visible_lods,
+                   const std::vector<MeshDrawInfo> &draw_table,
+                   uint32_t max_objects,
+                   uint64_t scene_revision,
+                   uint64_t mesh_revision);
+
+        // Instance slot i draws renderables[order()[i]]. Slots are grouped by draw bucket
+        // (the mesh's VertexFormat and IndexWidth, see draw_bucket), in ascending order.
+        const std::vector<uint32_t> &order() const
+        {
+            return m_order;
+        }
+
+        // Level of detail drawn for each instance slot (clamped to the mesh's levels)
+        const std::vector<uint8_t> &lods() const
+        {
+            return m_lods;
+        }
+
+        uint32_t object_count() const
+        {
+            return static_cast<uint32_t>(m_order.size());
+        }
+
+        const std::vector<DrawPacket> &packets() const
+        {
+            return m_packets;
+        }
+
+        // Packets compiled by the last build() (0 when the previous ones were reused)
+        uint32_t packets_rebuilt() const
+        {
+            return m_packets_rebuilt;
+        }
+
+      private:
+        void radix_sort();
+        void compile_packets(const std::vector<MeshDrawInfo> &draw_table);
+
+      private:
+        std::vector<uint64_t> m_keys;
+        std::vector<uint32_t> m_order;
+        std::vector<uint8_t> m_lods;
+
+        // Ping-pong buffers reused across frames
+        std::vector<uint64_t> m_keys_tmp;
+        std::vector<uint32_t> m_order_tmp;
+
+        std::vector<DrawPacket> m_packets;
+        uint32_t m_packets_rebuilt{0};
+
+        // Inputs of the last rebuild
+        std::vector<uint32_t> m_last_visible;
+        std::vector<uint8_t> m_last_lods;
+        uint64_t m_last_scene_revision{0};
+        uint64_t m_last_mesh_revision{0};
+        bool m_built{false};
+    };
+
+} // namespace ankh
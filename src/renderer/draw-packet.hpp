@@ -0,0 +1,73 @@
+// src/renderer/draw-packet.hpp
+#pragma once
+
+#include "utils/types.hpp"
+#include "utils/vertex-format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ankh
+{
+    // Draws that share a pipeline variant and an index buffer: the vertex formats of
+    // 16-bit indexed meshes, then those of 32-bit ones. DrawBatcher groups packets and
+    // CullPass groups commands by bucket, in ascending order.
+    inline constexpr uint32_t DRAW_BUCKET_COUNT = VERTEX_FORMAT_COUNT * INDEX_WIDTH_COUNT;
+
+    inline uint32_t draw_bucket(VertexFormat format, IndexWidth width)
+    {
+        return static_cast<uint32_t>(width) * VERTEX_FORMAT_COUNT + static_cast<uint32_t>(format);
+    }
+
+    inline VertexFormat bucket_vertex_format(uint32_t bucket)
+    {
+        return static_cast<VertexFormat>(bucket % VERTEX_FORMAT_COUNT);
+    }
+
+    inline IndexWidth bucket_index_width(uint32_t bucket)
+    {
+        return static_cast<IndexWidth>(bucket / VERTEX_FORMAT_COUNT);
+    }
+
+    // One precompiled instanced draw. The first five fields match
+    // VkDrawIndexedIndirectCommand, so a packet array can be copied straight into an
+    // indirect buffer and drawn with stride sizeof(DrawPacket).
+    struct DrawPacket
+    {
+        uint32_t indexCount{0};
+        uint32_t objectCount{0}; // instanceCount
+        uint32_t firstIndex{0};
+        int32_t vertexOffset{0};
+        uint32_t firstObject{0}; // firstInstance: object buffer slot of instance 0
+        uint32_t state{0};       // bucket (4 bits) | material (24 bits), see DrawBatcher
+
+        // Draw bucket: GraphicsPipeline variant and index buffer to draw with
+        uint32_t bucket() const
+        {
+            return state >> 24;
+        }
+
+        VertexFormat vertex_format() const
+        {
+            return bucket_vertex_format(bucket());
+        }
+
+        IndexWidth index_width() const
+        {
+            return bucket_index_width(bucket());
+        }
+    };
+
+    static_assert(offsetof(DrawPacket, indexCount) ==
+                  offsetof(VkDrawIndexedIndirectCommand, indexCount));
+    static_assert(offsetof(DrawPacket, objectCount) ==
+                  offsetof(VkDrawIndexedIndirectCommand, instanceCount));
+    static_assert(offsetof(DrawPacket, firstIndex) ==
+                  offsetof(VkDrawIndexedIndirectCommand, firstIndex));
+    static_assert(offsetof(DrawPacket, vertexOffset) ==
+                  offsetof(VkDrawIndexedIndirectCommand, vertexOffset));
+    static_assert(offsetof(DrawPacket, firstObject) ==
+                  offsetof(VkDrawIndexedIndirectCommand, firstInstance));
+    static_assert(sizeof(DrawPacket) % 4 == 0);
+
+} // namespace ankh
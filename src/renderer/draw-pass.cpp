@@ -2,27 +2,29 @@
 #include "renderer/draw-pass.hpp"
 
 #include <algorithm>
+#include <cstring>
 
+#include "frame/frame-allocator.hpp"
+#include "renderer/cull-pass.hpp"
+#include "renderer/draw-batcher.hpp"
 #include "frame/frame-context.hpp"
 #include "pipeline/graphics-pipeline.hpp"
 #include "pipeline/pipeline-layout.hpp"
-#include "renderer/scene-renderer.hpp"
 #include "renderpass/render-pass.hpp"
-#include "swapchain/swapchain.hpp"
 
 namespace ankh
 {
 
     DrawPass::DrawPass(VkDevice device,
-                       const Swapchain &swapchain,
                        const RenderPass &render_pass,
                        const GraphicsPipeline &pipeline,
-                       const PipelineLayout &layout)
+                       const PipelineLayout &layout,
+                       bool indirect)
         : m_device(device)
-        , m_swapchain(swapchain)
         , m_render_pass(render_pass)
         , m_pipeline(pipeline)
         , m_layout(layout)
+        , m_indirect(indirect)
     {
     }
 
@@ -30,20 +32,146 @@ namespace ankh
                           FrameContext &frame,
                           uint32_t /*image_index*/,
                           VkBuffer vertex_buffer,
-                          VkBuffer index_buffer,
-                          const std::unordered_map<MeshHandle, MeshDrawInfo> &mesh_draw_info,
-                          SceneRenderer &scene_renderer)
+                          const IndexBuffers &index_buffers,
+                          const DrawBatcher &batcher,
+                          FrameAllocator &frame_allocator,
+                          const IndirectDrawList *gpu_draws)
     {
-        if (vertex_buffer == VK_NULL_HANDLE || index_buffer == VK_NULL_HANDLE)
+        if (vertex_buffer == VK_NULL_HANDLE)
         {
             return;
         }
 
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline.handle());
+        bind(cmd, frame, vertex_buffer);
 
+        // multiDrawIndirect guarantees maxDrawIndirectCount >= 2^16 - 1
+        constexpr uint32_t kMaxDrawsPerCall = 65535;
+
+        if (m_indirect && gpu_draws != nullptr)
+        {
+            // One pipeline and index buffer per bucket, each over its own range of commands
+            for (uint32_t b = 0; b < DRAW_BUCKET_COUNT; ++b)
+            {
+                const IndirectDrawList::Range &range = gpu_draws->buckets[b];
+                if (range.count == 0)
+                {
+                    continue;
+                }
+
+                bind_bucket(cmd, index_buffers, b);
+
+                const VkDeviceSize commands =
+                    gpu_draws->commandsOffset + range.first * sizeof(VkDrawIndexedIndirectCommand);
+
+                if (gpu_draws->hasCount)
+                {
+                    vkCmdDrawIndexedIndirectCount(cmd,
+                                                  gpu_draws->buffer,
+                                                  commands,
+                                                  gpu_draws->buffer,
+                                                  gpu_draws->countOffset + sizeof(uint32_t) * b,
+                                                  range.count,
+                                                  sizeof(VkDrawIndexedIndirectCommand));
+                    continue;
+                }
+
+                for (uint32_t first = 0; first < range.count; first += kMaxDrawsPerCall)
+                {
+                    const uint32_t n = std::min(kMaxDrawsPerCall, range.count - first);
+
+                    const VkDeviceSize offset =
+                        commands + first * sizeof(VkDrawIndexedIndirectCommand);
+
+                    vkCmdDrawIndexedIndirect(cmd,
+                                             gpu_draws->buffer,
+                                             offset,
+                                             n,
+                                             sizeof(VkDrawIndexedIndirectCommand));
+                }
+            }
+            return;
+        }
+
+        const auto &packets = batcher.packets();
+        const uint32_t count = static_cast<uint32_t>(packets.size());
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (!m_indirect)
+        {
+            draw_direct(cmd, index_buffers, packets, 0, count);
+            return;
+        }
+
+        // Packets are laid out as indirect commands already: one memcpy, then draw them with
+        // a packet-sized stride
+        auto span = frame_allocator.alloc("DrawIndirect",
+                                          sizeof(DrawPacket) * count,
+                                          alignof(DrawPacket));
+
+        if (span.cpu == nullptr)
+        {
+            return; // FrameAllocator overflow (already reported)
+        }
+
+        std::memcpy(span.cpu, packets.data(), sizeof(DrawPacket) * count);
+
+        // Packets are sorted by draw bucket: one run of indirect draws per bucket
+        for (uint32_t run = 0; run < count;)
+        {
+            const uint32_t bucket = packets[run].bucket();
+
+            uint32_t end = run + 1;
+            while (end < count && packets[end].bucket() == bucket)
+            {
+                ++end;
+            }
+
+            bind_bucket(cmd, index_buffers, bucket);
+
+            for (uint32_t first = run; first < end; first += kMaxDrawsPerCall)
+            {
+                const uint32_t n = std::min(kMaxDrawsPerCall, end - first);
+
+                vkCmdDrawIndexedIndirect(cmd,
+                                         span.buffer,
+                                         span.offset + first * sizeof(DrawPacket),
+                                         n,
+                                         sizeof(DrawPacket));
+            }
+
+            run = end;
+        }
+    }
+
+    void DrawPass::record_range(VkCommandBuffer cmd,
+                                const FrameContext &frame,
+                                VkBuffer vertex_buffer,
+                                const IndexBuffers &index_buffers,
+                                const DrawBatcher &batcher,
+                                uint32_t first,
+                                uint32_t count) const
+    {
+        if (vertex_buffer == VK_NULL_HANDLE || count == 0)
+        {
+            return;
+        }
+
+        bind(cmd, frame, vertex_buffer);
+        draw_direct(cmd, index_buffers, batcher.packets(), first, first + count);
+    }
+
+    void DrawPass::bind(VkCommandBuffer cmd,
+                        const FrameContext &frame,
+                        VkBuffer vertex_buffer) const
+    {
+        // Pipelines and index buffers are bound per draw bucket by the draw loops; the
+        // variants share the layout, so the set stays bound across them
         VkDeviceSize offsets[] = {0};
         vkCmdBindVertexBuffers(cmd, 0, 1, &vertex_buffer, offsets);
-        vkCmdBindIndexBuffer(cmd, index_buffer, 0, VK_INDEX_TYPE_UINT16);
 
         VkDescriptorSet set = frame.descriptor_set();
         vkCmdBindDescriptorSets(cmd,
@@ -54,39 +182,45 @@ namespace ankh
                                 &set,
                                 frame.dynamic_offset_count(),
                                 frame.dynamic_offsets());
+    }
 
-        const auto &renderables = scene_renderer.renderables();
-        const uint32_t capacity = frame.object_capacity();
-        const uint32_t count =
-            std::min<uint32_t>(static_cast<uint32_t>(renderables.size()), capacity);
+    void DrawPass::bind_bucket(VkCommandBuffer cmd,
+                               const IndexBuffers &index_buffers,
+                               uint32_t bucket) const
+    {
+        const IndexWidth width = bucket_index_width(bucket);
+
+        vkCmdBindPipeline(cmd,
+                          VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          m_pipeline.handle(bucket_vertex_format(bucket)));
+        vkCmdBindIndexBuffer(cmd,
+                             index_buffers[static_cast<uint32_t>(width)],
+                             0,
+                             vk_index_type(width));
+    }
 
-        for (uint32_t i = 0; i < count; ++i)
+    void DrawPass::draw_direct(VkCommandBuffer cmd,
+                               const IndexBuffers &index_buffers,
+                               const std::vector<DrawPacket> &packets,
+                               uint32_t first,
+                               uint32_t end) const
+    {
+        for (uint32_t i = first; i < end; ++i)
         {
-            MeshHandle meshHandle = renderables[i].mesh;
-
-            auto it = mesh_draw_info.find(meshHandle);
+            const DrawPacket &p = packets[i];
 
-            if (it == mesh_draw_info.end())
+            if (i == first || p.bucket() != packets[i - 1].bucket())
             {
-                // Mesh has no GPU range; skip (should not happen in normal cases)
-                continue;
+                bind_bucket(cmd, index_buffers, p.bucket());
             }
 
-            const MeshDrawInfo &info = it->second;
-
-            struct ObjectPC
-            {
-                uint32_t objectIndex;
-            } pc{i};
-
-            vkCmdPushConstants(cmd,
-                               m_layout.handle(),
-                               VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                               0,
-                               sizeof(ObjectPC),
-                               &pc);
-
-            vkCmdDrawIndexed(cmd, info.indexCount, 1, info.firstIndex, info.vertexOffset, 0);
+            // Instance j of the packet is object firstObject + j (gl_InstanceIndex)
+            vkCmdDrawIndexed(cmd,
+                             p.indexCount,
+                             p.objectCount,
+                             p.firstIndex,
+                             p.vertexOffset,
+                             p.firstObject);
         }
     }
 
@@ -1,48 +1,91 @@
 // src/renderer/draw-pass.hpp
 #pragma once
 
-#include <unordered_map>
+#include <vector>
 
+#include "renderer/draw-packet.hpp"
 #include "renderer/mesh-draw-info.hpp"
 #include "scene/renderable.hpp"
 #include "utils/types.hpp"
+#include "utils/vertex-format.hpp"
 
 namespace ankh
 {
-    class Swapchain;
     class RenderPass;
     class GraphicsPipeline;
     class PipelineLayout;
     class FrameContext;
-    class SceneRenderer;
+    class FrameAllocator;
+    class DrawBatcher;
+    struct IndirectDrawList;
 
     class DrawPass
     {
       public:
+        // 'indirect': copy the DrawBatcher packets into a FrameAllocator span and draw them
+        // with one vkCmdDrawIndexedIndirect per draw bucket (pipeline variant and index
+        // buffer). Requires the multiDrawIndirect and drawIndirectFirstInstance features;
+        // otherwise one vkCmdDrawIndexed per packet.
+        // Either way each DrawPacket is one instanced draw and the object index reaches the
+        // shader as gl_InstanceIndex (firstInstance = packet.firstObject).
         DrawPass(VkDevice device,
-                 const Swapchain &swapchain,
                  const RenderPass &render_pass,
                  const GraphicsPipeline &pipeline,
-                 const PipelineLayout &layout);
+                 const PipelineLayout &layout,
+                 bool indirect);
+
+        bool indirect() const
+        {
+            return m_indirect;
+        }
 
         // Assumes:
         //  - command buffer is already begun
         //  - render pass is already active
         //  - viewport/scissor already set
+        // 'gpu_draws' (indirect mode only): draw commands already built on the GPU
+        // (CullPass) instead of one per renderable from the CPU.
         void record(VkCommandBuffer cmd,
                     FrameContext &frame,
                     uint32_t image_index,
                     VkBuffer vertex_buffer,
-                    VkBuffer index_buffer,
-                    const std::unordered_map<MeshHandle, MeshDrawInfo> &mesh_draw_info,
-                    SceneRenderer &scene_renderer);
+                    const IndexBuffers &index_buffers,
+                    const DrawBatcher &batcher,
+                    FrameAllocator &frame_allocator,
+                    const IndirectDrawList *gpu_draws = nullptr);
+
+        // Direct draws for packets [first, first + count) into a command buffer that is
+        // already inside the render pass (typically a secondary with viewport/scissor set).
+        // Binds its own state; ranges may be recorded concurrently on different command
+        // buffers.
+        void record_range(VkCommandBuffer cmd,
+                          const FrameContext &frame,
+                          VkBuffer vertex_buffer,
+                          const IndexBuffers &index_buffers,
+                          const DrawBatcher &batcher,
+                          uint32_t first,
+                          uint32_t count) const;
+
+      private:
+        void bind(VkCommandBuffer cmd, const FrameContext &frame, VkBuffer vertex_buffer) const;
+
+        // Pipeline variant and index buffer of a draw bucket
+        void bind_bucket(VkCommandBuffer cmd,
+                         const IndexBuffers &index_buffers,
+                         uint32_t bucket) const;
+
+        void draw_direct(VkCommandBuffer cmd,
+                         const IndexBuffers &index_buffers,
+                         const std::vector<DrawPacket> &packets,
+                         uint32_t first,
+                         uint32_t end) const;
 
       private:
         VkDevice m_device{VK_NULL_HANDLE};
-        const Swapchain &m_swapchain;
         const RenderPass &m_render_pass;
         const GraphicsPipeline &m_pipeline;
         const PipelineLayout &m_layout;
+        bool m_indirect{false};
     };
 
 } // namespace ankh
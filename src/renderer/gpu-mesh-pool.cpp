@@ -1,8 +1,10 @@
 // src/renderer/gpu-mesh-pool.cpp
 #include "renderer/gpu-mesh-pool.hpp"
+#include "jobs/job-system.hpp"
 #include "streaming/async-uploader.hpp"
 
 #include <cstring>
+#include <utils/config.hpp>
 #include <utils/logging.hpp>
 
 namespace ankh
@@ -19,50 +21,120 @@ namespace ankh
     {
     }
 
-    void GpuMeshPool::build_from_mesh_pool(const MeshPool &mesh_pool)
+    void GpuMeshPool::build_from_mesh_pool(const MeshPool &mesh_pool, JobSystem *jobs)
     {
-        std::vector<Vertex> allVertices;
-        std::vector<uint16_t> allIndices;
-        allVertices.reserve(1024);
-        allIndices.reserve(1024);
+        // Layout first, then every mesh writes its vertices and indices straight into the
+        // mapped staging buffers: encoded from Mesh::vertices(), or copied as is from
+        // pre-encoded (cooked) geometry, with no intermediate arrays
+        struct Placement
+        {
+            const Mesh *mesh{nullptr};
+            MeshDrawInfo info{};
+        };
+
+        std::vector<Placement> placements;
+
+        const bool compact = ankh::config().compactVertices;
+        VkDeviceSize vertexBufferSize = 0;
+        std::array<uint32_t, INDEX_WIDTH_COUNT> indexCounts{};
+        size_t vertexCount = 0;
 
         m_draw_info.clear();
+        m_draw_table.clear();
+        m_cluster_table.clear();
+        ++m_revision;
 
         const auto handles = mesh_pool.handles();
+        placements.reserve(handles.size());
 
         for (MeshHandle h : handles)
         {
             const Mesh &mesh = mesh_pool.get(h);
-
-            const auto &verts = mesh.vertices();
-            const auto &indices = mesh.indices();
+            const EncodedMeshData *encoded = mesh.encoded();
+
+            // Cooked geometry stays in the format it was cooked with
+            const VertexFormat format = encoded  ? encoded->format
+                                        : compact ? mesh.vertex_format()
+                                                  : VertexFormat::Float;
+            const VkDeviceSize stride = vertex_stride(format);
+            const VkDeviceSize base = (vertexBufferSize + stride - 1) / stride * stride;
+            const size_t verts = encoded ? encoded->vertexCount : mesh.vertex_count();
+
+            // Indices are relative to the mesh's first vertex (vertexOffset), so meshes of
+            // up to 65536 vertices go to the 16-bit buffer wherever they land
+            const IndexWidth width = mesh.index_width();
+            const auto append = [&](uint32_t count)
+            {
+                uint32_t &end = indexCounts[static_cast<uint32_t>(width)];
+                const MeshLodRange range{end, count};
+                end += count;
+                return range;
+            };
 
             MeshDrawInfo info{};
-            info.firstIndex = static_cast<uint32_t>(allIndices.size());
-            info.indexCount = static_cast<uint32_t>(indices.size());
-            info.vertexOffset = static_cast<int32_t>(allVertices.size());
-
-            allVertices.insert(allVertices.end(), verts.begin(), verts.end());
-            allIndices.insert(allIndices.end(), indices.begin(), indices.end());
+            info.lods[0] = append(encoded ? encoded->indexCounts[0]
+                                          : static_cast<uint32_t>(mesh.index_count()));
+            info.firstIndex = info.lods[0].firstIndex;
+            info.indexCount = info.lods[0].indexCount;
+            info.vertexOffset = static_cast<int32_t>(base / stride);
+            info.vertexFormat = format;
+            info.indexWidth = width;
+
+            info.boundingSphere = mesh.bounds().sphere;
+
+            vertexBufferSize = base + stride * verts;
+            vertexCount += verts;
+
+            info.firstCluster = static_cast<uint32_t>(m_cluster_table.size());
+            info.clusterCount = static_cast<uint32_t>(mesh.meshlets().size());
+            for (Meshlet cluster : mesh.meshlets())
+            {
+                cluster.firstIndex += info.firstIndex;
+                m_cluster_table.push_back(cluster);
+            }
+
+            // Simplified levels reuse the vertices: only their indices are appended
+            for (uint32_t level = 1; level <= mesh.lods().size(); ++level)
+            {
+                info.lods[info.lodCount++] =
+                    append(encoded ? encoded->indexCounts[level]
+                                   : static_cast<uint32_t>(mesh.lods()[level - 1].indices.size()));
+            }
 
             m_draw_info[h] = info;
+
+            if (h >= m_draw_table.size())
+            {
+                m_draw_table.resize(static_cast<size_t>(h) + 1);
+            }
+            m_draw_table[h] = info;
+
+            placements.push_back(Placement{&mesh, info});
         }
 
-        if (allVertices.empty() || allIndices.empty())
+        if (vertexBufferSize == 0 || (indexCounts[0] == 0 && indexCounts[1] == 0))
         {
             ANKH_LOG_WARN("[GpuMeshPool] BuildFromMeshPool: no mesh data to upload.");
             m_vertex_buffer.reset();
-            m_index_buffer.reset();
+            m_index_buffers = {};
+            m_vertex_bytes = 0;
+            m_index_bytes = 0;
             return;
         }
 
-        VkDeviceSize vertexBufferSize = sizeof(Vertex) * allVertices.size();
-        VkDeviceSize indexBufferSize = sizeof(uint16_t) * allIndices.size();
+        // Both widths share one staging buffer; the 32-bit part starts 4-byte aligned
+        const std::array<VkDeviceSize, INDEX_WIDTH_COUNT> indexSizes = {
+            sizeof(uint16_t) * VkDeviceSize{indexCounts[0]},
+            sizeof(uint32_t) * VkDeviceSize{indexCounts[1]},
+        };
+        const std::array<VkDeviceSize, INDEX_WIDTH_COUNT> stagingOffsets = {
+            0,
+            (indexSizes[0] + 3) & ~VkDeviceSize{3},
+        };
+        const VkDeviceSize indexStagingSize = stagingOffsets[1] + indexSizes[1];
 
         // -----------------------------
-        // Vertex staging + device-local buffer
-        // -----------------------------
-        // Vertex upload (staging -> GPU)
+        // Staging buffers, filled in place
         // -----------------------------
         Buffer vertexStaging(m_allocator,
                              m_device,
@@ -70,12 +142,91 @@ namespace ankh
                              VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                              VMA_MEMORY_USAGE_CPU_ONLY);
 
+        Buffer indexStaging(m_allocator,
+                            m_device,
+                            indexStagingSize,
+                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                            VMA_MEMORY_USAGE_CPU_ONLY);
+
+        auto *vertexDst = static_cast<uint8_t *>(vertexStaging.map());
+        auto *indexDst = static_cast<uint8_t *>(indexStaging.map());
+
+        const auto write_mesh = [&](const Placement &p)
+        {
+            const Mesh &mesh = *p.mesh;
+            const MeshDrawInfo &info = p.info;
+            const EncodedMeshData *encoded = mesh.encoded();
+
+            const size_t stride = vertex_stride(info.vertexFormat);
+            uint8_t *vertices = vertexDst + stride * static_cast<size_t>(info.vertexOffset);
+
+            const uint32_t w = static_cast<uint32_t>(info.indexWidth);
+            const size_t indexSize = index_size(info.indexWidth);
+            uint8_t *indices = indexDst + stagingOffsets[w];
+
+            if (encoded)
+            {
+                std::memcpy(vertices, encoded->vertices, stride * encoded->vertexCount);
+
+                for (uint32_t level = 0; level < info.lodCount; ++level)
+                {
+                    const MeshLodRange &range = info.lods[level];
+                    std::memcpy(indices + indexSize * range.firstIndex,
+                                encoded->indices[level],
+                                indexSize * range.indexCount);
+                }
+                return;
+            }
+
+            encode_vertices(info.vertexFormat,
+                            mesh.vertices().data(),
+                            mesh.vertex_count(),
+                            vertices);
+
+            for (uint32_t level = 0; level < info.lodCount; ++level)
+            {
+                const std::vector<uint32_t> &src =
+                    level == 0 ? mesh.indices() : mesh.lods()[level - 1].indices;
+                uint8_t *dst = indices + indexSize * info.lods[level].firstIndex;
+
+                if (info.indexWidth == IndexWidth::U32)
+                {
+                    std::memcpy(dst, src.data(), sizeof(uint32_t) * src.size());
+                    continue;
+                }
+
+                auto *dst16 = reinterpret_cast<uint16_t *>(dst);
+                for (size_t i = 0; i < src.size(); ++i)
+                {
+                    dst16[i] = static_cast<uint16_t>(src[i]);
+                }
+            }
+        };
+
+        if (jobs)
+        {
+            jobs->parallel_for(0,
+                               static_cast<uint32_t>(placements.size()),
+                               1,
+                               [&](uint32_t first, uint32_t last)
+                               {
+                                   for (uint32_t i = first; i < last; ++i)
+                                   {
+                                       write_mesh(placements[i]);
+                                   }
+                               });
+        }
+        else
         {
-            void *dst = vertexStaging.map();
-            std::memcpy(dst, allVertices.data(), static_cast<size_t>(vertexBufferSize));
-            vertexStaging.unmap();
+            for (const Placement &p : placements)
+            {
+                write_mesh(p);
+            }
         }
 
+        vertexStaging.unmap();
+        indexStaging.unmap();
+
         m_vertex_buffer = std::make_unique<Buffer>(m_allocator,
                                                    m_device,
                                                    vertexBufferSize,
@@ -83,42 +234,48 @@ namespace ankh
                                                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
                                                    VMA_MEMORY_USAGE_GPU_ONLY);
 
-        // -----------------------------
-        // Index upload (staging -> GPU)
-        // -----------------------------
-        Buffer indexStaging(m_allocator,
-                            m_device,
-                            indexBufferSize,
-                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                            VMA_MEMORY_USAGE_CPU_ONLY);
-
+        for (uint32_t w = 0; w < INDEX_WIDTH_COUNT; ++w)
         {
-            void *dst = indexStaging.map();
-            std::memcpy(dst, allIndices.data(), static_cast<size_t>(indexBufferSize));
-            indexStaging.unmap();
+            if (indexSizes[w] == 0)
+            {
+                m_index_buffers[w].reset();
+                continue;
+            }
+
+            m_index_buffers[w] = std::make_unique<Buffer>(m_allocator,
+                                                          m_device,
+                                                          indexSizes[w],
+                                                          VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                                                              VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                                          VMA_MEMORY_USAGE_GPU_ONLY);
         }
 
-        m_index_buffer = std::make_unique<Buffer>(m_allocator,
-                                                  m_device,
-                                                  indexBufferSize,
-                                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-                                                      VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                                                  VMA_MEMORY_USAGE_GPU_ONLY);
-
         m_async_uploader.begin();
 
         m_async_uploader.copy_buffer(vertexStaging.handle(),
                                      m_vertex_buffer->handle(),
                                      vertexBufferSize);
 
-        m_async_uploader.copy_buffer(indexStaging.handle(),
-                                     m_index_buffer->handle(),
-                                     indexBufferSize);
+        for (uint32_t w = 0; w < INDEX_WIDTH_COUNT; ++w)
+        {
+            if (m_index_buffers[w])
+            {
+                m_async_uploader.copy_buffer(indexStaging.handle(),
+                                             m_index_buffers[w]->handle(),
+                                             indexSizes[w],
+                                             stagingOffsets[w]);
+            }
+        }
 
         UploadTicket ticket = m_async_uploader.end_and_submit();
 
-        ANKH_LOG_DEBUG("[GpuMeshPool] Uploaded " + std::to_string(allVertices.size()) +
-                       " vertices, " + std::to_string(allIndices.size()) + " indices, " +
+        m_vertex_bytes = vertexBufferSize;
+        m_index_bytes = indexSizes[0] + indexSizes[1];
+
+        ANKH_LOG_DEBUG("[GpuMeshPool] Uploaded " + std::to_string(vertexCount) + " vertices (" +
+                       std::to_string(vertexBufferSize) + " bytes), " +
+                       std::to_string(indexCounts[0]) + " 16-bit and " +
+                       std::to_string(indexCounts[1]) + " 32-bit indices, " +
                        std::to_string(m_draw_info.size()) + " meshes.");
 
         if (m_retirement)
@@ -151,9 +308,12 @@ namespace ankh
             m_vertex_buffer->set_retirement(m_retirement, signal);
         }
 
-        if (m_index_buffer)
+        for (const auto &indexBuffer : m_index_buffers)
         {
-            m_index_buffer->set_retirement(m_retirement, signal);
+            if (indexBuffer)
+            {
+                indexBuffer->set_retirement(m_retirement, signal);
+            }
         }
     }
 
@@ -167,9 +327,15 @@ namespace ankh
         return m_vertex_buffer ? m_vertex_buffer->handle() : VK_NULL_HANDLE;
     }
 
-    VkBuffer GpuMeshPool::index_buffer() const noexcept
+    VkBuffer GpuMeshPool::index_buffer(IndexWidth width) const noexcept
+    {
+        const auto &buffer = m_index_buffers[static_cast<uint32_t>(width)];
+        return buffer ? buffer->handle() : VK_NULL_HANDLE;
+    }
+
+    IndexBuffers GpuMeshPool::index_buffers() const noexcept
     {
-        return m_index_buffer ? m_index_buffer->handle() : VK_NULL_HANDLE;
+        return {index_buffer(IndexWidth::U16), index_buffer(IndexWidth::U32)};
     }
 
 } // namespace ankh
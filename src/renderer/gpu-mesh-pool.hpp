@@ -1,6 +1,7 @@
 // src/renderer/gpu-mesh-pool.hpp
 #pragma once
 
+#include <array>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -16,6 +17,8 @@
 
 namespace ankh
 {
+    class JobSystem;
+
     class GpuMeshPool
     {
       public:
@@ -25,17 +28,52 @@ namespace ankh
                     GpuRetirementQueue *retirement);
 
         // Build unified buffers from all valid meshes in the MeshPool.
-        // Call this after meshes are loaded.
-        void build_from_mesh_pool(const MeshPool &mesh_pool);
+        // Call this after meshes are loaded. With a JobSystem, meshes are encoded (or
+        // copied, for GPU-only meshes) into the staging buffers in parallel.
+        void build_from_mesh_pool(const MeshPool &mesh_pool, JobSystem *jobs = nullptr);
+
+        // Incremented by every build; lets consumers cache data derived from draw_table()
+        uint64_t revision() const noexcept
+        {
+            return m_revision;
+        }
 
         void mark_used(GpuSignal signal) noexcept;
 
         VkBuffer vertex_buffer() const noexcept;
 
-        VkBuffer index_buffer() const noexcept;
+        // Size of the vertex buffer: meshes in their encoded VertexFormat
+        VkDeviceSize vertex_bytes() const noexcept
+        {
+            return m_vertex_bytes;
+        }
+
+        // Unified index buffer of one width; MeshDrawInfo::firstIndex counts in it
+        VkBuffer index_buffer(IndexWidth width) const noexcept;
+
+        IndexBuffers index_buffers() const noexcept;
+
+        // Size of both index buffers together
+        VkDeviceSize index_bytes() const noexcept
+        {
+            return m_index_bytes;
+        }
 
         const std::unordered_map<MeshHandle, MeshDrawInfo> &draw_info() const noexcept;
 
+        // Same ranges indexed directly by MeshHandle (indexCount == 0: not resident).
+        // Used on the hot draw path instead of hashing per renderable.
+        const std::vector<MeshDrawInfo> &draw_table() const noexcept
+        {
+            return m_draw_table;
+        }
+
+        // Meshlets of all meshes, firstIndex rebased into the mesh's unified index buffer
+        const std::vector<Meshlet> &cluster_table() const noexcept
+        {
+            return m_cluster_table;
+        }
+
       private:
         VkDevice m_device{VK_NULL_HANDLE};
 
@@ -45,9 +83,14 @@ namespace ankh
 
         std::unique_ptr<Buffer> m_vertex_buffer;
 
-        std::unique_ptr<Buffer> m_index_buffer;
+        std::array<std::unique_ptr<Buffer>, INDEX_WIDTH_COUNT> m_index_buffers;
+        VkDeviceSize m_vertex_bytes{0};
+        VkDeviceSize m_index_bytes{0};
 
         std::unordered_map<MeshHandle, MeshDrawInfo> m_draw_info;
+        std::vector<MeshDrawInfo> m_draw_table;
+        std::vector<Meshlet> m_cluster_table;
+        uint64_t m_revision{0};
 
         GpuRetirementQueue *m_retirement{nullptr};
     };
@@ -1,15 +1,47 @@
 // src/renderer/mesh-draw-info.hpp
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include "scene/mesh.hpp"
 #include "scene/renderable.hpp"
+#include "utils/types.hpp"
+#include "utils/vertex-format.hpp"
 
 namespace ankh
 {
+    // One level of detail: an index range over the mesh's (shared) vertices
+    struct MeshLodRange
+    {
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+    };
+
+    // Unified index buffers, one per IndexWidth (VK_NULL_HANDLE when no mesh uses it)
+    using IndexBuffers = std::array<VkBuffer, INDEX_WIDTH_COUNT>;
+
     struct MeshDrawInfo
     {
-        uint32_t firstIndex{0};   // first index into the unified index buffer
+        uint32_t firstIndex{0};   // first index into the unified buffer of indexWidth
         uint32_t indexCount{0};   // number of indices for this mesh
         int32_t  vertexOffset{0}; // added to index as baseVertex in vkCmdDrawIndexed
+        VertexFormat vertexFormat{VertexFormat::Float}; // vertexOffset counts in its stride
+        IndexWidth indexWidth{IndexWidth::U16};         // which unified index buffer
+        glm::vec4 boundingSphere{0.0f}; // mesh-local xyz center, w radius (GPU culling)
+
+        // Level 0 split into GpuMeshPool::cluster_table()[firstCluster, + clusterCount)
+        // (see Mesh::meshlets); no clusters: level 0 is culled and drawn whole
+        uint32_t firstCluster{0};
+        uint32_t clusterCount{0};
+
+        // lods[0] is {firstIndex, indexCount}; coarser levels follow (see Mesh::lods)
+        uint32_t lodCount{1};
+        std::array<MeshLodRange, MAX_MESH_LODS> lods{};
+
+        // Range for a selected level, clamped to the levels this mesh has
+        const MeshLodRange &lod(uint32_t level) const
+        {
+            return lods[level < lodCount ? level : lodCount - 1];
+        }
     };
 } // namespace ankh
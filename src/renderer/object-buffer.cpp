@@ -0,0 +1,284 @@
+// src/renderer/object-buffer.cpp
+#include "renderer/object-buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "frame/frame-allocator.hpp"
+#include "jobs/job-system.hpp"
+#include "memory/buffer.hpp"
+#include "scene/transform-kernels.hpp"
+
+#include <utils/logging.hpp>
+
+namespace ankh
+{
+    namespace
+    {
+        constexpr VkDeviceSize kRecordBytes = sizeof(ObjectDataGPU);
+        constexpr uint32_t kFillGrain = 1024;
+
+        constexpr VkPipelineStageFlags2 kReaderStages =
+            VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    } // namespace
+
+    ObjectBuffer::ObjectBuffer(VmaAllocator allocator,
+                               VkDevice device,
+                               uint32_t capacity,
+                               GpuRetirementQueue *retirement)
+        : m_retirement(retirement)
+        , m_capacity(capacity)
+        , m_dirty_flags(capacity, 0)
+    {
+        ANKH_ASSERT(capacity > 0);
+
+        m_buffer = std::make_unique<Buffer>(allocator,
+                                            device,
+                                            kRecordBytes * capacity,
+                                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                            VMA_MEMORY_USAGE_GPU_ONLY,
+                                            retirement,
+                                            GpuSignal{});
+
+        m_materials = std::make_unique<Buffer>(allocator,
+                                               device,
+                                               material_size_bytes(),
+                                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                               VMA_MEMORY_USAGE_GPU_ONLY,
+                                               retirement,
+                                               GpuSignal{});
+    }
+
+    ObjectBuffer::~ObjectBuffer() = default;
+
+    VkBuffer ObjectBuffer::handle() const noexcept
+    {
+        return m_buffer->handle();
+    }
+
+    VkDeviceSize ObjectBuffer::size_bytes() const noexcept
+    {
+        return kRecordBytes * m_capacity;
+    }
+
+    VkBuffer ObjectBuffer::material_handle() const noexcept
+    {
+        return m_materials->handle();
+    }
+
+    VkDeviceSize ObjectBuffer::material_size_bytes() const noexcept
+    {
+        return sizeof(MaterialGPU) * kMaterialCapacity;
+    }
+
+    void ObjectBuffer::mark_dirty(uint32_t object)
+    {
+        if (object >= m_capacity || m_dirty_flags[object] != 0)
+        {
+            return;
+        }
+
+        m_dirty_flags[object] = 1;
+        m_dirty.push_back(object);
+    }
+
+    void ObjectBuffer::mark_dirty(const std::vector<uint32_t> &objects)
+    {
+        for (uint32_t object : objects)
+        {
+            mark_dirty(object);
+        }
+    }
+
+    void ObjectBuffer::mark_all_dirty(uint32_t object_count)
+    {
+        m_all_dirty = std::max(m_all_dirty, std::min(object_count, m_capacity));
+    }
+
+    void ObjectBuffer::stage(FrameAllocator &frame_allocator,
+                             const RenderableStore &renderables,
+                             const std::vector<MaterialGPU> &material_table,
+                             JobSystem &jobs)
+    {
+        m_upload_ids.clear();
+        m_regions.clear();
+        m_staging = VK_NULL_HANDLE;
+        m_material_region = {};
+
+        const uint32_t materialCount =
+            std::min(static_cast<uint32_t>(material_table.size()), kMaterialCapacity);
+
+        if (m_materials_dirty && materialCount != 0)
+        {
+            const VkDeviceSize bytes = sizeof(MaterialGPU) * materialCount;
+
+            auto span = frame_allocator.alloc("MaterialGPU", bytes, alignof(MaterialGPU));
+            if (span.cpu != nullptr)
+            {
+                std::memcpy(span.cpu, material_table.data(), bytes);
+
+                m_material_region.srcOffset = span.offset;
+                m_material_region.dstOffset = 0;
+                m_material_region.size = bytes;
+                m_staging = span.buffer;
+                m_materials_dirty = false;
+            }
+        }
+
+        if (m_all_dirty == 0 && m_dirty.empty())
+        {
+            return;
+        }
+
+        const uint32_t limit = std::min(renderables.size(), m_capacity);
+
+        // Ascending ids; short gaps between dirty ids are filled so they share a region
+        auto append = [this](uint32_t id)
+        {
+            if (!m_upload_ids.empty())
+            {
+                const uint32_t last = m_upload_ids.back();
+                if (id <= last)
+                {
+                    return; // already covered by the all-dirty prefix
+                }
+
+                if (id - last - 1 <= kMergeGap)
+                {
+                    for (uint32_t gap = last + 1; gap < id; ++gap)
+                    {
+                        m_upload_ids.push_back(gap);
+                    }
+                }
+            }
+
+            m_upload_ids.push_back(id);
+        };
+
+        const uint32_t prefix = std::min(m_all_dirty, limit);
+        m_upload_ids.resize(prefix);
+        for (uint32_t i = 0; i < prefix; ++i)
+        {
+            m_upload_ids[i] = i;
+        }
+
+        std::sort(m_dirty.begin(), m_dirty.end());
+        for (uint32_t id : m_dirty)
+        {
+            if (id < limit)
+            {
+                append(id);
+            }
+        }
+
+        const uint32_t count = static_cast<uint32_t>(m_upload_ids.size());
+
+        if (count != 0)
+        {
+            auto span = frame_allocator.alloc("ObjectDataGPU", kRecordBytes * count,
+                                              alignof(ObjectDataGPU));
+            if (span.cpu == nullptr)
+            {
+                m_upload_ids.clear();
+                return; // FrameAllocator overflow (already reported); retry next frame
+            }
+
+            auto *dst = reinterpret_cast<ObjectDataGPU *>(span.cpu);
+
+            jobs.parallel_for(0,
+                              count,
+                              kFillGrain,
+                              [&](uint32_t first, uint32_t last)
+                              {
+                                  write_object_data(renderables.world_transforms(),
+                                                    renderables.materials(),
+                                                    materialCount,
+                                                    m_upload_ids.data() + first,
+                                                    last - first,
+                                                    dst + first);
+                              });
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (i == 0 || m_upload_ids[i] != m_upload_ids[i - 1] + 1)
+                {
+                    VkBufferCopy &region = m_regions.emplace_back();
+                    region.srcOffset = span.offset + kRecordBytes * i;
+                    region.dstOffset = kRecordBytes * m_upload_ids[i];
+                    region.size = 0;
+                }
+
+                m_regions.back().size += kRecordBytes;
+            }
+
+            m_staging = span.buffer;
+        }
+
+        for (uint32_t id : m_dirty)
+        {
+            m_dirty_flags[id] = 0;
+        }
+
+        m_dirty.clear();
+        m_all_dirty = 0;
+    }
+
+    void ObjectBuffer::record(VkCommandBuffer cmd) const
+    {
+        if (m_regions.empty() && m_material_region.size == 0)
+        {
+            return;
+        }
+
+        // Earlier frames may still read the records being replaced (write-after-read)
+        VkMemoryBarrier2 readsToCopy{};
+        readsToCopy.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        readsToCopy.srcStageMask = kReaderStages;
+        readsToCopy.dstStageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+        readsToCopy.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+
+        VkDependencyInfo dep{};
+        dep.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dep.memoryBarrierCount = 1;
+        dep.pMemoryBarriers = &readsToCopy;
+
+        vkCmdPipelineBarrier2(cmd, &dep);
+
+        if (m_material_region.size != 0)
+        {
+            vkCmdCopyBuffer(cmd, m_staging, m_materials->handle(), 1, &m_material_region);
+        }
+
+        if (!m_regions.empty())
+        {
+            vkCmdCopyBuffer(cmd,
+                            m_staging,
+                            m_buffer->handle(),
+                            static_cast<uint32_t>(m_regions.size()),
+                            m_regions.data());
+        }
+
+        VkMemoryBarrier2 copyToReads{};
+        copyToReads.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        copyToReads.srcStageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+        copyToReads.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        copyToReads.dstStageMask = kReaderStages;
+        copyToReads.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+
+        dep.pMemoryBarriers = &copyToReads;
+
+        vkCmdPipelineBarrier2(cmd, &dep);
+    }
+
+    void ObjectBuffer::mark_used(GpuSignal signal) noexcept
+    {
+        if (m_retirement)
+        {
+            m_buffer->set_retirement(m_retirement, signal);
+            m_materials->set_retirement(m_retirement, signal);
+        }
+    }
+
+} // namespace ankh
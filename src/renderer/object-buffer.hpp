@@ -0,0 +1,108 @@
+// src/renderer/object-buffer.hpp
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "scene/renderable-store.hpp"
+#include "utils/gpu-retirement-queue.hpp"
+#include "utils/types.hpp"
+#include <vk_mem_alloc.h>
+
+namespace ankh
+{
+    class Buffer;
+    class FrameAllocator;
+    class JobSystem;
+
+    // Device-local ObjectDataGPU array indexed by renderable id, kept across frames, plus
+    // a MaterialGPU table indexed by material handle that the records point into.
+    // Objects are marked dirty when their world transform or material changes. Each frame
+    // stage() packs the dirty records (ascending id) into a FrameAllocator span and
+    // record() copies them over with one VkBufferCopy per run of ids, so host->device
+    // traffic follows the number of changed objects instead of the scene size. Editing a
+    // material re-uploads only the (small) material table.
+    class ObjectBuffer
+    {
+      public:
+        // Material handles at or above this share record 0 (white)
+        static constexpr uint32_t kMaterialCapacity = 4096;
+
+        ObjectBuffer(VmaAllocator allocator,
+                     VkDevice device,
+                     uint32_t capacity,
+                     GpuRetirementQueue *retirement);
+
+        ~ObjectBuffer();
+
+        ObjectBuffer(const ObjectBuffer &) = delete;
+        ObjectBuffer &operator=(const ObjectBuffer &) = delete;
+
+        VkBuffer handle() const noexcept;
+
+        VkDeviceSize size_bytes() const noexcept;
+
+        VkBuffer material_handle() const noexcept;
+
+        VkDeviceSize material_size_bytes() const noexcept;
+
+        // Objects with id >= capacity() have no record (and are not drawn)
+        uint32_t capacity() const noexcept
+        {
+            return m_capacity;
+        }
+
+        void mark_dirty(uint32_t object);
+        void mark_dirty(const std::vector<uint32_t> &objects);
+
+        // Every record in [0, object_count) is re-uploaded (scene rebuilt)
+        void mark_all_dirty(uint32_t object_count);
+
+        // Re-upload the material table on the next stage()
+        void mark_materials_dirty() noexcept
+        {
+            m_materials_dirty = true;
+        }
+
+        // Write the dirty records into 'frame_allocator' and prepare the copy regions for
+        // record(). If the span does not fit, the objects stay dirty for the next frame.
+        void stage(FrameAllocator &frame_allocator,
+                   const RenderableStore &renderables,
+                   const std::vector<MaterialGPU> &material_table,
+                   JobSystem &jobs);
+
+        // Copy the staged records. Must be recorded outside a render pass, before the
+        // cull and draw passes that read the buffer this frame.
+        void record(VkCommandBuffer cmd) const;
+
+        void mark_used(GpuSignal signal) noexcept;
+
+        // Records uploaded by the last stage()
+        uint32_t uploaded_objects() const noexcept
+        {
+            return static_cast<uint32_t>(m_upload_ids.size());
+        }
+
+      private:
+        // Clean records uploaded to join two dirty runs into one copy region; a few extra
+        // bytes are cheaper than another region.
+        static constexpr uint32_t kMergeGap = 4;
+
+        std::unique_ptr<Buffer> m_buffer;
+        std::unique_ptr<Buffer> m_materials;
+        GpuRetirementQueue *m_retirement{nullptr};
+        uint32_t m_capacity{0};
+
+        std::vector<uint8_t> m_dirty_flags; // per id
+        std::vector<uint32_t> m_dirty;      // ids with their flag set, in marking order
+        uint32_t m_all_dirty{0};            // [0, m_all_dirty) dirty regardless of flags
+        bool m_materials_dirty{true};
+
+        // Last stage(): uploaded ids (ascending) and their copy regions
+        std::vector<uint32_t> m_upload_ids;
+        std::vector<VkBufferCopy> m_regions;
+        VkBuffer m_staging{VK_NULL_HANDLE};
+        VkBufferCopy m_material_region{}; // size 0: table not uploaded this frame
+    };
+
+} // namespace ankh
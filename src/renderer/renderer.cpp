@@ -5,16 +5,23 @@
 #include "platform/window.hpp"
 
 #include "core/context.hpp"
+#include "core/device.hpp"
 
+#include "swapchain/offscreen-targets.hpp"
 #include "swapchain/swapchain.hpp"
 
 #include "renderpass/frame-buffer.hpp"
 #include "renderpass/render-pass.hpp"
 
+#include "cull-pass.hpp"
+#include "draw-batcher.hpp"
 #include "draw-pass.hpp"
+#include "object-buffer.hpp"
 
 #include "scene-renderer.hpp"
 #include "scene/camera.hpp"
+#include "scene/cooked-package.hpp"
+#include "scene/frustum.hpp"
 #include "scene/material-pool.hpp"
 #include "scene/mesh-pool.hpp"
 #include "scene/model-loader.hpp"
@@ -52,9 +59,14 @@
 
 #include "streaming/async-uploader.hpp"
 
+#include "profiling/gpu-profiler.hpp"
+
+#include "jobs/job-system.hpp"
+
 #include <chrono>
 #include <cstring>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <utils/logging.hpp>
 
@@ -66,6 +78,10 @@ namespace ankh
         ANKH_LOG_DEBUG("[Renderer] ObjectBuffer capacity per frame: " +
                        std::to_string(ankh::config().maxObjects));
 
+        m_jobs = std::make_unique<JobSystem>(ankh::config().jobThreads);
+        ANKH_LOG_DEBUG("[Renderer] JobSystem threads: " +
+                       std::to_string(m_jobs->thread_count()));
+
         m_gpu = std::make_unique<RendererGpuState>();
         init_vulkan();
     }
@@ -103,20 +119,44 @@ namespace ankh
 
     void Renderer::init_vulkan()
     {
-        m_window = std::make_unique<Window>("Ankh", ankh::config().Width, ankh::config().Height);
+        const bool headless = ankh::config().headless;
 
-        // Context sets up instance, debug, surface, physical device, device
-        m_context = std::make_unique<Context>(m_window->handle());
+        if (!headless)
+        {
+            m_window =
+                std::make_unique<Window>("Ankh", ankh::config().Width, ankh::config().Height);
+        }
 
-        m_gpu->swapchain = std::make_unique<Swapchain>(m_context->physical_device(),
-                                                       m_context->device_handle(),
-                                                       m_context->allocator().handle(),
-                                                       m_context->surface_handle(),
-                                                       m_window->handle(),
-                                                       tracker());
+        // Context sets up instance, debug, surface (unless headless), physical device, device
+        m_context = std::make_unique<Context>(m_window ? m_window->handle() : nullptr);
 
-        m_gpu->render_pass = std::make_unique<RenderPass>(m_context->device_handle(),
-                                                          m_gpu->swapchain->image_format());
+        if (headless)
+        {
+            // One offscreen image per frame slot: the slot fence is the only sync needed
+            m_gpu->offscreen = std::make_unique<OffscreenTargets>(
+                m_context->device_handle(),
+                m_context->allocator().handle(),
+                VkExtent2D{ankh::config().Width, ankh::config().Height},
+                VK_FORMAT_B8G8R8A8_SRGB,
+                static_cast<uint32_t>(ankh::config().framesInFlight),
+                tracker());
+
+            m_gpu->render_pass = std::make_unique<RenderPass>(m_context->device_handle(),
+                                                              m_gpu->offscreen->image_format(),
+                                                              VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        }
+        else
+        {
+            m_gpu->swapchain = std::make_unique<Swapchain>(m_context->physical_device(),
+                                                           m_context->device_handle(),
+                                                           m_context->allocator().handle(),
+                                                           m_context->surface_handle(),
+                                                           m_window->handle(),
+                                                           tracker());
+
+            m_gpu->render_pass = std::make_unique<RenderPass>(m_context->device_handle(),
+                                                              m_gpu->swapchain->image_format());
+        }
 
         m_gpu->descriptor_set_layout =
             std::make_unique<DescriptorSetLayout>(m_context->device_handle());
@@ -131,18 +171,19 @@ namespace ankh
                                                m_gpu->pipeline_layout->handle());
 
         m_gpu->draw_pass = std::make_unique<DrawPass>(m_context->device_handle(),
-                                                      *m_gpu->swapchain,
                                                       *m_gpu->render_pass,
                                                       *m_gpu->graphics_pipeline,
-                                                      *m_gpu->pipeline_layout);
+                                                      *m_gpu->pipeline_layout,
+                                                      use_indirect_draw());
 
         m_gpu->ui_pass = std::make_unique<UiPass>(m_context->device_handle(),
-                                                  *m_gpu->swapchain,
                                                   *m_gpu->render_pass,
                                                   *m_gpu->graphics_pipeline,
                                                   *m_gpu->pipeline_layout);
 
         m_gpu->scene_renderer = std::make_unique<SceneRenderer>();
+        m_gpu->scene_renderer->set_job_system(m_jobs.get());
+        m_gpu->draw_batcher = std::make_unique<DrawBatcher>();
 
         const auto framesInFlight{ankh::config().framesInFlight};
 
@@ -154,15 +195,36 @@ namespace ankh
 
         FrameAllocator::Limits lim{};                       // FIX
         lim.framesInFlight = ankh::config().framesInFlight; // FIX
-        lim.perFrameBytes = 1ull * 1024ull * 1024ull;       // FIX (or your chosen size)
         lim.minAlignment = std::max(props.limits.minUniformBufferOffsetAlignment,
                                     props.limits.minStorageBufferOffsetAlignment); // FIX
 
+        // Per-frame slice must hold FrameUBO + one instance id per object + the worst-case
+        // ObjectBuffer upload (every record and the material table dirty) + one indirect
+        // command per object + the cull input (objects and meshlet clusters), each aligned;
+        // never go below the original 1MB so small scenes keep headroom for other spans.
+        const VkDeviceSize maxObjects = ankh::config().maxObjects;
+        const VkDeviceSize instanceBytes = sizeof(uint32_t) * maxObjects;
+        const VkDeviceSize objectBytes = sizeof(ObjectDataGPU) * maxObjects;
+        const VkDeviceSize materialBytes = sizeof(MaterialGPU) * ObjectBuffer::kMaterialCapacity;
+        const VkDeviceSize indirectBytes = sizeof(VkDrawIndexedIndirectCommand) * maxObjects;
+        const VkDeviceSize cullBytes =
+            sizeof(CullObjectGPU) * (maxObjects + ankh::config().maxClusterDraws);
+        lim.perFrameBytes = std::max<VkDeviceSize>(1ull * 1024ull * 1024ull,
+                                                   sizeof(FrameUBO) + instanceBytes +
+                                                       objectBytes + materialBytes +
+                                                       indirectBytes + cullBytes +
+                                                       6 * lim.minAlignment);
+
         m_gpu->frame_allocator = std::make_unique<FrameAllocator>(m_context->allocator().handle(),
                                                                   m_context->device_handle(),
                                                                   lim, // FIX
                                                                   m_retirement_queue.get());
 
+        m_gpu->object_buffer = std::make_unique<ObjectBuffer>(m_context->allocator().handle(),
+                                                              m_context->device_handle(),
+                                                              ankh::config().maxObjects,
+                                                              m_retirement_queue.get());
+
         // Upload context: device + graphics queue family index
         m_gpu->async_uploader =
             std::make_unique<AsyncUploader>(m_context->device_handle(),
@@ -176,16 +238,30 @@ namespace ankh
 
         // Load a model into the scene
         {
-            // adjust path to where you actually put Box.gltf or Box.glb
-            Model model =
-                ModelLoader::load_gltf("D:\\Rep\\Ankh\\assets\\models\\cerberus\\cerberus.gltf",
-                                       m_gpu->scene_renderer->mesh_pool(),
-                                       m_gpu->scene_renderer->material_pool());
+            // Cooked packages (ankh_cook) are mapped and uploaded as stored
+            const std::string &modelPath = ankh::config().modelPath;
+            Model model = modelPath.ends_with(PACKAGE_EXTENSION)
+                              ? ModelLoader::load_package(modelPath,
+                                                          m_gpu->scene_renderer->mesh_pool(),
+                                                          m_gpu->scene_renderer->material_pool())
+                              : ModelLoader::load_gltf(modelPath,
+                                                       m_gpu->scene_renderer->mesh_pool(),
+                                                       m_gpu->scene_renderer->material_pool(),
+                                                       m_jobs.get());
 
             MaterialHandle default_mat = m_gpu->scene_renderer->default_material_handle();
 
+            // Model nodes are breadth-first, so they map 1:1 onto hierarchy nodes
+            auto &hierarchy = m_gpu->scene_renderer->hierarchy();
+            const NodeHandle nodeBase = hierarchy.size();
+
             for (const auto &node : model.nodes())
             {
+                const NodeHandle parent = (node.parent < 0)
+                                              ? INVALID_NODE_HANDLE
+                                              : nodeBase + static_cast<NodeHandle>(node.parent);
+                const NodeHandle handle = hierarchy.add(parent, node.local_transform);
+
                 if (node.mesh == INVALID_MESH_HANDLE)
                 {
                     continue;
@@ -195,40 +271,128 @@ namespace ankh
                 r.mesh = node.mesh;
                 r.material =
                     (node.material == INVALID_MATERIAL_HANDLE) ? default_mat : node.material;
-                r.base_transform = node.local_transform;
-                r.transform = r.base_transform;
+                r.node = handle;
 
-                m_gpu->scene_renderer->renderables().push_back(r);
+                m_gpu->scene_renderer->renderables().add(r);
             }
 
-            SceneBounds bounds = m_gpu->scene_renderer->compute_scene_bounds();
-            if (bounds.valid)
+            // Keep something on screen (and something to benchmark) without the asset
+            if (m_gpu->scene_renderer->renderables().empty())
             {
-                glm::vec3 center = 0.5f * (bounds.min + bounds.max);
-                float radius = glm::length(bounds.max - bounds.min) * 0.5f;
+                ANKH_LOG_WARN("[Renderer] No renderables loaded from '" +
+                              ankh::config().modelPath + "'; using fallback quad");
 
-                // simple heuristic distance; works for most scenes
-                float distance = (radius > 0.0f) ? radius * 2.5f : 5.0f;
+                Renderable r{};
+                r.mesh = m_gpu->scene_renderer->mesh_pool().create(Mesh::make_colored_quad());
+                r.material = default_mat;
+                m_gpu->scene_renderer->renderables().add(r);
+            }
 
-                auto &cam = m_gpu->scene_renderer->camera();
-                cam.set_target(center);
-                cam.set_position(center + glm::vec3(distance, distance, distance));
+            if (m_gpu->scene_renderer->material_pool().size() > ObjectBuffer::kMaterialCapacity)
+            {
+                ANKH_LOG_WARN("[Renderer] Scene has more materials than the object buffer's "
+                              "material table (" +
+                              std::to_string(ObjectBuffer::kMaterialCapacity) +
+                              "); the rest render white");
             }
+
+            m_gpu->scene_renderer->mark_changed();
+            m_gpu->scene_renderer->propagate_transforms(); // base transforms for framing
+            m_gpu->scene_renderer->frame_camera(m_gpu->scene_renderer->compute_scene_bounds());
         }
 
-        m_gpu->gpu_mesh_pool->build_from_mesh_pool(m_gpu->scene_renderer->mesh_pool());
+        // Simplified levels of detail and meshlets (only culled by CullPass), one mesh per
+        // job; uploaded with the base geometry
+        const uint32_t lodLevels = ankh::config().lodLevels;
+        const bool meshlets = ankh::config().meshlets && ankh::config().gpuCulling;
+
+        if (lodLevels != 0 || meshlets)
+        {
+            auto &meshes = m_gpu->scene_renderer->mesh_pool();
+            const std::vector<MeshHandle> handles = meshes.handles();
+
+            m_jobs->parallel_for(0,
+                                 static_cast<uint32_t>(handles.size()),
+                                 1,
+                                 [&](uint32_t first, uint32_t last)
+                                 {
+                                     for (uint32_t i = first; i < last; ++i)
+                                     {
+                                         Mesh &mesh = meshes.get(handles[i]);
+                                         if (lodLevels != 0)
+                                         {
+                                             mesh.build_lods(lodLevels);
+                                         }
+                                         if (meshlets)
+                                         {
+                                             mesh.build_meshlets(MESHLET_MIN_MESH_TRIANGLES);
+                                         }
+                                     }
+                                 });
+        }
+
+        m_gpu->gpu_mesh_pool->build_from_mesh_pool(m_gpu->scene_renderer->mesh_pool(),
+                                                    m_jobs.get());
 
         create_framebuffers();
         create_descriptor_pool();
         create_texture();
+
+        m_gpu->record_threads = resolve_record_threads();
+
         create_frames();
+
+        if (use_gpu_culling())
+        {
+            const VkDeviceSize instanceBase = object_base_in_slice();
+
+            m_gpu->cull_pass =
+                std::make_unique<CullPass>(m_context->device_handle(),
+                                           m_context->allocator().handle(),
+                                           static_cast<uint32_t>(framesInFlight),
+                                           ankh::config().maxObjects,
+                                           ankh::config().maxClusterDraws,
+                                           m_gpu->frame_allocator->buffer(),
+                                           instanceBase,
+                                           m_gpu->frame_allocator->frame_capacity() -
+                                               instanceBase,
+                                           m_gpu->object_buffer->handle(),
+                                           m_gpu->object_buffer->size_bytes(),
+                                           m_context->device().draw_indirect_count());
+        }
+
+        m_gpu->gpu_profiler =
+            std::make_unique<GpuProfiler>(m_context->physical_device().handle(),
+                                          m_context->device_handle(),
+                                          m_context->queues().graphicsFamily.value(),
+                                          static_cast<uint32_t>(framesInFlight));
+
+        m_gpu->gpu_profiler->set_report_interval(ankh::config().gpuProfileInterval,
+                                                 ankh::config().gpuProfileJsonPath);
     }
 
     void Renderer::create_framebuffers()
     {
+        if (m_gpu->offscreen)
+        {
+            m_gpu->offscreen->create_framebuffers(m_gpu->render_pass->handle());
+            return;
+        }
+
         m_gpu->swapchain->create_framebuffers(m_gpu->render_pass->handle());
     }
 
+    VkExtent2D Renderer::target_extent() const
+    {
+        return m_gpu->offscreen ? m_gpu->offscreen->extent() : m_gpu->swapchain->extent();
+    }
+
+    const Framebuffer &Renderer::target_framebuffer(uint32_t image_index) const
+    {
+        return m_gpu->offscreen ? m_gpu->offscreen->framebuffer(image_index)
+                                : m_gpu->swapchain->framebuffer(image_index);
+    }
+
     void Renderer::cleanup_swapchain()
     {
         // These may have been moved into the deletion queue already.
@@ -342,14 +506,16 @@ namespace ankh
         auto &renderables = m_gpu->scene_renderer->renderables();
         auto &materials = m_gpu->scene_renderer->material_pool();
 
-        for (const auto &r : renderables)
+        for (uint32_t i = 0; i < renderables.size(); ++i)
         {
-            if (!materials.valid(r.material))
+            const MaterialHandle handle = renderables.material(i);
+
+            if (!materials.valid(handle))
             {
                 continue;
             }
 
-            const Material &mat = materials.get(r.material);
+            const Material &mat = materials.get(handle);
             if (mat.has_base_color_image())
             {
                 sourceImage = mat.base_color_image();
@@ -357,6 +523,10 @@ namespace ankh
             }
         }
 
+        // RGBA8 texels to upload: the image's own bytes when they already are (decoded
+        // glTF images and mapped package pixels go straight to staging), else converted
+        // into 'pixels'
+        std::span<const uint8_t> texels;
         std::vector<uint8_t> pixels;
         uint32_t texWidth = 0;
         uint32_t texHeight = 0;
@@ -368,11 +538,11 @@ namespace ankh
             texHeight = static_cast<uint32_t>(sourceImage->height);
 
             const int comp = sourceImage->components;
-            const auto &src = sourceImage->pixels;
+            const std::span<const uint8_t> src = sourceImage->bytes();
 
             if (comp == 4)
             {
-                pixels = src; // already RGBA8
+                texels = src; // already RGBA8
             }
             else if (comp == 3)
             {
@@ -384,6 +554,7 @@ namespace ankh
                     pixels[4 * i + 2] = src[3 * i + 2];
                     pixels[4 * i + 3] = 255;
                 }
+                texels = pixels;
             }
             else
             {
@@ -393,7 +564,7 @@ namespace ankh
         }
 
         // Fallback if no suitable glTF image
-        if (pixels.empty())
+        if (texels.empty())
         {
             ANKH_LOG_WARN(
                 "[Renderer] No suitable baseColorTexture found; using checkerboard fallback");
@@ -419,9 +590,10 @@ namespace ankh
                       255,
                       255,
                       255};
+            texels = pixels;
         }
 
-        const VkDeviceSize imageSize = static_cast<VkDeviceSize>(pixels.size());
+        const VkDeviceSize imageSize = static_cast<VkDeviceSize>(texels.size());
 
         // Staging buffer
         Buffer staging(m_context->allocator().handle(),
@@ -431,7 +603,7 @@ namespace ankh
                        VMA_MEMORY_USAGE_CPU_ONLY);
         {
             void *data = staging.map();
-            std::memcpy(data, pixels.data(), static_cast<size_t>(imageSize));
+            std::memcpy(data, texels.data(), static_cast<size_t>(imageSize));
             staging.unmap();
         }
 
@@ -491,6 +663,10 @@ namespace ankh
         QueueFamilyIndices queues = m_context->queues();
         uint32_t graphicsFamily = queues.graphicsFamily.value();
 
+        // One secondary per recording thread, plus one for the UI pass
+        const uint32_t secondaries =
+            m_gpu->record_threads > 1 ? m_gpu->record_threads + 1 : 0;
+
         VkDeviceSize objectSize = sizeof(ObjectDataGPU) * ankh::config().maxObjects;
 
         std::vector<VkDescriptorSetLayout> layouts(ankh::config().framesInFlight,
@@ -520,20 +696,12 @@ namespace ankh
                                        sets[i],
                                        m_gpu->texture->view(),
                                        m_gpu->texture->sampler(),
-                                       m_retirement_queue.get());
+                                       m_retirement_queue.get(),
+                                       secondaries);
 
             const VkDeviceSize frameCap = m_gpu->frame_allocator->frame_capacity();
 
-            const auto props = m_context->physical_device().properties();
-
-            // Must match FrameAllocator::Limits::minAlignment (max of UBO/SSBO alignment)
-            const VkDeviceSize minAlignment =
-                std::max(static_cast<VkDeviceSize>(props.limits.minUniformBufferOffsetAlignment),
-                         static_cast<VkDeviceSize>(props.limits.minStorageBufferOffsetAlignment));
-
-            // Objects start after UBO, aligned to allocator alignment
-            const VkDeviceSize objBaseInSlice =
-                (sizeof(FrameUBO) + (minAlignment - 1)) & ~(minAlignment - 1);
+            const VkDeviceSize objBaseInSlice = object_base_in_slice();
 
             writer.writeUniformBufferDynamic(sets[i],
                                              global,
@@ -552,22 +720,72 @@ namespace ankh
                                              m_gpu->texture->sampler(),
                                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                                              /*binding*/ 2);
+
+            writer.writeStorageBuffer(sets[i],
+                                      m_gpu->object_buffer->handle(),
+                                      /*offset*/ 0,
+                                      m_gpu->object_buffer->size_bytes(),
+                                      /*binding*/ 3);
+
+            writer.writeStorageBuffer(sets[i],
+                                      m_gpu->object_buffer->material_handle(),
+                                      /*offset*/ 0,
+                                      m_gpu->object_buffer->material_size_bytes(),
+                                      /*binding*/ 4);
         }
     }
 
-    void
-    Renderer::record_command_buffer(FrameContext &frame, uint32_t image_index, GpuSignal signal)
+    void Renderer::record_command_buffer(FrameContext &frame,
+                                         FrameSlot slot,
+                                         uint32_t image_index,
+                                         GpuSignal signal)
     {
 
         VkCommandBuffer cmd = frame.begin(signal);
 
+        m_gpu->gpu_profiler->begin_frame(cmd, slot);
+
+        // Changed object records land before anything reads them this frame
+        m_gpu->object_buffer->mark_used(signal);
+        {
+            GpuProfileScope scope{*m_gpu->gpu_profiler, cmd, slot, "objects"};
+            m_gpu->object_buffer->record(cmd);
+        }
+
+        // Compute work must be recorded before the render pass begins
+        if (m_gpu->cull_pass)
+        {
+            GpuProfileScope scope{*m_gpu->gpu_profiler, cmd, slot, "cull"};
+            m_gpu->cull_pass->record(cmd, slot, frame);
+        }
+
+        VkBuffer vb = VK_NULL_HANDLE;
+        IndexBuffers ib{};
+
+        if (m_gpu->gpu_mesh_pool)
+        {
+            m_gpu->gpu_mesh_pool->mark_used(signal);
+
+            vb = m_gpu->gpu_mesh_pool->vertex_buffer();
+            ib = m_gpu->gpu_mesh_pool->index_buffers();
+        }
+
+        const bool hasGeometry = vb != VK_NULL_HANDLE &&
+                                 (ib[0] != VK_NULL_HANDLE || ib[1] != VK_NULL_HANDLE);
+
+        const uint32_t batchCount =
+            static_cast<uint32_t>(m_gpu->draw_batcher->packets().size());
+
+        const bool parallel = m_gpu->record_threads > 1 && hasGeometry &&
+                              batchCount >= ankh::config().parallelRecordMinDraws;
+
         // --- Begin render pass ---
         VkRenderPassBeginInfo rp_info{};
         rp_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
         rp_info.renderPass = m_gpu->render_pass->handle();
-        rp_info.framebuffer = m_gpu->swapchain->framebuffer(image_index).handle();
+        rp_info.framebuffer = target_framebuffer(image_index).handle();
         rp_info.renderArea.offset = {0, 0};
-        rp_info.renderArea.extent = m_gpu->swapchain->extent();
+        rp_info.renderArea.extent = target_extent();
 
         std::array<VkClearValue, 2> clear_values{};
         clear_values[0].color = {0.0f, 0.0f, 0.0f, 1.0f};
@@ -576,47 +794,138 @@ namespace ankh
         rp_info.clearValueCount = static_cast<uint32_t>(clear_values.size());
         rp_info.pClearValues = clear_values.data();
 
-        vkCmdBeginRenderPass(cmd, &rp_info, VK_SUBPASS_CONTENTS_INLINE);
+        if (parallel)
+        {
+            // A subpass recorded from secondaries may only contain vkCmdExecuteCommands,
+            // so the draw and UI passes share one scope around the whole render pass.
+            GpuProfileScope scope{*m_gpu->gpu_profiler, cmd, slot, "draw"};
 
-        // --- Viewport / scissor ---
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = static_cast<float>(m_gpu->swapchain->extent().width);
-        viewport.height = static_cast<float>(m_gpu->swapchain->extent().height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        vkCmdSetViewport(cmd, 0, 1, &viewport);
+            vkCmdBeginRenderPass(cmd, &rp_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            record_draws_parallel(frame, image_index, vb, ib, batchCount);
+            vkCmdEndRenderPass(cmd);
+        }
+        else
+        {
+            vkCmdBeginRenderPass(cmd, &rp_info, VK_SUBPASS_CONTENTS_INLINE);
 
-        VkRect2D scissor{};
-        scissor.offset = {0, 0};
-        scissor.extent = m_gpu->swapchain->extent();
-        vkCmdSetScissor(cmd, 0, 1, &scissor);
+            set_viewport_scissor(cmd);
+
+            if (hasGeometry)
+            {
+                const IndirectDrawList gpuDraws =
+                    m_gpu->cull_pass ? m_gpu->cull_pass->draw_list(slot) : IndirectDrawList{};
+
+                {
+                    GpuProfileScope scope{*m_gpu->gpu_profiler, cmd, slot, "draw"};
+                    m_gpu->draw_pass->record(cmd,
+                                             frame,
+                                             image_index,
+                                             vb,
+                                             ib,
+                                             *m_gpu->draw_batcher,
+                                             *m_gpu->frame_allocator,
+                                             m_gpu->cull_pass ? &gpuDraws : nullptr);
+                }
+
+                {
+                    GpuProfileScope scope{*m_gpu->gpu_profiler, cmd, slot, "ui"};
+                    m_gpu->ui_pass->record(cmd,
+                                           frame,
+                                           image_index,
+                                           vb,
+                                           ib,
+                                           m_gpu->gpu_mesh_pool->draw_info(),
+                                           *m_gpu->scene_renderer);
+                }
+            }
 
-        if (!m_gpu->gpu_mesh_pool)
-        {
             vkCmdEndRenderPass(cmd);
-            frame.end();
-            return;
         }
 
-        m_gpu->gpu_mesh_pool->mark_used(signal);
+        m_gpu->gpu_profiler->end_frame(cmd, slot);
+        frame.end();
+    }
 
-        VkBuffer vb = m_gpu->gpu_mesh_pool->vertex_buffer();
-        VkBuffer ib = m_gpu->gpu_mesh_pool->index_buffer();
-        const auto &meshInfo = m_gpu->gpu_mesh_pool->draw_info();
+    void Renderer::record_draws_parallel(FrameContext &frame,
+                                         uint32_t image_index,
+                                         VkBuffer vertex_buffer,
+                                         const IndexBuffers &index_buffers,
+                                         uint32_t batch_count)
+    {
+        VkCommandBufferInheritanceInfo inheritance{};
+        inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance.renderPass = m_gpu->render_pass->handle();
+        inheritance.subpass = 0;
+        inheritance.framebuffer = target_framebuffer(image_index).handle();
+
+        const uint32_t slices = m_gpu->record_threads;
+        const uint32_t perSlice = (batch_count + slices - 1) / slices;
+
+        // One job per slice: each secondary (and its pool) is only touched by one thread.
+        // A single-threaded pool runs every slice inline in one call.
+        m_jobs->parallel_for(
+            0,
+            slices,
+            1,
+            [&](uint32_t firstTask, uint32_t lastTask)
+            {
+                for (uint32_t task = firstTask; task < lastTask; ++task)
+                {
+                    const uint32_t first = std::min(task * perSlice, batch_count);
+                    const uint32_t count = std::min(perSlice, batch_count - first);
+
+                    // Dynamic state is not inherited, so every secondary sets its own
+                    VkCommandBuffer secondary = frame.begin_secondary(task, inheritance);
+                    set_viewport_scissor(secondary);
+                    m_gpu->draw_pass->record_range(secondary,
+                                                   frame,
+                                                   vertex_buffer,
+                                                   index_buffers,
+                                                   *m_gpu->draw_batcher,
+                                                   first,
+                                                   count);
+                    frame.end_secondary(task);
+                }
+            });
 
-        if (vb != VK_NULL_HANDLE && ib != VK_NULL_HANDLE)
+        // UI goes last so it draws over the scene, as in the inline path
+        VkCommandBuffer ui = frame.begin_secondary(slices, inheritance);
+        set_viewport_scissor(ui);
+        m_gpu->ui_pass->record(ui,
+                               frame,
+                               image_index,
+                               vertex_buffer,
+                               index_buffers,
+                               m_gpu->gpu_mesh_pool->draw_info(),
+                               *m_gpu->scene_renderer);
+        frame.end_secondary(slices);
+
+        std::vector<VkCommandBuffer> secondaries(slices + 1);
+        for (uint32_t i = 0; i <= slices; ++i)
         {
-            m_gpu->draw_pass
-                ->record(cmd, frame, image_index, vb, ib, meshInfo, *m_gpu->scene_renderer);
-
-            m_gpu->ui_pass
-                ->record(cmd, frame, image_index, vb, ib, meshInfo, *m_gpu->scene_renderer);
+            secondaries[i] = frame.secondary(i);
         }
 
-        vkCmdEndRenderPass(cmd);
-        frame.end();
+        vkCmdExecuteCommands(frame.command_buffer(),
+                             static_cast<uint32_t>(secondaries.size()),
+                             secondaries.data());
+    }
+
+    void Renderer::set_viewport_scissor(VkCommandBuffer cmd) const
+    {
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(target_extent().width);
+        viewport.height = static_cast<float>(target_extent().height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+        VkRect2D scissor{};
+        scissor.offset = {0, 0};
+        scissor.extent = target_extent();
+        vkCmdSetScissor(cmd, 0, 1, &scissor);
     }
 
     void Renderer::update_uniform_buffer(FrameContext &frame, FrameSlot slot)
@@ -626,7 +935,7 @@ namespace ankh
             std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - start).count();
 
         // 1. Update scene (camera + renderable transforms)
-        m_gpu->scene_renderer->update_frame(frame, *m_gpu->swapchain, time);
+        m_gpu->scene_renderer->update_frame(frame, target_extent(), time);
 
         // 2. Build FrameUBO
         FrameUBO fubo{};
@@ -638,6 +947,9 @@ namespace ankh
         glm::vec3 lightDir = glm::normalize(glm::vec3(-1.0f, -1.0f, -1.0f));
         fubo.lightDir = glm::vec4(lightDir, 0.0f);
 
+        const Frustum frustum = Frustum::from_matrix(fubo.proj * fubo.view);
+        std::copy(frustum.planes.begin(), frustum.planes.end(), fubo.frustumPlanes);
+
         // =========================
         // Allocate transient UBO span from FrameAllocator
         // (begin_frame must have been called already in draw_frame)
@@ -650,12 +962,12 @@ namespace ankh
         ANKH_ASSERT(ubo.size == sizeof(FrameUBO));
         std::memcpy(ubo.cpu, &fubo, sizeof(FrameUBO));
 
-        auto &renderables = m_gpu->scene_renderer->renderables();
+        const auto &renderables = m_gpu->scene_renderer->renderables();
+        const auto &visible = m_gpu->scene_renderer->visible();
         auto &materials = m_gpu->scene_renderer->material_pool();
 
         const uint32_t capacity = frame.object_capacity();
-        const uint32_t requested = static_cast<uint32_t>(renderables.size());
-        const uint32_t count = std::min<uint32_t>(requested, capacity);
+        const uint32_t requested = renderables.size();
 
         if (requested > capacity)
         {
@@ -664,30 +976,81 @@ namespace ankh
                           "); extra objects will not be drawn this frame.");
         }
 
-        const VkDeviceSize objBytes = sizeof(ObjectDataGPU) * count;
-        auto obj = m_gpu->frame_allocator->alloc("ObjectDataGPU", objBytes, alignof(ObjectDataGPU));
+        // 3. Sort visible objects into instanced draw packets (reused while nothing changed);
+        //    instance slots follow packet order
+        const auto &drawTable = m_gpu->gpu_mesh_pool->draw_table();
+        m_gpu->draw_batcher->build(renderables,
+                                   visible,
+                                   m_gpu->scene_renderer->visible_lods(),
+                                   drawTable,
+                                   capacity,
+                                   m_gpu->scene_renderer->revision(),
+                                   m_gpu->gpu_mesh_pool->revision());
+
+        const auto &order = m_gpu->draw_batcher->order();
+        const uint32_t count = m_gpu->draw_batcher->object_count();
+
+        // 4. Instance slot -> object id, the only per-object data written every frame
+        //    (first span after the UBO, see object_base_in_slice)
+        auto instances = m_gpu->frame_allocator->alloc("InstanceObjects",
+                                                       sizeof(uint32_t) * count,
+                                                       alignof(uint32_t));
+        if (count != 0 && instances.cpu != nullptr)
+        {
+            std::memcpy(instances.cpu, order.data(), sizeof(uint32_t) * count);
+        }
 
-        auto *objData = reinterpret_cast<ObjectDataGPU *>(obj.cpu);
+        // 5. Upload the object records that changed since the last frame, and the material
+        //    table (records only hold material indices) when a material was edited
+        auto &objects = *m_gpu->object_buffer;
+        const auto &scene = *m_gpu->scene_renderer;
 
-        for (uint32_t i = 0; i < count; ++i)
+        auto &table = m_gpu->material_table;
+        if (table.size() != materials.size())
         {
-            const auto &r = renderables[i];
-
-            objData[i].model = r.transform;
+            table.resize(materials.size(), MaterialGPU{glm::vec4{1.0f}});
+            objects.mark_materials_dirty();
+        }
 
-            glm::vec4 albedo{1.0f};
-            if (materials.valid(r.material))
+        for (MaterialHandle h = 0; h < materials.size(); ++h)
+        {
+            const glm::vec4 a = materials.valid(h) ? materials.get(h).albedo() : glm::vec4{1.0f};
+            if (table[h].albedo != a)
             {
-                albedo = materials.get(r.material).albedo();
+                table[h].albedo = a;
+                objects.mark_materials_dirty();
             }
-            objData[i].albedo = albedo;
         }
 
+        if (scene.all_objects_changed() || scene.revision() != m_gpu->object_buffer_revision)
+        {
+            objects.mark_all_dirty(renderables.size());
+        }
+        else
+        {
+            objects.mark_dirty(scene.changed_objects());
+        }
+        m_gpu->object_buffer_revision = scene.revision();
+
+        objects.stage(*m_gpu->frame_allocator, renderables, table, *m_jobs);
+
         const VkDeviceSize frameCap = m_gpu->frame_allocator->frame_capacity();
         const VkDeviceSize frameBase = frameCap * static_cast<VkDeviceSize>(slot);
 
         frame.set_dynamic_offsets(static_cast<uint32_t>(frameBase),
                                   static_cast<uint32_t>(frameBase));
+
+        if (m_gpu->cull_pass)
+        {
+            m_gpu->cull_pass->prepare(slot,
+                                      *m_gpu->frame_allocator,
+                                      renderables,
+                                      order,
+                                      m_gpu->draw_batcher->lods(),
+                                      count,
+                                      drawTable,
+                                      m_gpu->gpu_mesh_pool->cluster_table());
+        }
     }
 
     void Renderer::draw_frame()
@@ -696,41 +1059,60 @@ namespace ankh
 
         auto &frame = m_gpu->frames[slot];
 
+        // Headless frames render into the offscreen image owned by this slot: no acquire,
+        // no semaphores and no present, so the loop is bound only by CPU and GPU work.
+        const bool presenting = (m_gpu->offscreen == nullptr);
+
+        using clock = std::chrono::steady_clock;
+
         VkFence fence = frame.in_flight_fence();
+        const auto waitStart = clock::now();
         ANKH_VK_CHECK(vkWaitForFences(m_context->device_handle(), 1, &fence, VK_TRUE, UINT64_MAX));
 
+        // CPU cost is timed from here, so GPU-bound frames don't show up as CPU time
+        const auto cpuStart = clock::now();
+        m_gpu->fence_wait_ms =
+            std::chrono::duration<double, std::milli>(cpuStart - waitStart).count();
+
         m_gpu->gpu_serial->mark_slot_completed(slot);
+        m_gpu->gpu_profiler->collect(slot);
 
         m_retirement_queue->collect(m_gpu->gpu_serial->completed(),
                                     m_gpu->async_uploader->completed_value());
 
-        uint32_t image_index = 0;
-        VkResult result = vkAcquireNextImageKHR(m_context->device_handle(),
-                                                m_gpu->swapchain->handle(),
-                                                ankh::config().acquireImageTimeoutNs,
-                                                frame.image_available(),
-                                                VK_NULL_HANDLE,
-                                                &image_index);
+        uint32_t image_index = slot;
+        VkResult result = VK_SUCCESS;
 
-        if (result == VK_TIMEOUT)
+        if (presenting)
         {
-            ANKH_LOG_WARN("[Renderer] Timed out while acquiring swapchain image; skipping frame");
-            return;
-        }
+            result = vkAcquireNextImageKHR(m_context->device_handle(),
+                                           m_gpu->swapchain->handle(),
+                                           ankh::config().acquireImageTimeoutNs,
+                                           frame.image_available(),
+                                           VK_NULL_HANDLE,
+                                           &image_index);
+
+            if (result == VK_TIMEOUT)
+            {
+                ANKH_LOG_WARN(
+                    "[Renderer] Timed out while acquiring swapchain image; skipping frame");
+                return;
+            }
 
-        if (result == VK_ERROR_OUT_OF_DATE_KHR)
-        {
-            m_window->set_framebuffer_resized(false);
-            recreate_swapchain();
-            return;
-        }
+            if (result == VK_ERROR_OUT_OF_DATE_KHR)
+            {
+                m_window->set_framebuffer_resized(false);
+                recreate_swapchain();
+                return;
+            }
 
-        else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
-        {
-            ANKH_THROW_MSG("Failed to acquire swapchain image");
-        }
+            else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+            {
+                ANKH_THROW_MSG("Failed to acquire swapchain image");
+            }
 
-        m_gpu->swapchain->wait_image_if_in_flight(m_context->device_handle(), image_index);
+            m_gpu->swapchain->wait_image_if_in_flight(m_context->device_handle(), image_index);
+        }
 
         // =========================
         // Issue serial EARLY (before writing transient data)
@@ -752,9 +1134,12 @@ namespace ankh
 
         ANKH_VK_CHECK(vkResetFences(m_context->device_handle(), 1, &fence));
 
-        m_gpu->swapchain->mark_image_in_flight(image_index, fence);
+        if (presenting)
+        {
+            m_gpu->swapchain->mark_image_in_flight(image_index, fence);
+        }
 
-        record_command_buffer(frame, image_index, GpuSignal::frame(frameId));
+        record_command_buffer(frame, slot, image_index, GpuSignal::frame(frameId));
 
         VkCommandBuffer cmd = frame.command_buffer();
 
@@ -765,18 +1150,27 @@ namespace ankh
 
         VkSubmitInfo submit{};
         submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit.waitSemaphoreCount = 1;
-        submit.pWaitSemaphores = &waitSem;
-        submit.pWaitDstStageMask = waitStages;
+        submit.waitSemaphoreCount = presenting ? 1u : 0u;
+        submit.pWaitSemaphores = presenting ? &waitSem : nullptr;
+        submit.pWaitDstStageMask = presenting ? waitStages : nullptr;
         submit.commandBufferCount = 1;
         submit.pCommandBuffers = &cmd;
-        submit.signalSemaphoreCount = 1;
-        submit.pSignalSemaphores = &signalSem;
+        submit.signalSemaphoreCount = presenting ? 1u : 0u;
+        submit.pSignalSemaphores = presenting ? &signalSem : nullptr;
 
         m_gpu->gpu_serial->mark_slot_used(slot, frameId);
 
         ANKH_VK_CHECK(vkQueueSubmit(m_context->graphics_queue(), 1, &submit, fence));
 
+        m_gpu->cpu_frame_ms =
+            std::chrono::duration<double, std::milli>(clock::now() - cpuStart).count();
+
+        if (!presenting)
+        {
+            m_gpu->frame_ring->advance();
+            return;
+        }
+
         VkPresentInfoKHR present{};
         present.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
         present.waitSemaphoreCount = 1;
@@ -848,14 +1242,13 @@ namespace ankh
 
         // Recreate draw passes with new pipeline references
         m_gpu->draw_pass = std::make_unique<DrawPass>(m_context->device_handle(),
-                                                      *m_gpu->swapchain,
                                                       *m_gpu->render_pass,
                                                       *m_gpu->graphics_pipeline,
-                                                      *m_gpu->pipeline_layout);
+                                                      *m_gpu->pipeline_layout,
+                                                      use_indirect_draw());
 
         // Recreate UI pass with new pipeline references
         m_gpu->ui_pass = std::make_unique<UiPass>(m_context->device_handle(),
-                                                  *m_gpu->swapchain,
                                                   *m_gpu->render_pass,
                                                   *m_gpu->graphics_pipeline,
                                                   *m_gpu->pipeline_layout);
@@ -866,6 +1259,23 @@ namespace ankh
 
     void Renderer::run()
     {
+        if (m_gpu->offscreen)
+        {
+            const uint32_t frames = ankh::config().headlessFrames;
+
+            ANKH_LOG_DEBUG("[Renderer] Running headless for " +
+                           (frames ? std::to_string(frames) : std::string("unlimited")) +
+                           " frames");
+
+            for (uint32_t i = 0; frames == 0 || i < frames; ++i)
+            {
+                draw_frame();
+            }
+
+            wait_for_all_frames();
+            return;
+        }
+
         while (!glfwWindowShouldClose(m_window->handle()))
         {
             glfwPollEvents();
@@ -875,6 +1285,145 @@ namespace ankh
         wait_for_all_frames();
     }
 
+    void Renderer::finish_frames()
+    {
+        wait_for_all_frames();
+
+        m_gpu->frame_ring->for_each_slot([this](FrameSlot slot)
+                                         { m_gpu->gpu_profiler->collect(slot); });
+    }
+
+    void Renderer::set_object_count(uint32_t count)
+    {
+        if (count > ankh::config().maxObjects)
+        {
+            ANKH_LOG_WARN("[Renderer] Object count " + std::to_string(count) +
+                          " exceeds maxObjects (" + std::to_string(ankh::config().maxObjects) +
+                          "); extra objects will not be drawn");
+        }
+
+        m_gpu->scene_renderer->set_object_count(count);
+    }
+
+    GpuProfiler &Renderer::gpu_profiler()
+    {
+        return *m_gpu->gpu_profiler;
+    }
+
+    std::string Renderer::device_name() const
+    {
+        return m_context->physical_device().properties().deviceName;
+    }
+
+    VkDeviceSize Renderer::object_base_in_slice() const
+    {
+        const auto props = m_context->physical_device().properties();
+
+        // Must match FrameAllocator::Limits::minAlignment (max of UBO/SSBO alignment)
+        const VkDeviceSize minAlignment =
+            std::max(static_cast<VkDeviceSize>(props.limits.minUniformBufferOffsetAlignment),
+                     static_cast<VkDeviceSize>(props.limits.minStorageBufferOffsetAlignment));
+
+        // Instance ids start after UBO, aligned to allocator alignment
+        return (sizeof(FrameUBO) + (minAlignment - 1)) & ~(minAlignment - 1);
+    }
+
+    bool Renderer::use_gpu_culling() const
+    {
+        return ankh::config().gpuCulling && use_indirect_draw();
+    }
+
+    uint32_t Renderer::visible_object_count() const
+    {
+        return static_cast<uint32_t>(m_gpu->scene_renderer->visible().size());
+    }
+
+    uint32_t Renderer::record_threads() const
+    {
+        return m_gpu->record_threads;
+    }
+
+    uint32_t Renderer::job_threads() const
+    {
+        return m_jobs->thread_count();
+    }
+
+    uint32_t Renderer::resolve_record_threads() const
+    {
+        if (use_indirect_draw())
+        {
+            return 1; // a handful of indirect calls; nothing worth splitting
+        }
+
+        if (ankh::config().recordThreads != 0)
+        {
+            return ankh::config().recordThreads;
+        }
+
+        // One slice per job thread; a few slices are enough to hide recording cost for
+        // typical draw counts.
+        return std::min(m_jobs->thread_count(), 8u);
+    }
+
+    uint32_t Renderer::draw_batch_count() const
+    {
+        return static_cast<uint32_t>(m_gpu->draw_batcher->packets().size());
+    }
+
+    uint32_t Renderer::draw_packets_rebuilt() const
+    {
+        return m_gpu->draw_batcher->packets_rebuilt();
+    }
+
+    uint32_t Renderer::changed_object_count() const
+    {
+        const SceneRenderer &scene = *m_gpu->scene_renderer;
+        return scene.all_objects_changed() ? scene.renderables().size()
+                                           : static_cast<uint32_t>(scene.changed_objects().size());
+    }
+
+    uint32_t Renderer::uploaded_object_count() const
+    {
+        return m_gpu->object_buffer->uploaded_objects();
+    }
+
+    double Renderer::last_cpu_frame_ms() const
+    {
+        return m_gpu->cpu_frame_ms;
+    }
+
+    double Renderer::last_fence_wait_ms() const
+    {
+        return m_gpu->fence_wait_ms;
+    }
+
+    uint64_t Renderer::vertex_buffer_bytes() const
+    {
+        return m_gpu->gpu_mesh_pool->vertex_bytes();
+    }
+
+    uint64_t Renderer::index_buffer_bytes() const
+    {
+        return m_gpu->gpu_mesh_pool->index_bytes();
+    }
+
+    bool Renderer::gpu_culling() const
+    {
+        return m_gpu->cull_pass != nullptr;
+    }
+
+    bool Renderer::indirect_draw() const
+    {
+        return m_gpu->draw_pass && m_gpu->draw_pass->indirect();
+    }
+
+    bool Renderer::use_indirect_draw() const
+    {
+        const Device &device = m_context->device();
+        return ankh::config().indirectDraw && device.multi_draw_indirect() &&
+               device.draw_indirect_first_instance();
+    }
+
     GpuResourceTracker *Renderer::tracker() const
     {
 #ifndef NDEBUG
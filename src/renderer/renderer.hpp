@@ -1,11 +1,13 @@
 // src/renderer/renderer.hpp
 #pragma once
 
+#include "renderer/mesh-draw-info.hpp"
 #include "scene/renderable.hpp"
 #include "utils/config.hpp"
 #include "utils/types.hpp"
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -20,6 +22,7 @@ namespace ankh
     class Device;
     class Surface;
     class Swapchain;
+    class OffscreenTargets;
     class RenderPass;
     class DescriptorSetLayout;
     class DescriptorPool;
@@ -30,6 +33,9 @@ namespace ankh
     class FrameContext;
     class AsyncUploader;
     class DrawPass;
+    class CullPass;
+    class ObjectBuffer;
+    class DrawBatcher;
     class FrameSync;
     class UiPass;
     class SceneRenderer;
@@ -42,6 +48,8 @@ namespace ankh
     class GpuRetirementQueue;
     class GpuSignal;
     class FrameAllocator;
+    class GpuProfiler;
+    class JobSystem;
     
   
     struct RendererGpuState
@@ -52,19 +60,29 @@ namespace ankh
 
         std::unique_ptr<UiPass> ui_pass;
         std::unique_ptr<DrawPass> draw_pass;
+        std::unique_ptr<CullPass> cull_pass;
         std::unique_ptr<GraphicsPipeline> graphics_pipeline;
         std::unique_ptr<PipelineLayout> pipeline_layout;
         std::unique_ptr<RenderPass> render_pass;
         std::unique_ptr<Swapchain> swapchain;
+        std::unique_ptr<OffscreenTargets> offscreen; // headless replacement for swapchain
 
         std::unique_ptr<AsyncUploader> async_uploader;
         std::unique_ptr<DescriptorPool> descriptor_pool;
         std::unique_ptr<DescriptorSetLayout> descriptor_set_layout;
 
         std::unique_ptr<SceneRenderer> scene_renderer;
+        std::unique_ptr<DrawBatcher> draw_batcher;
         std::unique_ptr<FrameRing> frame_ring;
         std::unique_ptr<GpuSerial> gpu_serial;
         std::unique_ptr<FrameAllocator> frame_allocator;
+        std::unique_ptr<ObjectBuffer> object_buffer;
+        std::unique_ptr<GpuProfiler> gpu_profiler;
+        uint32_t record_threads{1}; // secondary slices for direct draws (1 = inline)
+        std::vector<MaterialGPU> material_table; // per material handle, compared each frame
+        uint64_t object_buffer_revision{UINT64_MAX}; // scene revision of the uploaded records
+        double fence_wait_ms{0.0}; // last draw_frame's wait for its slot's fence
+        double cpu_frame_ms{0.0};  // last draw_frame from the fence wait through submit
     };
 
     class Renderer
@@ -75,6 +93,59 @@ namespace ankh
 
         void run();
 
+        // One iteration of the frame loop (headless or presented)
+        void draw_frame();
+
+        // Wait for every in-flight frame and resolve its GPU timings
+        void finish_frames();
+
+        // Replace the scene with 'count' copies of the loaded renderables (see SceneRenderer)
+        void set_object_count(uint32_t count);
+
+        GpuProfiler &gpu_profiler();
+
+        std::string device_name() const;
+
+        // True when DrawPass submits the scene through vkCmdDrawIndexedIndirect
+        bool indirect_draw() const;
+
+        // True when a compute pass frustum-culls objects before DrawPass
+        bool gpu_culling() const;
+
+        // Objects that passed SceneRenderer's CPU frustum test in the last frame
+        uint32_t visible_object_count() const;
+
+        // Instanced draws (DrawBatcher packets) in the last frame
+        uint32_t draw_batch_count() const;
+
+        // Draw packets recompiled in the last frame (0 when last frame's were reused)
+        uint32_t draw_packets_rebuilt() const;
+
+        // Renderables whose world transform changed in the last frame
+        uint32_t changed_object_count() const;
+
+        // Object records copied into the persistent ObjectBuffer in the last frame
+        uint32_t uploaded_object_count() const;
+
+        // CPU time of the last submitted frame: draw_frame after its fence wait, through
+        // vkQueueSubmit (includes the swapchain acquire when presenting)
+        double last_cpu_frame_ms() const;
+
+        // Time the last frame spent waiting for its frame slot's fence (GPU backpressure)
+        double last_fence_wait_ms() const;
+
+        // Bytes of encoded vertex data in the GPU mesh pool (see VertexFormat)
+        uint64_t vertex_buffer_bytes() const;
+
+        // Bytes of the 16- and 32-bit unified index buffers together
+        uint64_t index_buffer_bytes() const;
+
+        // Slices of direct draws recorded into secondary command buffers (1 = inline)
+        uint32_t record_threads() const;
+
+        // Threads in the JobSystem used for per-frame CPU work
+        uint32_t job_threads() const;
+
       private:
         void init_vulkan();
         void create_framebuffers();
@@ -83,19 +154,54 @@ namespace ankh
         void create_texture();
         void create_frames();
         
-        void record_command_buffer(FrameContext &frame, uint32_t image_index, GpuSignal signal);
-        
         using  FrameSlot = uint32_t;
+
+        void record_command_buffer(FrameContext &frame,
+                                   FrameSlot slot,
+                                   uint32_t image_index,
+                                   GpuSignal signal);
+
         void update_uniform_buffer(FrameContext &frame, FrameSlot slot);
 
-        void draw_frame();
+        // Inside a render pass begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS:
+        // split the draw batches across the JobSystem, one secondary per slice plus one
+        // for the UI, and execute them from the primary.
+        void record_draws_parallel(FrameContext &frame,
+                                   uint32_t image_index,
+                                   VkBuffer vertex_buffer,
+                                   const IndexBuffers &index_buffers,
+                                   uint32_t batch_count);
+
+        void set_viewport_scissor(VkCommandBuffer cmd) const;
+
         void recreate_swapchain();
+
+        // Current render target (swapchain or offscreen) independent of the presentation mode
+        VkExtent2D target_extent() const;
+        const Framebuffer &target_framebuffer(uint32_t image_index) const;
+
         void cleanup_swapchain();
         void wait_for_all_frames();
         void retire_swapchain_resources();
         GpuResourceTracker *tracker() const;
 
+        // Config::indirectDraw and the device supports multi-draw indirect with firstInstance
+        bool use_indirect_draw() const;
+
+        // Config::gpuCulling and the indirect path is available
+        bool use_gpu_culling() const;
+
+        // Config::recordThreads resolved against the hardware; parallel recording only
+        // applies to the direct (one vkCmdDrawIndexed per object) path.
+        uint32_t resolve_record_threads() const;
+
+        // Offset of the instance object ids within a FrameAllocator slice (after the aligned
+        // FrameUBO)
+        VkDeviceSize object_base_in_slice() const;
+
       private:
+        std::unique_ptr<JobSystem> m_jobs; // outlives m_gpu
+
         std::unique_ptr<Context> m_context;
 
         std::unique_ptr<GpuRetirementQueue> m_retirement_queue;
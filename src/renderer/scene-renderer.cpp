@@ -2,12 +2,19 @@
 #include "scene-renderer.hpp"
 
 #include "frame/frame-context.hpp"
+#include "jobs/job-system.hpp"
 #include "scene/camera.hpp"
 #include "scene/material.hpp"
-#include "swapchain/swapchain.hpp"
+#include "scene/transform-kernels.hpp"
+#include "utils/config.hpp"
 #include "utils/types.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <limits>
+#include <numeric>
+#include <utility>
 #include <utils/logging.hpp>
 
 namespace ankh
@@ -25,27 +32,298 @@ namespace ankh
 
     SceneRenderer::~SceneRenderer() = default;
 
-    void SceneRenderer::update_frame(FrameContext &, const Swapchain &swapchain, float time)
+    void SceneRenderer::update_frame(FrameContext &, VkExtent2D extent, float time)
     {
-        float aspect = static_cast<float>(swapchain.extent().width) /
-                       static_cast<float>(swapchain.extent().height);
+        float aspect = static_cast<float>(extent.width) / static_cast<float>(extent.height);
 
         m_camera->set_aspect(aspect);
 
-        int i = 0;
+        // Changes since the last frame (including propagate_transforms calls in between)
+        propagate_transforms();
 
-        for (auto &r : m_renderables)
+        m_changed_objects.swap(m_pending_objects);
+        m_pending_objects.clear();
+        m_all_changed = std::exchange(m_pending_all, false);
+
+        const glm::mat4 *base = m_renderables.base_transforms();
+        glm::mat4 *world = m_renderables.world_transforms();
+
+        if (ankh::config().animate)
+        {
+            // rotate around Y and X so you really see depth; the spin is the same for every
+            // object, so it is built once and each world transform is a single base * spin
+            glm::mat4 spin{1.0f};
+            spin = glm::rotate(spin, time * 0.8f, glm::vec3(0.0f, 1.0f, 0.0f));
+            spin = glm::rotate(spin, time * 0.4f, glm::vec3(1.0f, 0.0f, 0.0f));
+
+            for_range(m_jobs,
+                      m_renderables.size(),
+                      kTransformGrain,
+                      [&](uint32_t first, uint32_t last)
+                      { multiply_transforms(base + first, spin, world + first, last - first); });
+
+            m_all_changed = true;
+        }
+        else if (m_all_changed)
+        {
+            std::copy(base, base + m_renderables.size(), world);
+        }
+        else
+        {
+            for (uint32_t i : m_changed_objects)
+            {
+                world[i] = base[i];
+            }
+        }
+
+        update_spatial_index();
+
+        if (ankh::config().cpuCulling)
+        {
+            cull(Frustum::from_matrix(m_camera->proj() * m_camera->view()));
+        }
+        else
+        {
+            m_visible.resize(m_renderables.size());
+            std::iota(m_visible.begin(), m_visible.end(), 0u);
+        }
+
+        select_lods(extent);
+    }
+
+    void SceneRenderer::propagate_transforms()
+    {
+        m_hierarchy.update();
+
+        if (m_node_map_revision != m_revision || m_node_map_objects != m_renderables.size() ||
+            m_node_object_offsets.size() != m_hierarchy.size() + 1)
         {
-            // rotate around Y and X so you really see depth
-            glm::mat4 m = r.base_transform;
-            m = glm::rotate(m, time * 0.8f, glm::vec3(0.0f, 1.0f, 0.0f));
-            m = glm::rotate(m, time * 0.4f, glm::vec3(1.0f, 0.0f, 0.0f));
-            r.transform = m;
+            // New objects or attachments: rebuild the node -> objects map and resync everyone
+            rebuild_node_map();
+            m_pending_all = true;
 
-            ++i;
+            for (uint32_t i = 0; i < m_renderables.size(); ++i)
+            {
+                const NodeHandle node = m_renderables.node(i);
+                if (node != INVALID_NODE_HANDLE)
+                {
+                    m_renderables.set_base_transform(i, m_hierarchy.world_transform(node));
+                }
+            }
+            return;
+        }
+
+        for (NodeHandle node : m_hierarchy.changed())
+        {
+            for (uint32_t k = m_node_object_offsets[node]; k < m_node_object_offsets[node + 1]; ++k)
+            {
+                const uint32_t object = m_node_objects[k];
+                m_renderables.set_base_transform(object, m_hierarchy.world_transform(node));
+                m_pending_objects.push_back(object);
+            }
         }
     }
 
+    void SceneRenderer::rebuild_node_map()
+    {
+        const uint32_t nodes = m_hierarchy.size();
+
+        m_node_object_offsets.assign(nodes + 1, 0);
+        m_node_objects.clear();
+
+        for (uint32_t i = 0; i < m_renderables.size(); ++i)
+        {
+            const NodeHandle node = m_renderables.node(i);
+            if (node < nodes)
+            {
+                ++m_node_object_offsets[node + 1];
+            }
+        }
+
+        for (uint32_t n = 0; n < nodes; ++n)
+        {
+            m_node_object_offsets[n + 1] += m_node_object_offsets[n];
+        }
+
+        m_node_objects.resize(m_node_object_offsets[nodes]);
+
+        std::vector<uint32_t> cursor(m_node_object_offsets.begin(), m_node_object_offsets.end() - 1);
+        for (uint32_t i = 0; i < m_renderables.size(); ++i)
+        {
+            const NodeHandle node = m_renderables.node(i);
+            if (node < nodes)
+            {
+                m_node_objects[cursor[node]++] = i;
+            }
+        }
+
+        m_node_map_revision = m_revision;
+        m_node_map_objects = m_renderables.size();
+    }
+
+    void SceneRenderer::update_world_bounds(uint32_t i)
+    {
+        const MeshHandle mesh = m_renderables.mesh(i);
+
+        if (!m_mesh_pool.valid(mesh) || !m_mesh_pool.bounds(mesh).valid)
+        {
+            m_world_bounds[i] = Aabb{}; // empty: never returned by BVH queries
+            return;
+        }
+
+        const MeshBounds &bounds = m_mesh_pool.bounds(mesh);
+        m_world_bounds[i] = Aabb::transformed(m_renderables.world_transform(i), bounds.min, bounds.max);
+    }
+
+    void SceneRenderer::update_spatial_index()
+    {
+        const uint32_t n = m_renderables.size();
+        const bool rebuild = m_bvh_revision != m_revision || m_world_bounds.size() != n;
+
+        // World boxes, one per renderable, kept across frames: only objects moved since the
+        // last frame are refreshed
+        if (rebuild || m_all_changed)
+        {
+            m_world_bounds.resize(n);
+
+            for_range(m_jobs,
+                      n,
+                      kTransformGrain,
+                      [&](uint32_t first, uint32_t last)
+                      {
+                          for (uint32_t i = first; i < last; ++i)
+                          {
+                              update_world_bounds(i);
+                          }
+                      });
+        }
+        else
+        {
+            for (uint32_t i : m_changed_objects)
+            {
+                update_world_bounds(i);
+            }
+        }
+
+        if (!rebuild)
+        {
+            if (m_all_changed)
+            {
+                m_bvh.refit(m_world_bounds.data());
+            }
+            else if (!m_changed_objects.empty())
+            {
+                m_bvh.refit(m_world_bounds.data(), m_changed_objects);
+            }
+
+            // Refitting keeps the topology; once motion has blown the root up, rebuild
+            const bool degraded =
+                !m_bvh.empty() &&
+                Aabb{m_bvh.nodes()[0].min, m_bvh.nodes()[0].max}.half_area() >
+                    kBvhRebuildGrowth * m_bvh_built_area;
+
+            if (!degraded)
+            {
+                return;
+            }
+        }
+
+        m_bvh.build(m_world_bounds.data(), n);
+        m_bvh_revision = m_revision;
+        m_bvh_built_area =
+            m_bvh.empty() ? 0.0f : Aabb{m_bvh.nodes()[0].min, m_bvh.nodes()[0].max}.half_area();
+    }
+
+    void SceneRenderer::cull(const Frustum &frustum)
+    {
+        m_visible.clear();
+        m_bvh.query_frustum(frustum, m_visible);
+    }
+
+    void SceneRenderer::select_lods(VkExtent2D extent)
+    {
+        const uint32_t count = static_cast<uint32_t>(m_visible.size());
+        m_visible_lods.assign(count, 0);
+
+        if (ankh::config().lodLevels == 0 || count == 0 || m_world_bounds.empty())
+        {
+            return;
+        }
+
+        // A mesh-local error e on an object with scale s at distance d covers about
+        // e * s * pixelsPerUnit / d pixels
+        const float pixelsPerUnit =
+            static_cast<float>(extent.height) / (2.0f * std::tan(0.5f * m_camera->fov()));
+        const float tolerance = ankh::config().lodPixelError / pixelsPerUnit;
+        const glm::vec3 eye = m_camera->position();
+
+        for_range(m_jobs,
+                  count,
+                  kTransformGrain,
+                  [&](uint32_t first, uint32_t last)
+                  {
+                      for (uint32_t i = first; i < last; ++i)
+                      {
+                          const uint32_t object = m_visible[i];
+                          const MeshHandle mesh = m_renderables.mesh(object);
+                          const Aabb &box = m_world_bounds[object];
+
+                          if (!m_mesh_pool.valid(mesh) || box.empty())
+                          {
+                              continue;
+                          }
+
+                          const std::vector<MeshLod> &lods = m_mesh_pool.get(mesh).lods();
+                          if (lods.empty())
+                          {
+                              continue;
+                          }
+
+                          // Closest point of the world box: never coarser than any part of
+                          // the object warrants; 0 (camera inside) keeps the full mesh
+                          const float distance =
+                              glm::length(eye - glm::clamp(eye, box.min, box.max));
+
+                          const glm::mat4 &m = m_renderables.world_transform(object);
+                          const float scale = std::sqrt(std::max({glm::dot(m[0], m[0]),
+                                                                  glm::dot(m[1], m[1]),
+                                                                  glm::dot(m[2], m[2])}));
+
+                          const float limit = tolerance * distance;
+
+                          // Errors grow with the level, so stop at the first one too coarse
+                          uint8_t level = 0;
+                          while (level < lods.size() && lods[level].error * scale <= limit)
+                          {
+                              ++level;
+                          }
+
+                          m_visible_lods[i] = level;
+                      }
+                  });
+    }
+
+    std::optional<uint32_t> SceneRenderer::pick(const glm::vec2 &ndc) const
+    {
+        // Ray from the eye through the point on the far plane under 'ndc'
+        const glm::mat4 inv = glm::inverse(m_camera->proj() * m_camera->view());
+        const glm::vec4 far = inv * glm::vec4(ndc, 1.0f, 1.0f);
+
+        const glm::vec3 origin = m_camera->position();
+        const glm::vec3 direction = glm::normalize(glm::vec3(far) / far.w - origin);
+
+        if (const auto hit = m_bvh.raycast(origin, direction))
+        {
+            return hit->primitive;
+        }
+        return std::nullopt;
+    }
+
+    void SceneRenderer::query_box(const Aabb &box, std::vector<uint32_t> &out) const
+    {
+        m_bvh.query_aabb(box, out);
+    }
+
     SceneBounds SceneRenderer::compute_scene_bounds() const
     {
         SceneBounds result{};
@@ -64,27 +342,32 @@ namespace ankh
 
         bool any = false;
 
-        for (const auto &r : m_renderables)
+        for (uint32_t i = 0; i < m_renderables.size(); ++i)
         {
-            if (!m_mesh_pool.valid(r.mesh))
+            const MeshHandle mesh = m_renderables.mesh(i);
+
+            if (!m_mesh_pool.valid(mesh))
             {
                 continue;
             }
 
-            const Mesh &mesh = m_mesh_pool.get(r.mesh);
-            const auto &verts = mesh.vertices();
+            const MeshBounds &bounds = m_mesh_pool.bounds(mesh);
 
-            if (verts.empty())
+            if (!bounds.valid)
             {
                 continue;
             }
 
-            const glm::mat4 M = r.base_transform; // use base transform for framing
+            const glm::mat4 &M = m_renderables.base_transform(i); // base transform for framing
 
-            for (const auto &v : verts)
+            // Corners of the cached mesh AABB; exact for translate/scale, conservative otherwise
+            for (int corner = 0; corner < 8; ++corner)
             {
-                glm::vec4 wp4 = M * glm::vec4(v.pos, 1.0f);
-                glm::vec3 p = glm::vec3(wp4);
+                const glm::vec3 local{(corner & 1) ? bounds.max.x : bounds.min.x,
+                                      (corner & 2) ? bounds.max.y : bounds.min.y,
+                                      (corner & 4) ? bounds.max.z : bounds.min.z};
+
+                const glm::vec3 p = glm::vec3(M * glm::vec4(local, 1.0f));
 
                 globalMin = glm::min(globalMin, p);
                 globalMax = glm::max(globalMax, p);
@@ -103,4 +386,99 @@ namespace ankh
         return result;
     }
 
+    void SceneRenderer::frame_camera(const SceneBounds &bounds)
+    {
+        if (!bounds.valid)
+        {
+            return;
+        }
+
+        glm::vec3 center = 0.5f * (bounds.min + bounds.max);
+        float radius = glm::length(bounds.max - bounds.min) * 0.5f;
+
+        // simple heuristic distance; works for most scenes
+        float distance = (radius > 0.0f) ? radius * 2.5f : 5.0f;
+
+        m_camera->set_target(center);
+        m_camera->set_position(center + glm::vec3(distance, distance, distance));
+    }
+
+    void SceneRenderer::set_object_count(uint32_t count)
+    {
+        if (m_prototypes.empty())
+        {
+            // Flattened: each prototype keeps its current world transform
+            m_prototypes.reserve(m_renderables.size());
+            for (uint32_t i = 0; i < m_renderables.size(); ++i)
+            {
+                m_prototypes.push_back(m_renderables.get(i));
+            }
+            m_prototype_bounds = compute_scene_bounds();
+        }
+
+        m_renderables.clear();
+        m_hierarchy.clear();
+        mark_changed();
+
+        if (m_prototypes.empty() || count == 0)
+        {
+            return;
+        }
+
+        const uint32_t perCopy = static_cast<uint32_t>(m_prototypes.size());
+        const uint32_t copies = (count + perCopy - 1) / perCopy;
+        const uint32_t side =
+            static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(copies))));
+
+        // Cell size: largest horizontal extent of the original scene plus a 25% gap
+        float spacing = 2.0f;
+        if (m_prototype_bounds.valid)
+        {
+            const glm::vec3 size = m_prototype_bounds.max - m_prototype_bounds.min;
+            spacing = std::max({size.x, size.z, 1e-3f}) * 1.25f;
+        }
+
+        const float half = 0.5f * static_cast<float>(side - 1) * spacing;
+
+        glm::vec3 offsetMin(std::numeric_limits<float>::max());
+        glm::vec3 offsetMax(-std::numeric_limits<float>::max());
+
+        m_renderables.reserve(count);
+        m_hierarchy.reserve(copies + count);
+
+        // One root node per grid cell, holding the cell offset ...
+        for (uint32_t copy = 0; copy < copies; ++copy)
+        {
+            const glm::vec3 offset{static_cast<float>(copy % side) * spacing - half,
+                                   0.0f,
+                                   static_cast<float>(copy / side) * spacing - half};
+
+            offsetMin = glm::min(offsetMin, offset);
+            offsetMax = glm::max(offsetMax, offset);
+
+            m_hierarchy.add(INVALID_NODE_HANDLE, glm::translate(glm::mat4(1.0f), offset));
+        }
+
+        // ... and one child per object, so a whole copy moves with its root
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Renderable r = m_prototypes[i % perCopy];
+            r.node = m_hierarchy.add(i / perCopy, r.base_transform);
+
+            m_renderables.add(r);
+        }
+
+        propagate_transforms();
+
+        if (m_prototype_bounds.valid)
+        {
+            SceneBounds grid{};
+            grid.min = m_prototype_bounds.min + offsetMin;
+            grid.max = m_prototype_bounds.max + offsetMax;
+            grid.valid = true;
+
+            frame_camera(grid);
+        }
+    }
+
 } // namespace ankh
@@ -1,11 +1,16 @@
 // src/renderer/scene-renderer.hpp
 #pragma once
 
+#include "scene/bvh.hpp"
 #include "scene/material-pool.hpp"
+#include "scene/frustum.hpp"
 #include "scene/mesh-pool.hpp"
+#include "scene/renderable-store.hpp"
 #include "scene/renderable.hpp"
+#include "scene/transform-hierarchy.hpp"
 #include "utils/types.hpp"
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace ankh
@@ -18,9 +23,9 @@ namespace ankh
     };
 
     class FrameContext;
-    class Swapchain;
     class Camera;
     class Material;
+    class JobSystem;
 
     class SceneRenderer
     {
@@ -29,8 +34,66 @@ namespace ankh
         ~SceneRenderer();
 
         // Update per-frame UBO (model/view/proj) and write it into FrameContext's uniform buffer.
+        // 'extent' is the current render target size (swapchain or offscreen).
         // 'time' is seconds since start (or any animation time).
-        void update_frame(FrameContext &frame, const Swapchain &swapchain, float time);
+        // Rebuilds the visible list afterwards (see visible()).
+        void update_frame(FrameContext &frame, VkExtent2D extent, float time);
+
+        // Spread the per-renderable loops of update_frame/cull over 'jobs' (null = serial)
+        void set_job_system(JobSystem *jobs)
+        {
+            m_jobs = jobs;
+        }
+
+        // Rebuild the visible list: renderables whose world box is not outside 'frustum',
+        // in BVH traversal order. Uses the spatial index as of the last update_frame.
+        void cull(const Frustum &frustum);
+
+        // Renderable under 'ndc' (x, y in [-1, 1]) closest to the camera, by world box
+        std::optional<uint32_t> pick(const glm::vec2 &ndc) const;
+
+        // Appends renderables whose world box overlaps 'box'
+        void query_box(const Aabb &box, std::vector<uint32_t> &out) const;
+
+        // BVH over renderable world boxes, refreshed by update_frame: rebuilt when the
+        // renderable list changes, refit for moved objects otherwise
+        const Bvh &bvh() const
+        {
+            return m_bvh;
+        }
+
+        // Recompute world transforms below hierarchy nodes changed since the last call and
+        // copy them to the attached renderables' base transforms. update_frame calls it;
+        // call it directly when base transforms are needed before the next frame.
+        void propagate_transforms();
+
+        // Renderables whose world transform changed in the last update_frame (see also
+        // all_objects_changed(), which makes this list meaningless when set)
+        const std::vector<uint32_t> &changed_objects() const
+        {
+            return m_changed_objects;
+        }
+
+        // True when every renderable changed in the last update_frame (animation, or the
+        // renderable list itself changed)
+        bool all_objects_changed() const
+        {
+            return m_all_changed;
+        }
+
+        // Indices into renderables() to draw this frame; DrawBatcher sorts them into
+        // instance slots that look up the objects' ObjectBuffer records.
+        const std::vector<uint32_t> &visible() const
+        {
+            return m_visible;
+        }
+
+        // Level of detail per visible() entry (0 = full mesh, see Mesh::lods): the coarsest
+        // level whose simplification error projects to at most Config::lodPixelError pixels
+        const std::vector<uint8_t> &visible_lods() const
+        {
+            return m_visible_lods;
+        }
 
         Camera &camera()
         {
@@ -76,27 +139,99 @@ namespace ankh
             return m_default_material;
         }
 
-        std::vector<Renderable> &renderables()
+        RenderableStore &renderables()
         {
             return m_renderables;
         }
 
-        const std::vector<Renderable> &renderables() const
+        const RenderableStore &renderables() const
         {
             return m_renderables;
         }
 
+        // Node tree driving the base transforms of attached renderables
+        // (Renderable::node). Move things with set_local_transform.
+        TransformHierarchy &hierarchy()
+        {
+            return m_hierarchy;
+        }
+
+        const TransformHierarchy &hierarchy() const
+        {
+            return m_hierarchy;
+        }
+
+        // Bumped whenever the renderable list changes shape (count, mesh, material or node
+        // handles); not for transform updates. Call mark_changed() after editing
+        // renderables() directly.
+        uint64_t revision() const
+        {
+            return m_revision;
+        }
+
+        void mark_changed()
+        {
+            ++m_revision;
+        }
+
         SceneBounds compute_scene_bounds() const;
 
+        // Point the camera at 'bounds' from a distance that keeps the whole box in view.
+        void frame_camera(const SceneBounds &bounds);
+
+        // Replace the renderables with 'count' objects: copies of the originally loaded
+        // renderables laid out on an XZ grid. The camera is re-framed around the grid.
+        // Used to sweep scene sizes (ankh_bench).
+        void set_object_count(uint32_t count);
+
+      private:
+        // Renderables per job for transform and world box updates
+        static constexpr uint32_t kTransformGrain = 512;
+
+        // Rebuild the BVH once refits have grown the root's surface area by this factor
+        static constexpr float kBvhRebuildGrowth = 2.0f;
+
+        void rebuild_node_map();
+        void update_world_bounds(uint32_t index);
+        void update_spatial_index();
+        void select_lods(VkExtent2D extent);
+
       private:
         std::unique_ptr<Camera> m_camera;
+        JobSystem *m_jobs{nullptr};
 
         MeshPool m_mesh_pool;
         MaterialPool m_material_pool;
 
         MaterialHandle m_default_material;
 
-        std::vector<Renderable> m_renderables;
+        RenderableStore m_renderables;
+        TransformHierarchy m_hierarchy;
+
+        // Renderables attached to each node: m_node_objects[offsets[n], offsets[n + 1])
+        std::vector<uint32_t> m_node_object_offsets;
+        std::vector<uint32_t> m_node_objects;
+        uint64_t m_node_map_revision{UINT64_MAX};
+        uint32_t m_node_map_objects{0};
+
+        // Changed renderables: collected by propagate_transforms, published per frame
+        std::vector<uint32_t> m_pending_objects;
+        bool m_pending_all{false};
+        std::vector<uint32_t> m_changed_objects;
+        bool m_all_changed{true};
+        std::vector<uint32_t> m_visible;
+        std::vector<uint8_t> m_visible_lods;
+        uint64_t m_revision{0};
+
+        // World boxes indexed like m_renderables and the BVH built over them
+        std::vector<Aabb> m_world_bounds;
+        Bvh m_bvh;
+        uint64_t m_bvh_revision{UINT64_MAX};
+        float m_bvh_built_area{0.0f};
+
+        // Snapshot of the loaded scene taken by the first set_object_count call
+        std::vector<Renderable> m_prototypes;
+        SceneBounds m_prototype_bounds{};
     };
 
 } // namespace ankh
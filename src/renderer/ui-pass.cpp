@@ -6,18 +6,15 @@
 #include "pipeline/pipeline-layout.hpp"
 #include "renderer/scene-renderer.hpp"
 #include "renderpass/render-pass.hpp"
-#include "swapchain/swapchain.hpp"
 
 namespace ankh
 {
 
     UiPass::UiPass(VkDevice device,
-                   const Swapchain &swapchain,
                    const RenderPass &render_pass,
                    const GraphicsPipeline &pipeline,
                    const PipelineLayout &layout)
         : m_device(device)
-        , m_swapchain(swapchain)
         , m_render_pass(render_pass)
         , m_pipeline(pipeline)
         , m_layout(layout)
@@ -28,7 +25,7 @@ namespace ankh
                         FrameContext & /*frame*/,
                         uint32_t /*image_index*/,
                         VkBuffer /*vertex_buffer*/,
-                        VkBuffer /*index_buffer*/,
+                        const IndexBuffers & /*index_buffers*/,
                         const std::unordered_map<MeshHandle, MeshDrawInfo> & /*mesh_draw_info*/,
                         SceneRenderer & /*scene_renderer*/)
     {
@@ -9,7 +9,6 @@
 
 namespace ankh
 {
-    class Swapchain;
     class RenderPass;
     class GraphicsPipeline;
     class PipelineLayout;
@@ -21,7 +20,6 @@ namespace ankh
     {
       public:
         UiPass(VkDevice device,
-               const Swapchain &swapchain,
                const RenderPass &render_pass,
                const GraphicsPipeline &pipeline,
                const PipelineLayout &layout);
@@ -30,13 +28,12 @@ namespace ankh
                     FrameContext &frame,
                     uint32_t image_index,
                     VkBuffer vertex_buffer,
-                    VkBuffer index_buffer,
+                    const IndexBuffers &index_buffers,
                     const std::unordered_map<MeshHandle, MeshDrawInfo> &mesh_draw_info,
                     SceneRenderer &scene_renderer);
 
       private:
         VkDevice m_device{VK_NULL_HANDLE};
-        const Swapchain &m_swapchain;
         const RenderPass &m_render_pass;
         const GraphicsPipeline &m_pipeline;
         const PipelineLayout &m_layout;
@@ -5,7 +5,9 @@
 namespace ankh
 {
 
-    RenderPass::RenderPass(VkDevice device, VkFormat swapchain_format)
+    RenderPass::RenderPass(VkDevice device,
+                           VkFormat swapchain_format,
+                           VkImageLayout color_final_layout)
         : m_device(device)
     {
 
@@ -17,7 +19,7 @@ namespace ankh
         color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         color.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        color.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        color.finalLayout = color_final_layout;
 
         VkAttachmentReference colorRef{};
         colorRef.attachment = 0;
@@ -7,7 +7,11 @@ namespace ankh
     class RenderPass
     {
     public:
-        RenderPass(VkDevice device, VkFormat swapchain_format);
+        // color_final_layout is PRESENT_SRC for swapchain targets; offscreen targets
+        // keep their image around as a transfer source instead.
+        RenderPass(VkDevice device,
+                   VkFormat swapchain_format,
+                   VkImageLayout color_final_layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
         ~RenderPass();
 
         VkRenderPass handle() const { return m_render_pass; }
@@ -0,0 +1,493 @@
+// src/scene/bvh.cpp
+#include "scene/bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace ankh
+{
+
+    namespace
+    {
+        constexpr uint32_t kNone = UINT32_MAX;
+        constexpr uint32_t kInsideBit = 0x80000000u; // query_frustum: subtree needs no tests
+
+        // Entry distance of the ray into the box, or +inf on a miss
+        float ray_box(const glm::vec3 &origin,
+                      const glm::vec3 &inv_dir,
+                      const glm::vec3 &min,
+                      const glm::vec3 &max,
+                      float max_t)
+        {
+            const glm::vec3 t0 = (min - origin) * inv_dir;
+            const glm::vec3 t1 = (max - origin) * inv_dir;
+
+            const glm::vec3 tmin = glm::min(t0, t1);
+            const glm::vec3 tmax = glm::max(t0, t1);
+
+            const float enter = std::max({tmin.x, tmin.y, tmin.z, 0.0f});
+            const float exit = std::min({tmax.x, tmax.y, tmax.z, max_t});
+
+            return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+        }
+    } // namespace
+
+    Aabb Aabb::transformed(const glm::mat4 &m, const glm::vec3 &min, const glm::vec3 &max)
+    {
+        const glm::vec3 center = 0.5f * (min + max);
+        const glm::vec3 extent = 0.5f * (max - min);
+
+        const glm::vec3 c = glm::vec3(m * glm::vec4(center, 1.0f));
+        const glm::vec3 e{
+            std::abs(m[0][0]) * extent.x + std::abs(m[1][0]) * extent.y + std::abs(m[2][0]) * extent.z,
+            std::abs(m[0][1]) * extent.x + std::abs(m[1][1]) * extent.y + std::abs(m[2][1]) * extent.z,
+            std::abs(m[0][2]) * extent.x + std::abs(m[1][2]) * extent.y + std::abs(m[2][2]) * extent.z};
+
+        Aabb result;
+        result.min = c - e;
+        result.max = c + e;
+        return result;
+    }
+
+    void Bvh::build(const Aabb *bounds, uint32_t count)
+    {
+        m_nodes.clear();
+        m_indices.clear();
+        m_parent.clear();
+
+        m_prim_slot.assign(count, kNone);
+        m_prim_leaf.assign(count, kNone);
+        m_centroids.resize(count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!bounds[i].empty())
+            {
+                m_indices.push_back(i);
+                m_centroids[i] = 0.5f * (bounds[i].min + bounds[i].max);
+            }
+        }
+
+        const uint32_t n = static_cast<uint32_t>(m_indices.size());
+        if (n == 0)
+        {
+            m_leaf_bounds.clear();
+            m_refit_stamp.clear();
+            return;
+        }
+
+        m_nodes.reserve(2 * n);
+        m_parent.reserve(2 * n);
+
+        m_nodes.push_back(Node{{}, 0, {}, n});
+        m_parent.push_back(kNone);
+
+        // Boxes in m_indices order; partitioning below permutes both together
+        m_leaf_bounds.resize(n);
+        for (uint32_t k = 0; k < n; ++k)
+        {
+            m_leaf_bounds[k] = bounds[m_indices[k]];
+        }
+
+        std::vector<uint32_t> stack{0};
+        while (!stack.empty())
+        {
+            const uint32_t node = stack.back();
+            stack.pop_back();
+            subdivide(node, stack);
+        }
+
+        for (uint32_t k = 0; k < n; ++k)
+        {
+            m_prim_slot[m_indices[k]] = k;
+        }
+
+        for (uint32_t node = 0; node < static_cast<uint32_t>(m_nodes.size()); ++node)
+        {
+            const Node &nd = m_nodes[node];
+            for (uint32_t k = nd.first; nd.count != 0 && k < nd.first + nd.count; ++k)
+            {
+                m_prim_leaf[m_indices[k]] = node;
+            }
+        }
+
+        m_refit_stamp.assign(m_nodes.size(), m_refit_epoch);
+    }
+
+    void Bvh::subdivide(uint32_t node_index, std::vector<uint32_t> &stack)
+    {
+        const uint32_t first = m_nodes[node_index].first;
+        const uint32_t count = m_nodes[node_index].count;
+
+        Aabb box;
+        Aabb centroidBox;
+        for (uint32_t k = first; k < first + count; ++k)
+        {
+            box.grow(m_leaf_bounds[k]);
+            centroidBox.grow(m_centroids[m_indices[k]]);
+        }
+
+        m_nodes[node_index].min = box.min;
+        m_nodes[node_index].max = box.max;
+
+        if (count <= kMaxLeafSize)
+        {
+            return;
+        }
+
+        // Binned SAH over the centroid bounds: cost = 1 (traversal) + sum(N * area) / area
+        struct Bin
+        {
+            Aabb box;
+            uint32_t count{0};
+        };
+
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        uint32_t bestSplit = 0;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float lo = centroidBox.min[axis];
+            const float extent = centroidBox.max[axis] - lo;
+            if (extent <= 0.0f)
+            {
+                continue;
+            }
+
+            const float scale = static_cast<float>(kBins) / extent;
+
+            std::array<Bin, kBins> bins{};
+            for (uint32_t k = first; k < first + count; ++k)
+            {
+                const float c = m_centroids[m_indices[k]][axis];
+                const uint32_t b = std::min(kBins - 1, static_cast<uint32_t>((c - lo) * scale));
+                bins[b].box.grow(m_leaf_bounds[k]);
+                ++bins[b].count;
+            }
+
+            // Sweep from the right, then from the left, over the kBins - 1 split planes
+            std::array<float, kBins - 1> rightCost{};
+            Aabb acc;
+            uint32_t accCount = 0;
+            for (uint32_t b = kBins - 1; b > 0; --b)
+            {
+                acc.grow(bins[b].box);
+                accCount += bins[b].count;
+                rightCost[b - 1] = accCount == 0 ? 0.0f : accCount * acc.half_area();
+            }
+
+            acc = Aabb{};
+            accCount = 0;
+            for (uint32_t s = 0; s < kBins - 1; ++s)
+            {
+                acc.grow(bins[s].box);
+                accCount += bins[s].count;
+
+                if (accCount == 0 || accCount == count)
+                {
+                    continue;
+                }
+
+                const float cost = accCount * acc.half_area() + rightCost[s];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = s;
+                }
+            }
+        }
+
+        const float area = box.half_area();
+        const float leafCost = static_cast<float>(count);
+        const float splitCost = area > 0.0f ? 1.0f + bestCost / area : leafCost;
+
+        uint32_t mid = first;
+
+        if (bestAxis >= 0 && splitCost < leafCost)
+        {
+            const float lo = centroidBox.min[bestAxis];
+            const float scale = static_cast<float>(kBins) / (centroidBox.max[bestAxis] - lo);
+
+            // In-place partition of the range, keeping m_leaf_bounds in step
+            uint32_t i = first;
+            uint32_t j = first + count;
+            while (i < j)
+            {
+                const float c = m_centroids[m_indices[i]][bestAxis];
+                const uint32_t b = std::min(kBins - 1, static_cast<uint32_t>((c - lo) * scale));
+
+                if (b <= bestSplit)
+                {
+                    ++i;
+                }
+                else
+                {
+                    --j;
+                    std::swap(m_indices[i], m_indices[j]);
+                    std::swap(m_leaf_bounds[i], m_leaf_bounds[j]);
+                }
+            }
+            mid = i;
+        }
+        else if (count > 4 * kMaxLeafSize)
+        {
+            // No useful plane (e.g. coincident centroids): halve the range to bound leaf size
+            mid = first + count / 2;
+        }
+        else
+        {
+            return; // stays a leaf
+        }
+
+        const uint32_t left = static_cast<uint32_t>(m_nodes.size());
+
+        m_nodes.push_back(Node{{}, first, {}, mid - first});
+        m_nodes.push_back(Node{{}, mid, {}, first + count - mid});
+        m_parent.push_back(node_index);
+        m_parent.push_back(node_index);
+
+        m_nodes[node_index].first = left;
+        m_nodes[node_index].count = 0;
+
+        stack.push_back(left + 1);
+        stack.push_back(left);
+    }
+
+    void Bvh::update_node(uint32_t node_index)
+    {
+        Node &node = m_nodes[node_index];
+
+        Aabb box;
+        if (node.count != 0)
+        {
+            for (uint32_t k = node.first; k < node.first + node.count; ++k)
+            {
+                box.grow(m_leaf_bounds[k]);
+            }
+        }
+        else
+        {
+            const Node &l = m_nodes[node.first];
+            const Node &r = m_nodes[node.first + 1];
+            box.min = glm::min(l.min, r.min);
+            box.max = glm::max(l.max, r.max);
+        }
+
+        node.min = box.min;
+        node.max = box.max;
+    }
+
+    void Bvh::refit(const Aabb *bounds)
+    {
+        for (uint32_t k = 0; k < static_cast<uint32_t>(m_indices.size()); ++k)
+        {
+            m_leaf_bounds[k] = bounds[m_indices[k]];
+        }
+
+        // Children always follow their parent, so a reverse sweep is bottom-up
+        for (uint32_t node = static_cast<uint32_t>(m_nodes.size()); node-- > 0;)
+        {
+            update_node(node);
+        }
+    }
+
+    void Bvh::refit(const Aabb *bounds, const std::vector<uint32_t> &changed)
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        ++m_refit_epoch;
+
+        std::vector<uint32_t> dirty;
+        for (uint32_t prim : changed)
+        {
+            if (prim >= m_prim_slot.size() || m_prim_slot[prim] == kNone)
+            {
+                continue;
+            }
+
+            m_leaf_bounds[m_prim_slot[prim]] = bounds[prim];
+
+            // Mark the path to the root, stopping where another primitive already did
+            for (uint32_t node = m_prim_leaf[prim];
+                 node != kNone && m_refit_stamp[node] != m_refit_epoch;
+                 node = m_parent[node])
+            {
+                m_refit_stamp[node] = m_refit_epoch;
+                dirty.push_back(node);
+            }
+        }
+
+        std::sort(dirty.begin(), dirty.end(), std::greater<>{});
+        for (uint32_t node : dirty)
+        {
+            update_node(node);
+        }
+    }
+
+    void Bvh::query_frustum(const Frustum &frustum, std::vector<uint32_t> &out) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        std::vector<uint32_t> stack;
+        stack.reserve(64);
+        stack.push_back(0);
+
+        while (!stack.empty())
+        {
+            const uint32_t entry = stack.back();
+            stack.pop_back();
+
+            const Node &node = m_nodes[entry & ~kInsideBit];
+
+            FrustumTest test = FrustumTest::Inside;
+            if ((entry & kInsideBit) == 0)
+            {
+                test = frustum.test_aabb(node.min, node.max);
+            }
+
+            if (test == FrustumTest::Outside)
+            {
+                continue;
+            }
+
+            if (node.count == 0)
+            {
+                // Children of a contained node are contained too
+                const uint32_t flag = (test == FrustumTest::Inside) ? kInsideBit : 0u;
+                stack.push_back((node.first + 1) | flag);
+                stack.push_back(node.first | flag);
+                continue;
+            }
+
+            for (uint32_t k = node.first; k < node.first + node.count; ++k)
+            {
+                const Aabb &b = m_leaf_bounds[k];
+                if (test == FrustumTest::Inside ||
+                    frustum.test_aabb(b.min, b.max) != FrustumTest::Outside)
+                {
+                    out.push_back(m_indices[k]);
+                }
+            }
+        }
+    }
+
+    void Bvh::query_aabb(const Aabb &box, std::vector<uint32_t> &out) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        std::vector<uint32_t> stack;
+        stack.reserve(64);
+        stack.push_back(0);
+
+        while (!stack.empty())
+        {
+            const Node &node = m_nodes[stack.back()];
+            stack.pop_back();
+
+            if (!box.overlaps(Aabb{node.min, node.max}))
+            {
+                continue;
+            }
+
+            if (node.count == 0)
+            {
+                stack.push_back(node.first + 1);
+                stack.push_back(node.first);
+                continue;
+            }
+
+            for (uint32_t k = node.first; k < node.first + node.count; ++k)
+            {
+                if (box.overlaps(m_leaf_bounds[k]))
+                {
+                    out.push_back(m_indices[k]);
+                }
+            }
+        }
+    }
+
+    std::optional<BvhRayHit> Bvh::raycast(const glm::vec3 &origin,
+                                          const glm::vec3 &direction,
+                                          float max_t) const
+    {
+        if (m_nodes.empty())
+        {
+            return std::nullopt;
+        }
+
+        const glm::vec3 invDir = 1.0f / direction; // +-inf on zero components is intended
+
+        std::optional<BvhRayHit> best;
+        float bestT = max_t;
+
+        if (ray_box(origin, invDir, m_nodes[0].min, m_nodes[0].max, bestT) ==
+            std::numeric_limits<float>::infinity())
+        {
+            return std::nullopt;
+        }
+
+        std::vector<uint32_t> stack;
+        stack.reserve(64);
+        stack.push_back(0);
+
+        while (!stack.empty())
+        {
+            const Node &node = m_nodes[stack.back()];
+            stack.pop_back();
+
+            if (node.count != 0)
+            {
+                for (uint32_t k = node.first; k < node.first + node.count; ++k)
+                {
+                    const Aabb &b = m_leaf_bounds[k];
+                    const float t = ray_box(origin, invDir, b.min, b.max, bestT);
+                    if (t < bestT || (!best && t <= bestT))
+                    {
+                        bestT = t;
+                        best = BvhRayHit{m_indices[k], t};
+                    }
+                }
+                continue;
+            }
+
+            // Visit the nearer child first so bestT shrinks early
+            const Node &l = m_nodes[node.first];
+            const Node &r = m_nodes[node.first + 1];
+            const float tl = ray_box(origin, invDir, l.min, l.max, bestT);
+            const float tr = ray_box(origin, invDir, r.min, r.max, bestT);
+
+            const bool lHit = tl != std::numeric_limits<float>::infinity();
+            const bool rHit = tr != std::numeric_limits<float>::infinity();
+
+            if (lHit && rHit)
+            {
+                const bool leftFirst = tl <= tr;
+                stack.push_back(leftFirst ? node.first + 1 : node.first);
+                stack.push_back(leftFirst ? node.first : node.first + 1);
+            }
+            else if (lHit)
+            {
+                stack.push_back(node.first);
+            }
+            else if (rHit)
+            {
+                stack.push_back(node.first + 1);
+            }
+        }
+
+        return best;
+    }
+
+} // namespace ankh
@@ -0,0 +1,137 @@
+// src/scene/bvh.hpp
+#pragma once
+
+#include "scene/frustum.hpp"
+#include "utils/types.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace ankh
+{
+
+    struct Aabb
+    {
+        glm::vec3 min{std::numeric_limits<float>::max()};
+        glm::vec3 max{-std::numeric_limits<float>::max()};
+
+        bool empty() const
+        {
+            return min.x > max.x;
+        }
+
+        void grow(const glm::vec3 &p)
+        {
+            min = glm::min(min, p);
+            max = glm::max(max, p);
+        }
+
+        void grow(const Aabb &b)
+        {
+            min = glm::min(min, b.min);
+            max = glm::max(max, b.max);
+        }
+
+        float half_area() const
+        {
+            const glm::vec3 e = max - min;
+            return e.x * e.y + e.y * e.z + e.z * e.x;
+        }
+
+        bool overlaps(const Aabb &b) const
+        {
+            return min.x <= b.max.x && max.x >= b.min.x && min.y <= b.max.y &&
+                   max.y >= b.min.y && min.z <= b.max.z && max.z >= b.min.z;
+        }
+
+        // Bounds of the box after transforming it by 'm' (Arvo's method)
+        static Aabb transformed(const glm::mat4 &m, const glm::vec3 &min, const glm::vec3 &max);
+    };
+
+    struct BvhRayHit
+    {
+        uint32_t primitive{0};
+        float t{0.0f}; // distance along the ray to the primitive's box
+    };
+
+    // Bounding volume hierarchy over primitive boxes (renderable world bounds in the scene).
+    // Built top-down with a binned surface area heuristic; refit() keeps the topology and
+    // only re-grows boxes, which is enough while objects move locally.
+    // Nodes are 32 bytes, children are allocated in pairs after their parent, and every
+    // leaf holds a contiguous range of m_indices, so traversal touches little memory.
+    class Bvh
+    {
+      public:
+        struct Node
+        {
+            glm::vec3 min;
+            uint32_t first; // leaf: first entry in indices; inner: left child (right = +1)
+            glm::vec3 max;
+            uint32_t count; // primitives in a leaf, 0 for inner nodes
+        };
+        static_assert(sizeof(Node) == 32);
+
+        // Rebuild over bounds[0..count). Empty boxes are kept out of every query.
+        void build(const Aabb *bounds, uint32_t count);
+
+        // Re-grow all node boxes from 'bounds' (same count and order as the last build)
+        void refit(const Aabb *bounds);
+
+        // Re-grow only the leaves holding 'changed' primitives and their ancestors
+        void refit(const Aabb *bounds, const std::vector<uint32_t> &changed);
+
+        bool empty() const
+        {
+            return m_nodes.empty();
+        }
+
+        uint32_t primitive_count() const
+        {
+            return static_cast<uint32_t>(m_indices.size());
+        }
+
+        const std::vector<Node> &nodes() const
+        {
+            return m_nodes;
+        }
+
+        // Appends primitives whose box is not outside 'frustum'. Whole subtrees inside the
+        // frustum are appended without further tests.
+        void query_frustum(const Frustum &frustum, std::vector<uint32_t> &out) const;
+
+        // Appends primitives whose box overlaps 'box'
+        void query_aabb(const Aabb &box, std::vector<uint32_t> &out) const;
+
+        // Closest primitive box hit by the ray within [0, max_t]
+        std::optional<BvhRayHit> raycast(const glm::vec3 &origin,
+                                         const glm::vec3 &direction,
+                                         float max_t = std::numeric_limits<float>::max()) const;
+
+      private:
+        void subdivide(uint32_t node_index, std::vector<uint32_t> &stack);
+        void update_node(uint32_t node_index);
+
+      private:
+        static constexpr uint32_t kBins = 12;
+        static constexpr uint32_t kMaxLeafSize = 4;
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_indices; // primitive ids, grouped by leaf
+
+        // Primitive boxes in m_indices order, so leaves read them contiguously
+        std::vector<Aabb> m_leaf_bounds;
+
+        // Refit support (cold): parent per node, slot in m_indices and leaf per primitive
+        // (UINT32_MAX for primitives left out of the build)
+        std::vector<uint32_t> m_parent;
+        std::vector<uint32_t> m_prim_slot;
+        std::vector<uint32_t> m_prim_leaf;
+        std::vector<uint32_t> m_refit_stamp;
+        uint32_t m_refit_epoch{0};
+
+        std::vector<glm::vec3> m_centroids; // build scratch
+    };
+
+} // namespace ankh
@@ -28,6 +28,12 @@ namespace ankh
             return m_up;
         }
 
+        // Vertical field of view, radians
+        float fov() const
+        {
+            return m_fov;
+        }
+
         glm::mat4 view() const;
         glm::mat4 proj() const;
 
@@ -0,0 +1,154 @@
+// src/scene/cooked-package.cpp
+#include "scene/cooked-package.hpp"
+
+#include "scene/mesh.hpp"
+#include "utils/logging.hpp"
+#include "utils/vertex-format.hpp"
+
+#include <algorithm>
+
+namespace ankh
+{
+    namespace
+    {
+        void check(bool condition, const char *what)
+        {
+            if (!condition)
+            {
+                ANKH_THROW_MSG(std::string("Invalid package: ") + what);
+            }
+        }
+
+        template <typename Index>
+        bool indices_below(const uint8_t *data, uint32_t count, uint32_t limit)
+        {
+            const Index *indices = reinterpret_cast<const Index *>(data);
+            return std::all_of(indices, indices + count,
+                               [limit](Index index) { return index < limit; });
+        }
+    } // namespace
+
+    std::shared_ptr<const CookedPackage> CookedPackage::open(const std::string &path)
+    {
+        std::shared_ptr<const CookedPackage> package(new CookedPackage(MappedFile(path)));
+        package->validate();
+
+        ANKH_LOG_DEBUG("[CookedPackage] Mapped " + path + " (" +
+                       std::to_string(package->size_bytes()) + " bytes)");
+        return package;
+    }
+
+    CookedPackage::CookedPackage(MappedFile file)
+        : m_file(std::move(file))
+    {
+    }
+
+    void CookedPackage::validate() const
+    {
+        check(m_file.size() >= sizeof(PackageHeader), "truncated header");
+
+        const PackageHeader &h = header();
+        check(h.magic == PACKAGE_MAGIC, "bad magic");
+        check(h.version == PACKAGE_VERSION, "unsupported version");
+
+        const uint64_t fileSize = m_file.size();
+        const auto in_file = [fileSize](const PackageRange &range)
+        {
+            return range.offset % PACKAGE_ALIGNMENT == 0 && range.offset <= fileSize &&
+                   range.size <= fileSize - range.offset;
+        };
+
+        const auto valid_table = [&](const PackageRange &range, std::size_t element)
+        { return in_file(range) && range.size % element == 0; };
+
+        check(valid_table(h.nodes, sizeof(PackageNode)) &&
+                  valid_table(h.meshes, sizeof(PackageMesh)) &&
+                  valid_table(h.lods, sizeof(PackageLod)) &&
+                  valid_table(h.clusters, sizeof(Meshlet)) &&
+                  valid_table(h.materials, sizeof(PackageMaterial)) &&
+                  valid_table(h.images, sizeof(PackageImage)),
+              "table out of range");
+
+        const auto lodTable = lods();
+        const auto clusterTable = clusters();
+
+        for (const PackageMesh &mesh : meshes())
+        {
+            check(mesh.vertexFormat < VERTEX_FORMAT_COUNT && mesh.indexWidth < INDEX_WIDTH_COUNT,
+                  "unknown mesh encoding");
+
+            const VertexFormat format = static_cast<VertexFormat>(mesh.vertexFormat);
+            const IndexWidth width = static_cast<IndexWidth>(mesh.indexWidth);
+
+            check(in_file(mesh.vertices) &&
+                      mesh.vertices.size == uint64_t{vertex_stride(format)} * mesh.vertexCount,
+                  "vertex blob out of range");
+
+            check(mesh.lodCount >= 1 && mesh.lodCount <= MAX_MESH_LODS &&
+                      mesh.firstLod <= lodTable.size() &&
+                      mesh.lodCount <= lodTable.size() - mesh.firstLod,
+                  "mesh levels out of range");
+
+            for (uint32_t l = 0; l < mesh.lodCount; ++l)
+            {
+                const PackageLod &lod = lodTable[mesh.firstLod + l];
+                check(in_file(lod.indices) &&
+                          lod.indices.size == uint64_t{index_size(width)} * lod.indexCount,
+                      "index blob out of range");
+
+                // Indices are uploaded as-is, so one past the vertex buffer would read
+                // out of bounds on the GPU
+                const uint8_t *indices = data(lod.indices);
+                check(width == IndexWidth::U16
+                          ? indices_below<uint16_t>(indices, lod.indexCount, mesh.vertexCount)
+                          : indices_below<uint32_t>(indices, lod.indexCount, mesh.vertexCount),
+                      "index out of range");
+            }
+
+            check(mesh.firstCluster <= clusterTable.size() &&
+                      mesh.clusterCount <= clusterTable.size() - mesh.firstCluster,
+                  "mesh clusters out of range");
+
+            const uint64_t indexCount = lodTable[mesh.firstLod].indexCount;
+            for (uint32_t c = 0; c < mesh.clusterCount; ++c)
+            {
+                const Meshlet &cluster = clusterTable[mesh.firstCluster + c];
+                check(uint64_t{cluster.firstIndex} + cluster.indexCount <= indexCount,
+                      "cluster out of range");
+            }
+        }
+
+        for (const PackageImage &image : images())
+        {
+            check(in_file(image.pixels) &&
+                      image.pixels.size == uint64_t{4} * image.width * image.height,
+                  "image blob out of range");
+        }
+
+        const uint32_t imageCount = static_cast<uint32_t>(images().size());
+        for (const PackageMaterial &material : materials())
+        {
+            check(material.image == PACKAGE_NONE || material.image < imageCount,
+                  "material image out of range");
+        }
+
+        const auto nodeTable = nodes();
+        const uint32_t meshCount = static_cast<uint32_t>(meshes().size());
+        const uint32_t materialCount = static_cast<uint32_t>(materials().size());
+
+        // TransformHierarchy::add takes breadth-first order only: roots first, then parents
+        // never decreasing. Rejecting it here keeps the load from failing halfway.
+        int32_t previousParent = -1;
+        for (std::size_t i = 0; i < nodeTable.size(); ++i)
+        {
+            const PackageNode &node = nodeTable[i];
+            check(node.parent >= previousParent && node.parent < static_cast<int64_t>(i),
+                  "node parent out of order");
+            previousParent = node.parent;
+            check((node.mesh == PACKAGE_NONE || node.mesh < meshCount) &&
+                      (node.material == PACKAGE_NONE || node.material < materialCount),
+                  "node reference out of range");
+        }
+    }
+
+} // namespace ankh
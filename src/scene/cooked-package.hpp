@@ -0,0 +1,173 @@
+// src/scene/cooked-package.hpp
+#pragma once
+
+#include "scene/meshlet-builder.hpp"
+#include "utils/file-io.hpp"
+#include "utils/types.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+
+namespace ankh
+{
+    // Engine-native model package written by ankh_cook (src/cook) from a glTF file. It holds
+    // what ModelLoader and the load-time mesh processing would produce: nodes, meshes with
+    // their vertices and index levels already in the GPU encodings, meshlets, bounds,
+    // materials and base color images decoded to RGBA8.
+    //
+    // Layout: a PackageHeader at offset 0, then the tables and data blobs it points at,
+    // each starting at a multiple of PACKAGE_ALIGNMENT. Values are stored in host byte
+    // order; a package is only read by the PACKAGE_VERSION that wrote it.
+
+    inline constexpr uint32_t PACKAGE_MAGIC = 0x474B5041; // "APKG"
+    inline constexpr uint32_t PACKAGE_VERSION = 1;
+    inline constexpr uint64_t PACKAGE_ALIGNMENT = 64;
+    inline constexpr const char *PACKAGE_EXTENSION = ".ankhpkg";
+
+    // Table index meaning "none" (node without mesh or material, material without image)
+    inline constexpr uint32_t PACKAGE_NONE = ~0u;
+
+    // Cook options baked into the package (PackageHeader::flags)
+    inline constexpr uint32_t PACKAGE_OPTIMIZED_BIT = 1u << 0;        // vertex cache/overdraw order
+    inline constexpr uint32_t PACKAGE_COMPACT_VERTICES_BIT = 1u << 1; // per-mesh VertexFormat
+    inline constexpr uint32_t PACKAGE_MESHLETS_BIT = 1u << 2;         // clusters for cull.comp
+
+    // Byte range of the package file
+    struct PackageRange
+    {
+        uint64_t offset{0};
+        uint64_t size{0};
+    };
+
+    struct PackageHeader
+    {
+        uint32_t magic{PACKAGE_MAGIC};
+        uint32_t version{PACKAGE_VERSION};
+        uint64_t sourceHash{0}; // inputs and cook options; an equal hash means up to date
+        uint32_t flags{0};
+        uint32_t lodLevels{0}; // requested simplified levels per mesh
+        PackageRange nodes;     // PackageNode[], breadth-first as ModelNode
+        PackageRange meshes;    // PackageMesh[]
+        PackageRange lods;      // PackageLod[], each mesh's levels contiguous, finest first
+        PackageRange clusters;  // Meshlet[], firstIndex relative to the mesh's level 0
+        PackageRange materials; // PackageMaterial[]
+        PackageRange images;    // PackageImage[]
+    };
+
+    struct PackageNode
+    {
+        glm::mat4 localTransform{1.0f};
+        int32_t parent{-1};              // earlier node, -1 for roots
+        uint32_t mesh{PACKAGE_NONE};     // PackageMesh index
+        uint32_t material{PACKAGE_NONE}; // PackageMaterial index
+        uint32_t reserved{0};
+    };
+
+    struct PackageMesh
+    {
+        PackageRange vertices; // vertexCount vertices encoded as vertexFormat
+        uint32_t vertexCount{0};
+        uint32_t firstLod{0};
+        uint32_t firstCluster{0};
+        uint32_t clusterCount{0}; // 0: drawn whole
+        uint8_t vertexFormat{0};  // VertexFormat
+        uint8_t indexWidth{0};    // IndexWidth of every level's indices
+        uint8_t lodCount{0};      // levels including level 0
+        uint8_t boundsValid{0};
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+        glm::vec4 sphere{0.0f}; // xyz center, w radius
+    };
+
+    struct PackageLod
+    {
+        PackageRange indices; // indexCount indices of the mesh's indexWidth
+        uint32_t indexCount{0};
+        float error{0.0f}; // MeshLod::error (0 for level 0)
+    };
+
+    struct PackageMaterial
+    {
+        glm::vec4 albedo{1.0f};
+        uint32_t image{PACKAGE_NONE}; // PackageImage index of the base color texture
+        uint32_t reserved[3]{};
+    };
+
+    struct PackageImage
+    {
+        PackageRange pixels; // width * height RGBA8 texels, rows tightly packed
+        uint32_t width{0};
+        uint32_t height{0};
+    };
+
+    static_assert(sizeof(PackageHeader) == 120);
+    static_assert(sizeof(PackageNode) == 80);
+    static_assert(sizeof(PackageMesh) == 80);
+    static_assert(sizeof(PackageLod) == 24);
+    static_assert(sizeof(PackageMaterial) == 32);
+    static_assert(sizeof(PackageImage) == 24);
+    static_assert(sizeof(Meshlet) == 40);
+    static_assert(std::is_trivially_copyable_v<PackageNode> &&
+                  std::is_trivially_copyable_v<PackageMesh> &&
+                  std::is_trivially_copyable_v<Meshlet>);
+
+    // A package mapped read-only and validated. Tables are read in place and blobs are
+    // handed out as pointers into the mapping, so geometry and pixels go from the page
+    // cache to the upload path without intermediate vectors. Meshes and images that view
+    // the mapping hold a reference to the package.
+    class CookedPackage
+    {
+      public:
+        // Map 'path' and check every table and blob range; throws if it is not a package
+        // this version can read
+        static std::shared_ptr<const CookedPackage> open(const std::string &path);
+
+        const PackageHeader &header() const
+        {
+            return *reinterpret_cast<const PackageHeader *>(m_file.data());
+        }
+
+        std::span<const PackageNode> nodes() const { return table<PackageNode>(header().nodes); }
+        std::span<const PackageMesh> meshes() const { return table<PackageMesh>(header().meshes); }
+        std::span<const PackageLod> lods() const { return table<PackageLod>(header().lods); }
+        std::span<const Meshlet> clusters() const { return table<Meshlet>(header().clusters); }
+
+        std::span<const PackageMaterial> materials() const
+        {
+            return table<PackageMaterial>(header().materials);
+        }
+
+        std::span<const PackageImage> images() const
+        {
+            return table<PackageImage>(header().images);
+        }
+
+        const uint8_t *data(const PackageRange &range) const
+        {
+            return m_file.data() + range.offset;
+        }
+
+        std::size_t size_bytes() const
+        {
+            return m_file.size();
+        }
+
+      private:
+        explicit CookedPackage(MappedFile file);
+
+        template <typename T>
+        std::span<const T> table(const PackageRange &range) const
+        {
+            return {reinterpret_cast<const T *>(data(range)), range.size / sizeof(T)};
+        }
+
+        // Throws a message naming the first inconsistency
+        void validate() const;
+
+        MappedFile m_file;
+    };
+
+} // namespace ankh
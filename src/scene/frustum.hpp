@@ -0,0 +1,98 @@
+// src/scene/frustum.hpp
+#pragma once
+
+#include "utils/types.hpp"
+
+#include <array>
+
+namespace ankh
+{
+
+    enum class FrustumTest
+    {
+        Outside,
+        Intersecting,
+        Inside,
+    };
+
+    // Six planes (left, right, bottom, top, near, far) with normals pointing inside.
+    // A point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0.
+    struct Frustum
+    {
+        std::array<glm::vec4, 6> planes{};
+
+        // Gribb/Hartmann extraction from a clip-from-world matrix (proj * view).
+        // Uses GL-style clip depth, which is a superset of Vulkan's [0, 1] range.
+        static Frustum from_matrix(const glm::mat4 &m)
+        {
+            const glm::vec4 r0{m[0][0], m[1][0], m[2][0], m[3][0]};
+            const glm::vec4 r1{m[0][1], m[1][1], m[2][1], m[3][1]};
+            const glm::vec4 r2{m[0][2], m[1][2], m[2][2], m[3][2]};
+            const glm::vec4 r3{m[0][3], m[1][3], m[2][3], m[3][3]};
+
+            Frustum f{};
+            f.planes[0] = r3 + r0;
+            f.planes[1] = r3 - r0;
+            f.planes[2] = r3 + r1;
+            f.planes[3] = r3 - r1;
+            f.planes[4] = r3 + r2;
+            f.planes[5] = r3 - r2;
+
+            for (auto &p : f.planes)
+            {
+                const float len = glm::length(glm::vec3(p));
+                if (len > 0.0f)
+                {
+                    p /= len;
+                }
+            }
+
+            return f;
+        }
+
+        bool intersects_sphere(const glm::vec3 &center, float radius) const
+        {
+            for (const auto &p : planes)
+            {
+                if (glm::dot(glm::vec3(p), center) + p.w < -radius)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Box against all six planes: Inside means fully contained (lets a BVH accept a
+        // whole subtree without testing it). Conservative near the frustum's corners.
+        FrustumTest test_aabb(const glm::vec3 &min, const glm::vec3 &max) const
+        {
+            FrustumTest result = FrustumTest::Inside;
+
+            for (const auto &p : planes)
+            {
+                const glm::vec3 n{p};
+
+                // Corner furthest along the normal, and the one opposite to it
+                const glm::vec3 pos{n.x >= 0.0f ? max.x : min.x,
+                                    n.y >= 0.0f ? max.y : min.y,
+                                    n.z >= 0.0f ? max.z : min.z};
+                const glm::vec3 neg{n.x >= 0.0f ? min.x : max.x,
+                                    n.y >= 0.0f ? min.y : max.y,
+                                    n.z >= 0.0f ? min.z : max.z};
+
+                if (glm::dot(n, pos) + p.w < 0.0f)
+                {
+                    return FrustumTest::Outside;
+                }
+
+                if (glm::dot(n, neg) + p.w < 0.0f)
+                {
+                    result = FrustumTest::Intersecting;
+                }
+            }
+
+            return result;
+        }
+    };
+
+} // namespace ankh
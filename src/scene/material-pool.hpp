@@ -27,6 +27,29 @@ namespace ankh
             return static_cast<MaterialHandle>(m_materials.size() - 1);
         }
 
+        // Batch insertion: reserve 'count' consecutive handles, then fill them with set(),
+        // from several threads at once as long as no two set the same handle. Handles that
+        // are never set stay invalid.
+        MaterialHandle reserve_handles(uint32_t count)
+        {
+            const MaterialHandle first = static_cast<MaterialHandle>(m_materials.size());
+            m_materials.resize(m_materials.size() + count);
+            return first;
+        }
+
+        void set(MaterialHandle h, Material &&mat)
+        {
+            ANKH_ASSERT(h != INVALID_MATERIAL_HANDLE &&
+                        h < static_cast<MaterialHandle>(m_materials.size()));
+            m_materials[h].emplace(std::move(mat));
+        }
+
+        // Number of handle slots, including the invalid handle 0
+        uint32_t size() const
+        {
+            return static_cast<uint32_t>(m_materials.size());
+        }
+
         bool valid(MaterialHandle h) const
         {
             return h != INVALID_MATERIAL_HANDLE &&
@@ -2,6 +2,7 @@
 
 #include "utils/types.hpp"
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace ankh
@@ -12,6 +13,16 @@ namespace ankh
         int height{0};
         int components{0};           // e.g. 3 = RGB, 4 = RGBA
         std::vector<uint8_t> pixels; // raw interleaved bytes
+
+        // Pixels viewed in place instead of copied into 'pixels': a cooked package's
+        // mapping, or the decoder's output buffer. 'owner' keeps them alive.
+        std::span<const uint8_t> mapped;
+        std::shared_ptr<const void> owner;
+
+        std::span<const uint8_t> bytes() const
+        {
+            return mapped.empty() ? std::span<const uint8_t>(pixels) : mapped;
+        }
     };
 
     class Material
@@ -0,0 +1,413 @@
+// src/scene/mesh-optimizer.cpp
+#include "scene/mesh-optimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+namespace ankh
+{
+    namespace
+    {
+        // Forsyth scoring: LRU cache model and the tuning constants from the paper
+        constexpr uint32_t kScoreCacheSize = 32;
+        constexpr float kLastTriangleScore = 0.75f;
+        constexpr float kCacheDecayPower = 1.5f;
+        constexpr float kValenceBoostScale = 2.0f;
+        constexpr float kValenceBoostPower = 0.5f;
+        constexpr uint32_t kValenceTableSize = 32;
+
+        constexpr uint32_t kNoTriangle = ~0u;
+
+        struct ScoreTables
+        {
+            std::array<float, kScoreCacheSize> cache{};
+            std::array<float, kValenceTableSize> valence{};
+
+            ScoreTables()
+            {
+                for (uint32_t i = 0; i < kScoreCacheSize; ++i)
+                {
+                    // The three vertices of the last triangle score the same, whatever
+                    // their order, so the next triangle is not biased towards one edge
+                    cache[i] = (i < 3) ? kLastTriangleScore
+                                       : std::pow(1.0f - static_cast<float>(i - 3) /
+                                                             (kScoreCacheSize - 3),
+                                                  kCacheDecayPower);
+                }
+
+                for (uint32_t i = 1; i < kValenceTableSize; ++i)
+                {
+                    valence[i] =
+                        kValenceBoostScale * std::pow(static_cast<float>(i), -kValenceBoostPower);
+                }
+            }
+
+            float score(int32_t cache_position, uint32_t live_triangles) const
+            {
+                if (live_triangles == 0)
+                {
+                    return -1.0f; // never chosen again
+                }
+
+                const float valenceScore =
+                    live_triangles < kValenceTableSize
+                        ? valence[live_triangles]
+                        : kValenceBoostScale *
+                              std::pow(static_cast<float>(live_triangles), -kValenceBoostPower);
+
+                return (cache_position >= 0 ? cache[cache_position] : 0.0f) + valenceScore;
+            }
+        };
+
+        // FIFO cache simulation: a vertex is cached while fewer than 'size' misses have
+        // happened since it was loaded. Bumping 'time' past 'size' flushes the cache.
+        struct FifoCache
+        {
+            std::vector<uint32_t> loaded;
+            uint32_t time;
+            uint32_t size;
+
+            FifoCache(std::size_t vertex_count, uint32_t cache_size)
+                : loaded(vertex_count, 0)
+                , time(cache_size + 1)
+                , size(cache_size)
+            {
+            }
+
+            void flush()
+            {
+                time += size + 1;
+            }
+
+            // Misses (0..3) for drawing triangle 'tri'
+            uint32_t draw(const uint32_t *tri)
+            {
+                uint32_t misses = 0;
+                for (int k = 0; k < 3; ++k)
+                {
+                    if (time - loaded[tri[k]] > size)
+                    {
+                        loaded[tri[k]] = time++;
+                        ++misses;
+                    }
+                }
+                return misses;
+            }
+        };
+    } // namespace
+
+    VertexCacheStats analyze_vertex_cache(const std::vector<uint32_t> &indices,
+                                          std::size_t vertex_count)
+    {
+        VertexCacheStats stats;
+        stats.triangles = indices.size() / 3;
+
+        FifoCache cache(vertex_count, VertexCacheStats::kVertexCacheSize);
+        for (std::size_t t = 0; t < stats.triangles; ++t)
+        {
+            stats.misses += cache.draw(&indices[3 * t]);
+        }
+
+        std::vector<uint8_t> used(vertex_count, 0);
+        for (uint32_t v : indices)
+        {
+            stats.vertices += used[v] ? 0 : 1;
+            used[v] = 1;
+        }
+
+        return stats;
+    }
+
+    void optimize_vertex_cache(std::vector<uint32_t> &indices, std::size_t vertex_count)
+    {
+        static const ScoreTables tables;
+
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        if (triangleCount < 2)
+        {
+            return;
+        }
+
+        // Triangles around each vertex: adjacency[offsets[v], offsets[v] + live[v]) holds
+        // the ones not emitted yet (emitted ones are swapped out of the live range)
+        std::vector<uint32_t> live(vertex_count, 0);
+        for (uint32_t i = 0; i < 3 * triangleCount; ++i)
+        {
+            ++live[indices[i]];
+        }
+
+        std::vector<uint32_t> offsets(vertex_count + 1, 0);
+        for (std::size_t v = 0; v < vertex_count; ++v)
+        {
+            offsets[v + 1] = offsets[v] + live[v];
+        }
+
+        std::vector<uint32_t> adjacency(3 * triangleCount);
+        {
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (uint32_t i = 0; i < 3 * triangleCount; ++i)
+            {
+                adjacency[cursor[indices[i]]++] = i / 3;
+            }
+        }
+
+        std::vector<int32_t> cachePosition(vertex_count, -1);
+        std::vector<float> vertexScore(vertex_count);
+        for (std::size_t v = 0; v < vertex_count; ++v)
+        {
+            vertexScore[v] = tables.score(-1, live[v]);
+        }
+
+        std::vector<float> triangleScore(triangleCount);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        uint32_t best = 0;
+        for (uint32_t t = 0; t < triangleCount; ++t)
+        {
+            triangleScore[t] = vertexScore[indices[3 * t]] + vertexScore[indices[3 * t + 1]] +
+                               vertexScore[indices[3 * t + 2]];
+            if (triangleScore[t] > triangleScore[best])
+            {
+                best = t;
+            }
+        }
+
+        // LRU cache, most recent first; three extra slots for the incoming triangle
+        std::array<uint32_t, kScoreCacheSize + 3> cache{};
+        std::array<uint32_t, kScoreCacheSize + 3> next{};
+        uint32_t cacheCount = 0;
+
+        std::vector<uint32_t> result;
+        result.reserve(3 * triangleCount);
+        uint32_t scan = 0; // fallback when the cache offers no live triangle
+
+        for (uint32_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+        {
+            if (best == kNoTriangle)
+            {
+                while (emitted[scan])
+                {
+                    ++scan;
+                }
+                best = scan;
+            }
+
+            const uint32_t *tri = &indices[3 * best];
+            result.insert(result.end(), tri, tri + 3);
+            emitted[best] = 1;
+
+            uint32_t nextCount = 0;
+            for (int k = 0; k < 3; ++k)
+            {
+                const uint32_t v = tri[k];
+                if (k == 0 || (v != tri[0] && (k == 1 || v != tri[1])))
+                {
+                    next[nextCount++] = v; // once, even for degenerate triangles
+                }
+
+                // Drop the emitted triangle from v's live range
+                uint32_t *first = &adjacency[offsets[v]];
+                uint32_t *last = first + live[v];
+                *std::find(first, last, best) = *(last - 1);
+                --live[v];
+            }
+
+            for (uint32_t i = 0; i < cacheCount; ++i)
+            {
+                const uint32_t v = cache[i];
+                if (v != tri[0] && v != tri[1] && v != tri[2])
+                {
+                    next[nextCount++] = v;
+                }
+            }
+
+            // Vertices pushed out of the cache lose their cache score
+            for (uint32_t i = kScoreCacheSize; i < nextCount; ++i)
+            {
+                cachePosition[next[i]] = -1;
+            }
+
+            cacheCount = std::min(nextCount, kScoreCacheSize);
+            std::swap(cache, next);
+            for (uint32_t i = 0; i < cacheCount; ++i)
+            {
+                cachePosition[cache[i]] = static_cast<int32_t>(i);
+            }
+
+            // Rescore every vertex whose position or valence changed: the cached ones and
+            // the evicted ones still listed past cacheCount
+            for (uint32_t i = 0; i < nextCount; ++i)
+            {
+                const uint32_t v = cache[i];
+                const float score = tables.score(cachePosition[v], live[v]);
+                const float delta = score - vertexScore[v];
+                vertexScore[v] = score;
+
+                for (uint32_t k = offsets[v]; k < offsets[v] + live[v]; ++k)
+                {
+                    triangleScore[adjacency[k]] += delta;
+                }
+            }
+
+            best = kNoTriangle;
+            float bestScore = -1.0f;
+            for (uint32_t i = 0; i < cacheCount; ++i)
+            {
+                const uint32_t v = cache[i];
+                for (uint32_t k = offsets[v]; k < offsets[v] + live[v]; ++k)
+                {
+                    const uint32_t t = adjacency[k];
+                    if (triangleScore[t] > bestScore)
+                    {
+                        bestScore = triangleScore[t];
+                        best = t;
+                    }
+                }
+            }
+        }
+
+        indices.swap(result);
+    }
+
+    void optimize_overdraw(std::vector<uint32_t> &indices,
+                           const std::vector<Vertex> &vertices,
+                           float threshold)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        if (triangleCount < 2)
+        {
+            return;
+        }
+
+        FifoCache cache(vertices.size(), VertexCacheStats::kVertexCacheSize);
+
+        // Hard boundaries: triangles that miss on all three vertices start on a cold
+        // cache already, so moving them costs nothing
+        std::vector<uint32_t> hard{0};
+        for (uint32_t t = 0; t < triangleCount; ++t)
+        {
+            if (cache.draw(&indices[3 * t]) == 3 && t != 0)
+            {
+                hard.push_back(t);
+            }
+        }
+        hard.push_back(triangleCount);
+
+        // Soft boundaries: within a hard cluster, cut as soon as the part since the last
+        // cut (simulated from a cold cache) is within 'threshold' of the cluster's ACMR
+        std::vector<uint32_t> clusters;
+        for (std::size_t c = 0; c + 1 < hard.size(); ++c)
+        {
+            const uint32_t start = hard[c];
+            const uint32_t end = hard[c + 1];
+
+            cache.flush();
+            uint32_t clusterMisses = 0;
+            for (uint32_t t = start; t < end; ++t)
+            {
+                clusterMisses += cache.draw(&indices[3 * t]);
+            }
+
+            const float limit =
+                threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+            clusters.push_back(start);
+
+            cache.flush();
+            uint32_t misses = 0;
+            uint32_t faces = 0;
+            for (uint32_t t = start; t + 1 < end; ++t)
+            {
+                misses += cache.draw(&indices[3 * t]);
+                ++faces;
+
+                if (static_cast<float>(misses) <= limit * static_cast<float>(faces))
+                {
+                    clusters.push_back(t + 1);
+                    cache.flush();
+                    misses = 0;
+                    faces = 0;
+                }
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        glm::vec3 meshCenter{0.0f};
+        for (const Vertex &v : vertices)
+        {
+            meshCenter += v.pos;
+        }
+        meshCenter /= static_cast<float>(vertices.size());
+
+        // Outward-facing clusters far from the center first: they tend to occlude the rest
+        const uint32_t clusterCount = static_cast<uint32_t>(clusters.size() - 1);
+        std::vector<float> sortKey(clusterCount);
+
+        for (uint32_t c = 0; c < clusterCount; ++c)
+        {
+            glm::vec3 centroid{0.0f};
+            glm::vec3 normal{0.0f};
+            float area = 0.0f;
+
+            for (uint32_t t = clusters[c]; t < clusters[c + 1]; ++t)
+            {
+                const glm::vec3 &a = vertices[indices[3 * t]].pos;
+                const glm::vec3 &b = vertices[indices[3 * t + 1]].pos;
+                const glm::vec3 &d = vertices[indices[3 * t + 2]].pos;
+
+                const glm::vec3 n = glm::cross(b - a, d - a); // length = twice the area
+                const float w = glm::length(n);
+
+                centroid += (a + b + d) * (w / 3.0f);
+                normal += n;
+                area += w;
+            }
+
+            const float normalLength = glm::length(normal);
+            sortKey[c] = (area > 0.0f && normalLength > 0.0f)
+                             ? glm::dot(centroid / area - meshCenter, normal / normalLength)
+                             : 0.0f;
+        }
+
+        std::vector<uint32_t> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(),
+                         order.end(),
+                         [&](uint32_t l, uint32_t r) { return sortKey[l] > sortKey[r]; });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (uint32_t c : order)
+        {
+            result.insert(result.end(),
+                          indices.begin() + 3 * clusters[c],
+                          indices.begin() + 3 * clusters[c + 1]);
+        }
+
+        indices.swap(result);
+    }
+
+    void optimize_vertex_fetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+    {
+        constexpr uint32_t kUnused = ~0u;
+
+        std::vector<uint32_t> remap(vertices.size(), kUnused);
+        std::vector<Vertex> result;
+        result.reserve(vertices.size());
+
+        for (uint32_t &index : indices)
+        {
+            if (remap[index] == kUnused)
+            {
+                remap[index] = static_cast<uint32_t>(result.size());
+                result.push_back(vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        vertices.swap(result);
+    }
+
+} // namespace ankh
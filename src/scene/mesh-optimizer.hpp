@@ -0,0 +1,65 @@
+// src/scene/mesh-optimizer.hpp
+#pragma once
+
+#include "utils/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ankh
+{
+
+    // Post-transform vertex cache behaviour of an index list, measured with a FIFO cache
+    // of kVertexCacheSize entries. Counts add up across meshes, so a whole asset can be
+    // summarized with operator+=.
+    struct VertexCacheStats
+    {
+        static constexpr uint32_t kVertexCacheSize = 16;
+
+        std::size_t triangles{0};
+        std::size_t vertices{0}; // distinct vertices referenced
+        std::size_t misses{0};   // vertex shader invocations
+
+        // Average cache miss ratio: shaded vertices per triangle (0.5 ideal, 3 worst)
+        float acmr() const
+        {
+            return triangles ? static_cast<float>(misses) / static_cast<float>(triangles) : 0.0f;
+        }
+
+        // Average transformed vertex ratio: times each vertex is shaded (1 ideal)
+        float atvr() const
+        {
+            return vertices ? static_cast<float>(misses) / static_cast<float>(vertices) : 0.0f;
+        }
+
+        VertexCacheStats &operator+=(const VertexCacheStats &o)
+        {
+            triangles += o.triangles;
+            vertices += o.vertices;
+            misses += o.misses;
+            return *this;
+        }
+    };
+
+    VertexCacheStats analyze_vertex_cache(const std::vector<uint32_t> &indices,
+                                          std::size_t vertex_count);
+
+    // Reorder triangles so consecutive ones share vertices (Forsyth's linear-speed
+    // vertex cache optimisation). The set of triangles and their winding are unchanged.
+    void optimize_vertex_cache(std::vector<uint32_t> &indices, std::size_t vertex_count);
+
+    // Reorder clusters of a cache-optimized triangle list so outward-facing clusters far
+    // from the mesh center come first and occlude the rest (Sander et al., "Fast Triangle
+    // Reordering for Vertex Locality and Reduced Overdraw"). Clusters end where the cache
+    // is cold anyway, or where the cluster's ACMR is within 'threshold' times the
+    // input's, so the vertex cache cost grows by at most that factor.
+    void optimize_overdraw(std::vector<uint32_t> &indices,
+                           const std::vector<Vertex> &vertices,
+                           float threshold);
+
+    // Renumber vertices in first-use order so the vertex fetch walks memory forwards.
+    // Vertices no index refers to are dropped.
+    void optimize_vertex_fetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+} // namespace ankh
@@ -27,6 +27,23 @@ namespace ankh
             return static_cast<MeshHandle>(m_meshes.size() - 1);
         }
 
+        // Batch insertion: reserve 'count' consecutive handles, then fill them with set(),
+        // from several threads at once as long as no two set the same handle. Handles that
+        // are never set stay invalid.
+        MeshHandle reserve_handles(uint32_t count)
+        {
+            const MeshHandle first = static_cast<MeshHandle>(m_meshes.size());
+            m_meshes.resize(m_meshes.size() + count);
+            return first;
+        }
+
+        void set(MeshHandle h, Mesh &&mesh)
+        {
+            ANKH_ASSERT(h != INVALID_MESH_HANDLE &&
+                        h < static_cast<MeshHandle>(m_meshes.size()));
+            m_meshes[h].emplace(std::move(mesh));
+        }
+
         bool valid(MeshHandle h) const
         {
             return h != INVALID_MESH_HANDLE && h < static_cast<MeshHandle>(m_meshes.size()) &&
@@ -53,6 +70,12 @@ namespace ankh
             return *m_meshes[h];
         }
 
+        // Cached at load time (see Mesh::bounds)
+        const MeshBounds &bounds(MeshHandle h) const
+        {
+            return get(h).bounds();
+        }
+
         std::vector<MeshHandle> handles() const
         {
             std::vector<MeshHandle> result;
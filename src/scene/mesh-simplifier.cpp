@@ -0,0 +1,601 @@
+// src/scene/mesh-simplifier.cpp
+#include "scene/mesh-simplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ankh
+{
+    namespace
+    {
+        // Symmetric 4x4 error quadric, upper triangle:
+        // a00 a01 a02 a03 a11 a12 a13 a22 a23 a33
+        struct Quadric
+        {
+            double a[10]{};
+
+            void add_plane(const glm::dvec3 &n, double d)
+            {
+                a[0] += n.x * n.x;
+                a[1] += n.x * n.y;
+                a[2] += n.x * n.z;
+                a[3] += n.x * d;
+                a[4] += n.y * n.y;
+                a[5] += n.y * n.z;
+                a[6] += n.y * d;
+                a[7] += n.z * n.z;
+                a[8] += n.z * d;
+                a[9] += d * d;
+            }
+
+            Quadric &operator+=(const Quadric &o)
+            {
+                for (int i = 0; i < 10; ++i)
+                {
+                    a[i] += o.a[i];
+                }
+                return *this;
+            }
+
+            // Sum of squared distances from 'p' to the accumulated planes
+            double eval(const glm::dvec3 &p) const
+            {
+                const double x = p.x, y = p.y, z = p.z;
+                return a[0] * x * x + 2.0 * a[1] * x * y + 2.0 * a[2] * x * z + 2.0 * a[3] * x +
+                       a[4] * y * y + 2.0 * a[5] * y * z + 2.0 * a[6] * y + a[7] * z * z +
+                       2.0 * a[8] * z + a[9];
+            }
+        };
+
+        constexpr double kMinFaceRotationCos = 0.25;
+
+        struct Collapse
+        {
+            uint32_t from;
+            uint32_t to;
+            double cost;
+        };
+
+        uint64_t edge_key(uint32_t a, uint32_t b)
+        {
+            return (static_cast<uint64_t>(a) << 32) | b;
+        }
+
+        struct PositionHash
+        {
+            size_t operator()(const glm::vec3 &p) const
+            {
+                // + 0.0f folds -0 into 0, which compares equal
+                const glm::vec3 q = p + glm::vec3(0.0f);
+                uint32_t bits[3];
+                std::memcpy(bits, &q, sizeof(bits));
+                return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+            }
+        };
+
+        glm::dvec3 face_normal(const glm::dvec3 &a, const glm::dvec3 &b, const glm::dvec3 &c)
+        {
+            return glm::cross(b - a, c - a);
+        }
+
+        bool same_attributes(const Vertex &a, const Vertex &b)
+        {
+            return a.pos == b.pos && a.normal == b.normal && a.color == b.color && a.uv == b.uv;
+        }
+
+        // How the vertices at one position may move
+        enum class PositionKind : uint8_t
+        {
+            Manifold, // one vertex; collapses onto any neighbour
+            Seam,     // two vertices on one attribute seam; collapses along the seam
+            Complex,  // more vertices (hard-edged corners, flat shading); collapses onto
+                      // another Complex or a Locked position
+            Locked,   // on an open border; never moves
+        };
+
+        bool can_collapse(PositionKind from, PositionKind to)
+        {
+            switch (from)
+            {
+            case PositionKind::Manifold:
+                return true;
+            case PositionKind::Seam:
+                return to == PositionKind::Seam || to == PositionKind::Locked;
+            case PositionKind::Complex:
+                return to == PositionKind::Complex || to == PositionKind::Locked;
+            default:
+                return false;
+            }
+        }
+
+        // Vertices grouped by position. Vertices with identical attributes are merged in
+        // 'tris' first, so only real attribute seams keep several vertices per position.
+        struct Positions
+        {
+            std::vector<uint32_t> first; // per vertex: first vertex at its position
+            std::vector<uint32_t> next;  // per vertex: next vertex at its position (a ring)
+            std::vector<PositionKind> kind; // per first vertex
+        };
+
+        Positions find_positions(const std::vector<Vertex> &vertices, std::vector<uint32_t> &tris)
+        {
+            const uint32_t n = static_cast<uint32_t>(vertices.size());
+
+            std::vector<uint8_t> used(n, 0);
+            for (uint32_t v : tris)
+            {
+                used[v] = 1;
+            }
+
+            Positions positions;
+            positions.first.resize(n);
+            positions.next.resize(n);
+            positions.kind.assign(n, PositionKind::Manifold);
+
+            std::unordered_map<glm::vec3, uint32_t, PositionHash> firstAt;
+            firstAt.reserve(n);
+
+            std::vector<uint32_t> canonical(n);
+            for (uint32_t v = 0; v < n; ++v)
+            {
+                canonical[v] = v;
+                positions.first[v] = v;
+                positions.next[v] = v;
+
+                if (!used[v])
+                {
+                    continue;
+                }
+
+                const auto [it, inserted] = firstAt.try_emplace(vertices[v].pos, v);
+                if (inserted)
+                {
+                    continue;
+                }
+
+                const uint32_t head = it->second;
+                positions.first[v] = head;
+
+                uint32_t w = head;
+                do
+                {
+                    if (same_attributes(vertices[w], vertices[v]))
+                    {
+                        canonical[v] = w;
+                        break;
+                    }
+                    w = positions.next[w];
+                } while (w != head);
+
+                if (canonical[v] == v)
+                {
+                    positions.next[v] = positions.next[head];
+                    positions.next[head] = v;
+                }
+            }
+
+            for (uint32_t &v : tris)
+            {
+                v = canonical[v];
+            }
+
+            const auto &first = positions.first;
+
+            std::unordered_set<uint64_t> vertexEdges;
+            std::unordered_set<uint64_t> positionEdges;
+            vertexEdges.reserve(tris.size());
+            positionEdges.reserve(tris.size());
+            for (size_t t = 0; t < tris.size(); t += 3)
+            {
+                for (int e = 0; e < 3; ++e)
+                {
+                    const uint32_t a = tris[t + e];
+                    const uint32_t b = tris[t + (e + 1) % 3];
+                    vertexEdges.insert(edge_key(a, b));
+                    positionEdges.insert(edge_key(first[a], first[b]));
+                }
+            }
+
+            // An edge without a twin is an open border if no face runs the other way at
+            // all, else a seam: the faces on either side use different vertices
+            std::vector<uint8_t> border(n, 0);
+            std::unordered_set<uint64_t> seamEdges;
+            for (uint64_t key : vertexEdges)
+            {
+                const uint32_t a = static_cast<uint32_t>(key >> 32);
+                const uint32_t b = static_cast<uint32_t>(key);
+                const uint32_t pa = first[a];
+                const uint32_t pb = first[b];
+                if (pa == pb || vertexEdges.contains(edge_key(b, a)))
+                {
+                    continue;
+                }
+
+                if (positionEdges.contains(edge_key(pb, pa)))
+                {
+                    seamEdges.insert(edge_key(std::min(pa, pb), std::max(pa, pb)));
+                }
+                else
+                {
+                    border[pa] = border[pb] = 1;
+                }
+            }
+
+            std::vector<uint32_t> seamCount(n, 0);
+            for (uint64_t key : seamEdges)
+            {
+                ++seamCount[static_cast<uint32_t>(key >> 32)];
+                ++seamCount[static_cast<uint32_t>(key)];
+            }
+
+            for (uint32_t v = 0; v < n; ++v)
+            {
+                if (!used[v] || first[v] != v)
+                {
+                    continue;
+                }
+
+                uint32_t count = 0;
+                uint32_t w = v;
+                do
+                {
+                    ++count;
+                    w = positions.next[w];
+                } while (w != v);
+
+                if (border[v])
+                {
+                    positions.kind[v] = PositionKind::Locked;
+                }
+                else if (count == 1)
+                {
+                    positions.kind[v] = PositionKind::Manifold;
+                }
+                else if (count == 2 && seamCount[v] == 2)
+                {
+                    positions.kind[v] = PositionKind::Seam;
+                }
+                else
+                {
+                    positions.kind[v] = PositionKind::Complex;
+                }
+            }
+
+            return positions;
+        }
+
+        // Same UV and color: vertices at one position differing only in their normal lie
+        // on one surface across a hard edge, anything else is a texture or color seam
+        bool same_surface(const Vertex &a, const Vertex &b)
+        {
+            return a.uv == b.uv && a.color == b.color;
+        }
+
+        // Vertex at position 'at', still referenced by a face, on the same surface as
+        // 'like' and with the normal closest to 'normal'; ~0u if there is none
+        uint32_t matching_vertex(const std::vector<Vertex> &vertices,
+                                 const Positions &positions,
+                                 const std::vector<uint32_t> &adjOffsets,
+                                 const Vertex &like,
+                                 const glm::vec3 &normal,
+                                 uint32_t at)
+        {
+            uint32_t best = ~0u;
+            float bestDistance = 0.0f;
+
+            uint32_t w = at;
+            do
+            {
+                if (adjOffsets[w] != adjOffsets[w + 1] && same_surface(vertices[w], like))
+                {
+                    const glm::vec3 dn = vertices[w].normal - normal;
+                    const float d = glm::dot(dn, dn);
+                    if (best == ~0u || d < bestDistance)
+                    {
+                        best = w;
+                        bestDistance = d;
+                    }
+                }
+                w = positions.next[w];
+            } while (w != at);
+
+            return best;
+        }
+
+        struct Move
+        {
+            uint32_t from;
+            uint32_t to;
+        };
+    } // namespace
+
+    SimplifiedIndices simplify_mesh(const std::vector<Vertex> &vertices,
+                                    const std::vector<uint32_t> &indices,
+                                    std::size_t target_index_count,
+                                    float max_error)
+    {
+        const uint32_t n = static_cast<uint32_t>(vertices.size());
+
+        std::vector<uint32_t> tris(indices.begin(), indices.end());
+        tris.resize(tris.size() - tris.size() % 3);
+
+        std::vector<glm::dvec3> pos(n);
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            pos[v] = glm::dvec3(vertices[v].pos);
+        }
+
+        const Positions positions = find_positions(vertices, tris);
+        const auto &first = positions.first;
+
+        // Plane quadrics of the faces around each position (unweighted, so sqrt(cost) is
+        // a distance), stored at the position's first vertex
+        std::vector<Quadric> quadrics(n);
+        for (size_t t = 0; t < tris.size(); t += 3)
+        {
+            const glm::dvec3 nrm = face_normal(pos[tris[t]], pos[tris[t + 1]], pos[tris[t + 2]]);
+            const double len = glm::length(nrm);
+            if (len <= 0.0)
+            {
+                continue;
+            }
+
+            const glm::dvec3 unit = nrm / len;
+            const double d = -glm::dot(unit, pos[tris[t]]);
+
+            for (int k = 0; k < 3; ++k)
+            {
+                quadrics[first[tris[t + k]]].add_plane(unit, d);
+            }
+        }
+
+        const double maxCost = static_cast<double>(max_error) * static_cast<double>(max_error);
+        double worst = 0.0;
+
+        std::vector<Collapse> collapses;
+        std::vector<uint32_t> remap(n);
+        std::vector<uint8_t> touched(n);
+        std::vector<uint32_t> adjOffsets(n + 1);
+        std::vector<uint32_t> adjTris;
+        std::vector<Move> moves;
+
+        // Passes of independent collapses, cheapest first; adjacency is rebuilt between
+        // passes, and vertices next to a collapse wait for the next pass
+        while (tris.size() > target_index_count)
+        {
+            collapses.clear();
+            for (size_t t = 0; t < tris.size(); t += 3)
+            {
+                for (int e = 0; e < 3; ++e)
+                {
+                    const uint32_t a = tris[t + e];
+                    const uint32_t b = tris[t + (e + 1) % 3];
+                    if (first[a] >= first[b])
+                    {
+                        continue; // each position edge once per side of a seam
+                    }
+
+                    const PositionKind ka = positions.kind[first[a]];
+                    const PositionKind kb = positions.kind[first[b]];
+
+                    Quadric q = quadrics[first[a]];
+                    q += quadrics[first[b]];
+
+                    if (can_collapse(ka, kb))
+                    {
+                        collapses.push_back({a, b, q.eval(pos[b])});
+                    }
+                    if (can_collapse(kb, ka))
+                    {
+                        collapses.push_back({b, a, q.eval(pos[a])});
+                    }
+                }
+            }
+
+            if (collapses.empty())
+            {
+                break;
+            }
+
+            std::sort(collapses.begin(),
+                      collapses.end(),
+                      [](const Collapse &l, const Collapse &r) { return l.cost < r.cost; });
+
+            std::fill(adjOffsets.begin(), adjOffsets.end(), 0u);
+            for (uint32_t v : tris)
+            {
+                ++adjOffsets[v + 1];
+            }
+            for (uint32_t v = 0; v < n; ++v)
+            {
+                adjOffsets[v + 1] += adjOffsets[v];
+            }
+            adjTris.resize(tris.size());
+            {
+                std::vector<uint32_t> cursor(adjOffsets.begin(), adjOffsets.end() - 1);
+                for (uint32_t i = 0; i < tris.size(); ++i)
+                {
+                    adjTris[cursor[tris[i]]++] = i / 3;
+                }
+            }
+
+            for (uint32_t v = 0; v < n; ++v)
+            {
+                remap[v] = v;
+            }
+            std::fill(touched.begin(), touched.end(), 0);
+
+            const size_t trianglesToRemove = (tris.size() - target_index_count + 2) / 3;
+            size_t removed = 0;
+            bool any = false;
+
+            for (const Collapse &c : collapses)
+            {
+                if (removed >= trianglesToRemove || c.cost > maxCost)
+                {
+                    break;
+                }
+
+                const uint32_t from = first[c.from];
+                const uint32_t to = first[c.to];
+                if (touched[from] || touched[to])
+                {
+                    continue;
+                }
+
+                // Every vertex at 'from' moves with it, onto the vertex at 'to' it shares a
+                // face with (its side of a seam). Complex positions may have vertices away
+                // from the edge: they follow a vertex with the same UV and color that does
+                // share a face, onto the matching vertex at 'to'.
+                moves.clear();
+                uint32_t w = from;
+                do
+                {
+                    if (adjOffsets[w] != adjOffsets[w + 1])
+                    {
+                        uint32_t target = (w == c.from) ? c.to : ~0u;
+                        for (uint32_t k = adjOffsets[w]; k < adjOffsets[w + 1] && target == ~0u;
+                             ++k)
+                        {
+                            const uint32_t *t = &tris[3 * adjTris[k]];
+                            for (int j = 0; j < 3; ++j)
+                            {
+                                if (first[t[j]] == to)
+                                {
+                                    target = t[j];
+                                }
+                            }
+                        }
+
+                        moves.push_back({w, target});
+                    }
+                    w = positions.next[w];
+                } while (w != from);
+
+                bool paired = true;
+                for (Move &m : moves)
+                {
+                    if (m.to != ~0u)
+                    {
+                        continue;
+                    }
+
+                    if (positions.kind[from] == PositionKind::Complex)
+                    {
+                        for (const Move &other : moves)
+                        {
+                            if (other.to != ~0u &&
+                                same_surface(vertices[other.from], vertices[m.from]))
+                            {
+                                m.to = matching_vertex(vertices,
+                                                       positions,
+                                                       adjOffsets,
+                                                       vertices[other.to],
+                                                       vertices[m.from].normal,
+                                                       to);
+                                break;
+                            }
+                        }
+                    }
+
+                    paired = paired && m.to != ~0u;
+                }
+
+                if (!paired)
+                {
+                    continue;
+                }
+
+                // Reject collapses that flip (or fold) a surviving face around 'from'
+                bool flips = false;
+                size_t collapsed = 0;
+                for (const Move &m : moves)
+                {
+                    for (uint32_t k = adjOffsets[m.from]; k < adjOffsets[m.from + 1] && !flips;
+                         ++k)
+                    {
+                        const uint32_t *t = &tris[3 * adjTris[k]];
+                        if (t[0] == m.to || t[1] == m.to || t[2] == m.to)
+                        {
+                            ++collapsed;
+                            continue;
+                        }
+
+                        glm::dvec3 p[3];
+                        for (int j = 0; j < 3; ++j)
+                        {
+                            p[j] = pos[t[j]];
+                        }
+                        const glm::dvec3 before = face_normal(p[0], p[1], p[2]);
+
+                        for (int j = 0; j < 3; ++j)
+                        {
+                            if (t[j] == m.from)
+                            {
+                                p[j] = pos[m.to];
+                            }
+                        }
+                        const glm::dvec3 after = face_normal(p[0], p[1], p[2]);
+
+                        // More than ~75 degrees of rotation counts as a flip
+                        flips = glm::dot(before, after) <=
+                                kMinFaceRotationCos * glm::length(before) * glm::length(after);
+                    }
+                }
+
+                if (flips || collapsed == 0)
+                {
+                    continue;
+                }
+
+                for (const Move &m : moves)
+                {
+                    remap[m.from] = m.to;
+
+                    for (uint32_t k = adjOffsets[m.from]; k < adjOffsets[m.from + 1]; ++k)
+                    {
+                        const uint32_t *t = &tris[3 * adjTris[k]];
+                        touched[first[t[0]]] = touched[first[t[1]]] = touched[first[t[2]]] = 1;
+                    }
+                }
+
+                quadrics[to] += quadrics[from];
+                worst = std::max(worst, c.cost);
+                removed += collapsed;
+                any = true;
+            }
+
+            if (!any)
+            {
+                break;
+            }
+
+            // Apply the pass and drop the faces that became degenerate
+            size_t write = 0;
+            for (size_t t = 0; t < tris.size(); t += 3)
+            {
+                const uint32_t a = remap[tris[t]];
+                const uint32_t b = remap[tris[t + 1]];
+                const uint32_t c = remap[tris[t + 2]];
+                if (a == b || b == c || a == c)
+                {
+                    continue;
+                }
+
+                tris[write++] = a;
+                tris[write++] = b;
+                tris[write++] = c;
+            }
+            tris.resize(write);
+        }
+
+        SimplifiedIndices result;
+        result.indices.assign(tris.begin(), tris.end());
+        result.error = static_cast<float>(std::sqrt(worst));
+        return result;
+    }
+
+} // namespace ankh
@@ -0,0 +1,34 @@
+// src/scene/mesh-simplifier.hpp
+#pragma once
+
+#include "utils/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ankh
+{
+
+    struct SimplifiedIndices
+    {
+        std::vector<uint32_t> indices;
+        float error{0.0f}; // largest accepted collapse error, in mesh-local distance units
+    };
+
+    // Quadric error edge-collapse simplification (Garland & Heckbert) of an indexed
+    // triangle list. Every collapse moves a vertex onto one of its neighbours, so the
+    // result indexes the same vertex array and can be stored as another index range of
+    // the mesh. Vertices on open borders never move. An attribute seam (one position,
+    // two vertices) collapses along the seam with both vertices moving to their own side's
+    // counterpart, so the surface stays closed and textures stay on their islands; where
+    // more vertices meet (hard-edged corners, flat shading) they merge onto another such
+    // position.
+    // Stops once at most 'target_index_count' indices remain or when every remaining
+    // collapse would exceed 'max_error'.
+    SimplifiedIndices simplify_mesh(const std::vector<Vertex> &vertices,
+                                    const std::vector<uint32_t> &indices,
+                                    std::size_t target_index_count,
+                                    float max_error);
+
+} // namespace ankh
@@ -1,16 +1,133 @@
 // src/scene/mesh.cpp
 #include "mesh.hpp"
+#include "scene/mesh-optimizer.hpp"
+#include "scene/mesh-simplifier.hpp"
 #include "utils/types.hpp" // for Vertex, kVertices, kIndices
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace ankh
 {
 
-    Mesh::Mesh(std::vector<Vertex> vertices, std::vector<uint16_t> indices)
+    namespace
+    {
+        MeshBounds compute_bounds(const std::vector<Vertex> &vertices)
+        {
+            MeshBounds b{};
+
+            if (vertices.empty())
+            {
+                return b;
+            }
+
+            b.min = vertices.front().pos;
+            b.max = vertices.front().pos;
+            for (const auto &v : vertices)
+            {
+                b.min = glm::min(b.min, v.pos);
+                b.max = glm::max(b.max, v.pos);
+            }
+
+            // Sphere around the AABB center, tightened to the farthest vertex
+            const glm::vec3 center = 0.5f * (b.min + b.max);
+            float radius2 = 0.0f;
+            for (const auto &v : vertices)
+            {
+                const glm::vec3 d = v.pos - center;
+                radius2 = std::max(radius2, glm::dot(d, d));
+            }
+
+            b.sphere = glm::vec4(center, std::sqrt(radius2));
+            b.valid = true;
+            return b;
+        }
+    } // namespace
+
+    Mesh::Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices)
         : m_vertices(std::move(vertices))
         , m_indices(std::move(indices))
+        , m_bounds(compute_bounds(m_vertices))
+        , m_vertex_format(select_vertex_format(m_vertices))
     {
     }
 
+    Mesh::Mesh(EncodedMeshData data,
+               const MeshBounds &bounds,
+               std::vector<MeshLod> lods,
+               std::vector<Meshlet> meshlets)
+        : m_lods(std::move(lods))
+        , m_meshlets(std::move(meshlets))
+        , m_bounds(bounds)
+        , m_vertex_format(data.format)
+        , m_encoded(std::move(data))
+    {
+    }
+
+    void Mesh::build_lods(uint32_t levels, float ratio)
+    {
+        if (m_encoded)
+        {
+            return;
+        }
+
+        // A level must drop at least this share of the previous one's triangles to be kept
+        constexpr float kMinReduction = 0.15f;
+
+        m_lods.clear();
+        levels = std::min(levels, MAX_MESH_LODS - 1);
+
+        m_lods.reserve(levels);
+
+        const std::vector<uint32_t> *previous = &m_indices;
+        float error = 0.0f;
+
+        for (uint32_t level = 0; level < levels; ++level)
+        {
+            const std::size_t target =
+                static_cast<std::size_t>(static_cast<float>(previous->size() / 3) * ratio) * 3;
+
+            SimplifiedIndices lod = simplify_mesh(m_vertices,
+                                                  *previous,
+                                                  target,
+                                                  std::numeric_limits<float>::max());
+
+            if (lod.indices.empty() ||
+                static_cast<float>(lod.indices.size()) >
+                    (1.0f - kMinReduction) * static_cast<float>(previous->size()))
+            {
+                break;
+            }
+
+            // Each level is simplified from the previous one, so deviations add up
+            error += lod.error;
+
+            // Collapses scatter the surviving triangles; restore cache-friendly order
+            optimize_vertex_cache(lod.indices, m_vertices.size());
+
+            m_lods.push_back(MeshLod{std::move(lod.indices), error});
+            previous = &m_lods.back().indices;
+        }
+    }
+
+    void Mesh::build_meshlets(std::size_t min_triangles)
+    {
+        if (m_encoded)
+        {
+            return;
+        }
+
+        m_meshlets.clear();
+
+        if (m_indices.size() / 3 < min_triangles)
+        {
+            return;
+        }
+
+        m_meshlets = ankh::build_meshlets(m_vertices, m_indices);
+    }
+
     Mesh Mesh::make_colored_quad()
     {
         std::vector<Vertex> verts = {
@@ -21,7 +138,7 @@ namespace ankh
             {{-0.5f, 0.5f, 0.0f},   {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f}},  // top-left
         };
 
-        std::vector<uint16_t> inds = {0, 1, 2, 2, 3, 0};
+        std::vector<uint32_t> inds = {0, 1, 2, 2, 3, 0};
 
         return Mesh{std::move(verts), std::move(inds)};
     }
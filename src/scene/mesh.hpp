@@ -1,31 +1,111 @@
 // src/scene/mesh.hpp
 #pragma once
+#include "scene/meshlet-builder.hpp"
 #include "utils/types.hpp"
+#include "utils/vertex-format.hpp"
 
+#include <array>
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace ankh
 {
 
+    // Mesh-local bounding volumes, computed once when the mesh is built
+    struct MeshBounds
+    {
+        glm::vec3 min{0.0f};
+        glm::vec3 max{0.0f};
+        glm::vec4 sphere{0.0f}; // xyz center (AABB center), w radius
+        bool valid{false};      // false for meshes without vertices
+    };
+
+    // Levels of detail per mesh, including the full-detail level 0
+    inline constexpr uint32_t MAX_MESH_LODS = 4;
+
+    // A simplified version of a mesh: another index list over the same vertices
+    struct MeshLod
+    {
+        std::vector<uint32_t> indices;
+        float error{0.0f}; // geometric deviation from level 0, mesh-local units
+    };
+
+    // Geometry kept outside the mesh, already in its GPU encoding (a mapped cooked
+    // package): GpuMeshPool copies it straight into staging memory
+    struct EncodedMeshData
+    {
+        std::shared_ptr<const void> owner; // keeps the bytes below alive
+        const uint8_t *vertices{nullptr};  // vertexCount vertices encoded as 'format'
+        uint32_t vertexCount{0};
+        VertexFormat format{VertexFormat::Float};
+        IndexWidth indexWidth{IndexWidth::U16};
+        std::array<const uint8_t *, MAX_MESH_LODS> indices{}; // per level, 'indexWidth' each
+        std::array<uint32_t, MAX_MESH_LODS> indexCounts{};
+    };
+
     class Mesh
     {
       public:
         Mesh() = default;
 
-        Mesh(std::vector<Vertex> vertices, std::vector<uint16_t> indices);
+        Mesh(std::vector<Vertex> vertices, std::vector<uint32_t> indices);
+
+        // GPU-only mesh: no CPU vertices or indices, 'lods' carry only their errors (for
+        // LOD selection) and 'meshlets' index level 0 of 'data'
+        Mesh(EncodedMeshData data,
+             const MeshBounds &bounds,
+             std::vector<MeshLod> lods,
+             std::vector<Meshlet> meshlets);
 
         const std::vector<Vertex> &vertices() const { return m_vertices; }
-        const std::vector<uint16_t> &indices() const { return m_indices; }
+        const std::vector<uint32_t> &indices() const { return m_indices; }
 
         std::size_t vertex_count() const { return m_vertices.size(); }
         std::size_t index_count() const { return m_indices.size(); }
 
+        const MeshBounds &bounds() const { return m_bounds; }
+
+        // GPU encoding picked for the vertices when the mesh was built
+        VertexFormat vertex_format() const { return m_vertex_format; }
+
+        // GPU index width: 16-bit unless the mesh has more than 65536 vertices
+        IndexWidth index_width() const
+        {
+            return m_encoded ? m_encoded->indexWidth : select_index_width(m_vertices.size());
+        }
+
+        // Pre-encoded geometry of a GPU-only mesh, nullptr for meshes built from vertices
+        const EncodedMeshData *encoded() const { return m_encoded ? &*m_encoded : nullptr; }
+
+        // Simplified levels 1..n (level 0 is indices()), coarsest last
+        const std::vector<MeshLod> &lods() const { return m_lods; }
+
+        // Replace lods() with up to 'levels' (clamped to MAX_MESH_LODS - 1) quadric
+        // simplifications, each keeping about 'ratio' of the previous level's triangles.
+        // Stops early once a level no longer shrinks meaningfully. GPU-only meshes keep
+        // the levels they were cooked with.
+        void build_lods(uint32_t levels, float ratio = 0.5f);
+
+        // Clusters of level 0, as index ranges of indices() (empty: drawn whole)
+        const std::vector<Meshlet> &meshlets() const { return m_meshlets; }
+
+        // Split level 0 into meshlets (reordering indices()) when the mesh has at least
+        // 'min_triangles' triangles; smaller meshes gain nothing from cluster culling.
+        // GPU-only meshes keep the meshlets they were cooked with.
+        void build_meshlets(std::size_t min_triangles);
+
         // Create simple colored quad mesh
         static Mesh make_colored_quad();
 
       private:
         std::vector<Vertex> m_vertices;
-        std::vector<uint16_t> m_indices;
+        std::vector<uint32_t> m_indices;
+        std::vector<MeshLod> m_lods;
+        std::vector<Meshlet> m_meshlets;
+        MeshBounds m_bounds{};
+        VertexFormat m_vertex_format{VertexFormat::Float};
+        std::optional<EncodedMeshData> m_encoded; // GPU-only meshes
     };
 
 } // namespace ankh
@@ -0,0 +1,240 @@
+// src/scene/meshlet-builder.cpp
+#include "scene/meshlet-builder.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace ankh
+{
+    namespace
+    {
+        // A meshlet with no neighbouring triangle left keeps filling in input order below
+        // this size, so small disconnected pieces don't each become their own draw
+        constexpr uint32_t kMinMeshletTriangles = MESHLET_MAX_TRIANGLES / 4;
+
+        // Smallest cosine between a triangle normal and the cone axis for a usable cone;
+        // wider clusters are backfacing from too few directions to be worth testing
+        constexpr float kMinConeCos = 0.1f;
+
+        constexpr uint32_t kNone = ~0u;
+
+        void compute_bounds(const std::vector<Vertex> &vertices,
+                            const uint32_t *indices,
+                            uint32_t count,
+                            Meshlet &m)
+        {
+            glm::vec3 lo(FLT_MAX);
+            glm::vec3 hi(-FLT_MAX);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                lo = glm::min(lo, vertices[indices[i]].pos);
+                hi = glm::max(hi, vertices[indices[i]].pos);
+            }
+
+            const glm::vec3 center = 0.5f * (lo + hi);
+            float radius2 = 0.0f;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const glm::vec3 d = vertices[indices[i]].pos - center;
+                radius2 = std::max(radius2, glm::dot(d, d));
+            }
+            m.sphere = glm::vec4(center, std::sqrt(radius2));
+
+            // Unit face normals (counter-clockwise front faces, as rasterized)
+            std::vector<glm::vec3> normals;
+            normals.reserve(count / 3);
+            glm::vec3 sum(0.0f);
+            for (uint32_t t = 0; t + 2 < count; t += 3)
+            {
+                const glm::vec3 &a = vertices[indices[t]].pos;
+                const glm::vec3 n = glm::cross(vertices[indices[t + 1]].pos - a,
+                                               vertices[indices[t + 2]].pos - a);
+                const float len = glm::length(n);
+                if (len > 0.0f)
+                {
+                    normals.push_back(n / len);
+                    sum += normals.back();
+                }
+            }
+
+            const float sumLength = glm::length(sum);
+            if (normals.empty() || sumLength <= 0.0f)
+            {
+                return; // no usable cone: keeps w = 1
+            }
+
+            const glm::vec3 axis = sum / sumLength;
+            float minCos = 1.0f;
+            for (const glm::vec3 &n : normals)
+            {
+                minCos = std::min(minCos, glm::dot(axis, n));
+            }
+
+            if (minCos < kMinConeCos)
+            {
+                return;
+            }
+
+            // The normals lie within acos(minCos) of the axis; every triangle faces away
+            // from views inside the cone of half-angle 90 - acos(minCos) around the axis,
+            // whose cosine is sin(acos(minCos))
+            m.cone = glm::vec4(axis, std::sqrt(1.0f - minCos * minCos));
+        }
+    } // namespace
+
+    std::vector<Meshlet> build_meshlets(const std::vector<Vertex> &vertices,
+                                        std::vector<uint32_t> &indices)
+    {
+        const uint32_t n = static_cast<uint32_t>(vertices.size());
+        const uint32_t triCount = static_cast<uint32_t>(indices.size() / 3);
+
+        std::vector<Meshlet> meshlets;
+        if (triCount == 0)
+        {
+            return meshlets;
+        }
+
+        // Triangles around each vertex
+        std::vector<uint32_t> offsets(n + 1, 0);
+        for (uint32_t i = 0; i < 3 * triCount; ++i)
+        {
+            ++offsets[indices[i] + 1];
+        }
+        for (uint32_t v = 0; v < n; ++v)
+        {
+            offsets[v + 1] += offsets[v];
+        }
+
+        std::vector<uint32_t> adjacency(3 * triCount);
+        {
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (uint32_t i = 0; i < 3 * triCount; ++i)
+            {
+                adjacency[cursor[indices[i]]++] = i / 3;
+            }
+        }
+
+        std::vector<uint8_t> emitted(triCount, 0);
+        std::vector<uint32_t> owner(n, kNone); // meshlet that last took each vertex
+        std::vector<uint32_t> result;
+        result.reserve(3 * triCount);
+
+        std::vector<uint32_t> candidates; // unemitted triangles touching the meshlet
+        uint32_t seed = 0;
+
+        while (result.size() < 3 * static_cast<std::size_t>(triCount))
+        {
+            const uint32_t id = static_cast<uint32_t>(meshlets.size());
+
+            Meshlet m;
+            m.firstIndex = static_cast<uint32_t>(result.size());
+            uint32_t vertexCount = 0;
+            uint32_t triangles = 0;
+            candidates.clear();
+
+            // Vertices of triangle t the meshlet doesn't hold yet
+            const auto added_vertices = [&](uint32_t t)
+            {
+                const uint32_t *tri = &indices[3 * t];
+                uint32_t added = owner[tri[0]] != id ? 1u : 0u;
+                added += (owner[tri[1]] != id && tri[1] != tri[0]) ? 1u : 0u;
+                added += (owner[tri[2]] != id && tri[2] != tri[0] && tri[2] != tri[1]) ? 1u : 0u;
+                return added;
+            };
+
+            const auto take = [&](uint32_t t)
+            {
+                emitted[t] = 1;
+                ++triangles;
+
+                for (int k = 0; k < 3; ++k)
+                {
+                    const uint32_t v = indices[3 * t + k];
+                    result.push_back(v);
+
+                    if (owner[v] == id)
+                    {
+                        continue;
+                    }
+
+                    owner[v] = id;
+                    ++vertexCount;
+                    for (uint32_t a = offsets[v]; a < offsets[v + 1]; ++a)
+                    {
+                        if (!emitted[adjacency[a]])
+                        {
+                            candidates.push_back(adjacency[a]);
+                        }
+                    }
+                }
+            };
+
+            while (emitted[seed])
+            {
+                ++seed;
+            }
+            take(seed);
+
+            while (triangles < MESHLET_MAX_TRIANGLES)
+            {
+                // Neighbour adding the fewest vertices; earliest found wins ties, which
+                // keeps the input (vertex cache) order where it can
+                uint32_t best = kNone;
+                uint32_t bestAdded = 4;
+
+                std::size_t live = 0;
+                for (uint32_t t : candidates)
+                {
+                    if (emitted[t])
+                    {
+                        continue;
+                    }
+                    candidates[live++] = t;
+
+                    if (bestAdded == 0)
+                    {
+                        continue;
+                    }
+
+                    const uint32_t added = added_vertices(t);
+                    if (added < bestAdded && vertexCount + added <= MESHLET_MAX_VERTICES)
+                    {
+                        best = t;
+                        bestAdded = added;
+                    }
+                }
+                candidates.resize(live);
+
+                if (best == kNone)
+                {
+                    if (triangles >= kMinMeshletTriangles)
+                    {
+                        break;
+                    }
+
+                    while (seed < triCount && emitted[seed])
+                    {
+                        ++seed;
+                    }
+                    if (seed == triCount ||
+                        vertexCount + added_vertices(seed) > MESHLET_MAX_VERTICES)
+                    {
+                        break;
+                    }
+                    best = seed;
+                }
+
+                take(best);
+            }
+
+            m.indexCount = static_cast<uint32_t>(result.size()) - m.firstIndex;
+            compute_bounds(vertices, &result[m.firstIndex], m.indexCount, m);
+            meshlets.push_back(m);
+        }
+
+        indices.swap(result);
+        return meshlets;
+    }
+
+} // namespace ankh
@@ -0,0 +1,38 @@
+// src/scene/meshlet-builder.hpp
+#pragma once
+
+#include "utils/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ankh
+{
+    inline constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+    inline constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+    // Meshes below a handful of full clusters gain nothing from cluster culling and are
+    // culled as a whole object (see Mesh::build_meshlets)
+    inline constexpr std::size_t MESHLET_MIN_MESH_TRIANGLES = 4 * MESHLET_MAX_TRIANGLES;
+
+    // A cluster of neighbouring triangles: a contiguous index range of the mesh, with the
+    // bounds GPU culling tests it by (shaders/cull.comp)
+    struct Meshlet
+    {
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+        glm::vec4 sphere{0.0f}; // mesh-local xyz center, w radius
+        glm::vec4 cone{0.0f, 0.0f, 0.0f, 1.0f}; // xyz normal axis, w cutoff (1: never culled)
+    };
+
+    // Split a triangle list into meshlets of at most MESHLET_MAX_VERTICES distinct
+    // vertices and MESHLET_MAX_TRIANGLES triangles. Clusters grow across shared edges,
+    // seeded in the input's triangle order; 'indices' is reordered so every meshlet's
+    // triangles are contiguous (the set of triangles and their winding are unchanged).
+    // The cone bounds the facing of the cluster's triangles: when the camera is inside
+    // the cone's back side, all of them are backfacing (see the test in cull.comp).
+    std::vector<Meshlet> build_meshlets(const std::vector<Vertex> &vertices,
+                                        std::vector<uint32_t> &indices);
+
+} // namespace ankh
@@ -2,20 +2,30 @@
 
 #include "scene/model-loader.hpp"
 
+#include "jobs/job-system.hpp"
+#include "scene/cooked-package.hpp"
 #include "scene/material.hpp"
+#include "scene/mesh-optimizer.hpp"
 #include "scene/mesh.hpp"
+#include "utils/config.hpp"
 #include "utils/logging.hpp"
 #include "utils/types.hpp"
 
+#include <algorithm>
+#include <deque>
 #include <functional>
 #include <glm/gtc/quaternion.hpp>
-#include <limits>
+#include <sstream>
+#include <stb_image.h>
 #include <tiny-gltf.h>
 
 namespace ankh
 {
     namespace
     {
+        // Vertices converted per job; smaller primitives convert on their own job
+        constexpr uint32_t kVertexGrain = 16 * 1024;
+
         // -----------------------------
         // Node transform helpers
         // -----------------------------
@@ -118,6 +128,108 @@ namespace ankh
             return view;
         }
 
+        // -----------------------------
+        // EXT_mesh_gpu_instancing
+        // -----------------------------
+
+        // meshSlot entry of a glTF mesh no visited node references
+        constexpr uint32_t kUnusedMesh = ~0u;
+
+        // Per-instance transforms (translation * rotation * scale, relative to the node) of
+        // a node using EXT_mesh_gpu_instancing; empty when it has none. Attributes must be
+        // FLOAT; others are ignored with a warning.
+        std::vector<glm::mat4> node_instance_transforms(const tinygltf::Model &gltf,
+                                                        const tinygltf::Node &node)
+        {
+            const auto ext = node.extensions.find("EXT_mesh_gpu_instancing");
+            if (ext == node.extensions.end() || !ext->second.Has("attributes"))
+            {
+                return {};
+            }
+
+            const tinygltf::Value &attributes = ext->second.Get("attributes");
+
+            struct InstanceAttribute
+            {
+                const char *name;
+                int type;
+                FloatAttributeView view;
+            };
+
+            InstanceAttribute trs[3] = {{"TRANSLATION", TINYGLTF_TYPE_VEC3, {}},
+                                        {"ROTATION", TINYGLTF_TYPE_VEC4, {}},
+                                        {"SCALE", TINYGLTF_TYPE_VEC3, {}}};
+
+            size_t count = 0;
+            bool any = false;
+
+            for (InstanceAttribute &attr : trs)
+            {
+                if (!attributes.Has(attr.name) || !attributes.Get(attr.name).IsNumber())
+                {
+                    continue;
+                }
+
+                const int index = attributes.Get(attr.name).GetNumberAsInt();
+                if (index < 0 || index >= static_cast<int>(gltf.accessors.size()))
+                {
+                    ANKH_LOG_WARN(std::string("EXT_mesh_gpu_instancing ") + attr.name +
+                                  " accessor out of range; ignoring attribute");
+                    continue;
+                }
+
+                const tinygltf::Accessor &acc = gltf.accessors[index];
+                if (acc.type != attr.type || acc.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
+                {
+                    ANKH_LOG_WARN(std::string("EXT_mesh_gpu_instancing ") + attr.name +
+                                  " is not FLOAT; ignoring attribute");
+                    continue;
+                }
+
+                attr.view = make_float_view(gltf, acc, attr.type == TINYGLTF_TYPE_VEC4 ? 4 : 3,
+                                            attr.name);
+                if (!attr.view.base)
+                {
+                    continue;
+                }
+
+                // Counts must agree; draw only the instances every attribute covers
+                count = any ? std::min(count, attr.view.count) : attr.view.count;
+                any = true;
+            }
+
+            std::vector<glm::mat4> transforms(count, glm::mat4(1.0f));
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                glm::mat4 &M = transforms[i];
+
+                if (trs[0].view.base)
+                {
+                    const float *t =
+                        reinterpret_cast<const float *>(trs[0].view.base + i * trs[0].view.stride);
+                    M = glm::translate(M, glm::vec3(t[0], t[1], t[2]));
+                }
+
+                if (trs[1].view.base)
+                {
+                    // x, y, z, w
+                    const float *r =
+                        reinterpret_cast<const float *>(trs[1].view.base + i * trs[1].view.stride);
+                    M *= glm::mat4_cast(glm::quat(r[3], r[0], r[1], r[2]));
+                }
+
+                if (trs[2].view.base)
+                {
+                    const float *s =
+                        reinterpret_cast<const float *>(trs[2].view.base + i * trs[2].view.stride);
+                    M = glm::scale(M, glm::vec3(s[0], s[1], s[2]));
+                }
+            }
+
+            return transforms;
+        }
+
         // -----------------------------
         // Material helpers
         // -----------------------------
@@ -140,8 +252,12 @@ namespace ankh
             return baseColor;
         }
 
-        std::shared_ptr<CpuImage> load_base_color_image(const tinygltf::Model &gltf,
-                                                        const tinygltf::Material &gm)
+        // Decoded image of a material's base color texture from 'images' (indexed like
+        // gltf.images), shared by every material that samples it
+        std::shared_ptr<CpuImage> load_base_color_image(
+            const tinygltf::Model &gltf,
+            const tinygltf::Material &gm,
+            const std::vector<std::shared_ptr<CpuImage>> &images)
         {
             const auto &pbr = gm.pbrMetallicRoughness;
 
@@ -159,20 +275,76 @@ namespace ankh
                 return nullptr;
             }
 
-            const tinygltf::Image &img = gltf.images[tex.source];
-
-            if (img.width <= 0 || img.height <= 0 || img.image.empty())
+            if (!images[tex.source])
             {
                 ANKH_LOG_WARN("baseColorTexture image has no data; ignoring");
                 return nullptr;
             }
 
+            return images[tex.source];
+        }
+
+        // Materials built per job
+        constexpr uint32_t kMaterialGrain = 4;
+
+        // Decode an image the loader kept encoded (SetImagesAsIs) straight to RGBA8, the
+        // format textures are uploaded in: the decoder's buffer becomes the image's pixels
+        // (CpuImage::owner) without being copied. The encoded bytes are released. Returns
+        // null, with 'error' set, if the image can't be decoded.
+        std::shared_ptr<CpuImage> decode_image(tinygltf::Image &img, int index, std::string &error)
+        {
+            std::vector<unsigned char> encoded;
+            encoded.swap(img.image);
+
+            if (encoded.empty())
+            {
+                return nullptr;
+            }
+
             auto cpuImg = std::make_shared<CpuImage>();
-            cpuImg->width = img.width;
-            cpuImg->height = img.height;
-            cpuImg->components = img.component;
-            cpuImg->pixels = img.image; // copy byte data
 
+            // Already decoded by the loader (not expected with SetImagesAsIs): keep its bytes
+            if (!img.as_is)
+            {
+                if (img.bits != 8 || img.width <= 0 || img.height <= 0)
+                {
+                    error = "Image " + std::to_string(index) + " is not 8 bits per channel";
+                    return nullptr;
+                }
+
+                cpuImg->width = img.width;
+                cpuImg->height = img.height;
+                cpuImg->components = img.component;
+                cpuImg->pixels = std::move(encoded);
+                return cpuImg;
+            }
+
+            int width = 0;
+            int height = 0;
+            int components = 0;
+            stbi_uc *pixels = stbi_load_from_memory(encoded.data(),
+                                                    static_cast<int>(encoded.size()),
+                                                    &width,
+                                                    &height,
+                                                    &components,
+                                                    STBI_rgb_alpha);
+            if (!pixels)
+            {
+                error = "Failed to decode image " + std::to_string(index) + ": " +
+                        stbi_failure_reason();
+                return nullptr;
+            }
+
+            const std::shared_ptr<const stbi_uc> owner(pixels, stbi_image_free);
+
+            cpuImg->width = width;
+            cpuImg->height = height;
+            cpuImg->components = 4;
+            cpuImg->mapped = {owner.get(), static_cast<std::size_t>(width) * height * 4};
+            cpuImg->owner = owner;
+
+            img.width = width;
+            img.height = height;
             return cpuImg;
         }
 
@@ -180,7 +352,37 @@ namespace ankh
         // Mesh / primitive builder
         // -----------------------------
 
-        Mesh build_mesh_from_primitive(const tinygltf::Model &gltf, const tinygltf::Primitive &prim)
+        // Vertex cache cost allowed for overdraw-friendly triangle order (ACMR ratio)
+        constexpr float kOverdrawThreshold = 1.05f;
+
+        struct MeshOptimizationStats
+        {
+            VertexCacheStats before;
+            VertexCacheStats after;
+            uint32_t meshes{0};
+        };
+
+        // Triangle order for the post-transform cache, then for overdraw, then vertex
+        // order for fetch locality (the last step keeps the triangle order)
+        void optimize_primitive(std::vector<Vertex> &vertices,
+                                std::vector<uint32_t> &indices,
+                                MeshOptimizationStats &stats)
+        {
+            stats.before += analyze_vertex_cache(indices, vertices.size());
+
+            optimize_vertex_cache(indices, vertices.size());
+            optimize_overdraw(indices, vertices, kOverdrawThreshold);
+            optimize_vertex_fetch(vertices, indices);
+
+            stats.after += analyze_vertex_cache(indices, vertices.size());
+            ++stats.meshes;
+        }
+
+        Mesh build_mesh_from_primitive(const tinygltf::Model &gltf,
+                                       const tinygltf::Primitive &prim,
+                                       bool optimize,
+                                       MeshOptimizationStats &stats,
+                                       JobSystem *jobs)
         {
             // --- POSITION (required) ---
             auto posIt = prim.attributes.find("POSITION");
@@ -268,60 +470,51 @@ namespace ankh
                 }
             }
 
-            // Build vertex array
-            std::vector<Vertex> vertices;
-            vertices.resize(vertexCount);
+            // Build vertex array: one pass per attribute stream, over chunks of vertices
+            // that run as jobs for large primitives
+            std::vector<Vertex> vertices(vertexCount);
 
-            for (size_t v = 0; v < vertexCount; ++v)
+            const auto convert = [&](uint32_t first, uint32_t last)
             {
-                Vertex vert{};
-
-                // Position
-                const float *p = reinterpret_cast<const float *>(posView.base + v * posView.stride);
-                vert.pos = glm::vec3(p[0], p[1], p[2]);
+                for (size_t v = first; v < last; ++v)
+                {
+                    const float *p =
+                        reinterpret_cast<const float *>(posView.base + v * posView.stride);
+
+                    Vertex &vert = vertices[v];
+                    vert.pos = glm::vec3(p[0], p[1], p[2]);
+                    vert.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+                    vert.color = glm::vec3(1.0f);
+                    vert.uv = glm::vec2(0.0f);
+                }
 
-                glm::vec3 normal(0.0f, 0.0f, 1.0f);
-                if (normalAcc && normalView.base && v < normalView.count)
+                for (size_t v = first; v < std::min<size_t>(last, normalView.count); ++v)
                 {
                     const float *n =
                         reinterpret_cast<const float *>(normalView.base + v * normalView.stride);
-                    normal = glm::vec3(n[0], n[1], n[2]);
+                    vertices[v].normal = glm::vec3(n[0], n[1], n[2]);
                 }
-                vert.normal = normal;
 
-                // Color
-                glm::vec3 color(1.0f);
-                if (colorAcc && colorView.base && v < colorView.count)
+                // VEC3 or VEC4: alpha is dropped either way
+                for (size_t v = first; v < std::min<size_t>(last, colorView.count); ++v)
                 {
                     const float *c =
                         reinterpret_cast<const float *>(colorView.base + v * colorView.stride);
-
-                    if (colorAcc->type == TINYGLTF_TYPE_VEC3)
-                    {
-                        color = glm::vec3(c[0], c[1], c[2]);
-                    }
-                    else // VEC4
-                    {
-                        color = glm::vec3(c[0], c[1], c[2]);
-                    }
+                    vertices[v].color = glm::vec3(c[0], c[1], c[2]);
                 }
-                vert.color = color;
 
-                // UV
-                glm::vec2 uv(0.0f);
-                if (uvAcc && uvView.base && v < uvView.count)
+                for (size_t v = first; v < std::min<size_t>(last, uvView.count); ++v)
                 {
                     const float *u =
                         reinterpret_cast<const float *>(uvView.base + v * uvView.stride);
-                    uv = glm::vec2(u[0], u[1]);
+                    vertices[v].uv = glm::vec2(u[0], u[1]);
                 }
-                vert.uv = uv;
+            };
 
-                vertices[v] = vert;
-            }
+            for_range(jobs, static_cast<uint32_t>(vertexCount), kVertexGrain, convert);
 
             // Indices
-            std::vector<uint16_t> indices;
+            std::vector<uint32_t> indices;
 
             if (prim.indices >= 0)
             {
@@ -368,13 +561,12 @@ namespace ankh
                         break;
                     }
 
-                    if (value > std::numeric_limits<uint16_t>::max())
+                    if (value >= vertexCount)
                     {
-                        ANKH_THROW_MSG("Index value exceeds uint16 range; upgrade Mesh "
-                                       "to uint32 to support this model");
+                        ANKH_THROW_MSG("Index value exceeds the primitive's vertex count");
                     }
 
-                    indices.push_back(static_cast<uint16_t>(value));
+                    indices.push_back(value);
                 }
             }
             else
@@ -386,6 +578,11 @@ namespace ankh
                 }
             }
 
+            if (optimize && indices.size() >= 3)
+            {
+                optimize_primitive(vertices, indices, stats);
+            }
+
             return Mesh(std::move(vertices), std::move(indices));
         }
 
@@ -397,7 +594,8 @@ namespace ankh
 
     Model ModelLoader::load_gltf(const std::string &path,
                                  MeshPool &mesh_pool,
-                                 MaterialPool &material_pool)
+                                 MaterialPool &material_pool,
+                                 JobSystem *jobs)
     {
         ANKH_LOG_DEBUG("[ModelLoader] LoadGltf(\"" + path + "\")");
 
@@ -406,6 +604,9 @@ namespace ankh
         std::string err;
         std::string warn;
 
+        // Images stay encoded here and are decoded in parallel below
+        loader.SetImagesAsIs(true);
+
         bool ok = false;
         if (path.size() >= 5 &&
             (path.substr(path.size() - 5) == ".gltf" || path.substr(path.size() - 5) == ".GLTF"))
@@ -429,105 +630,467 @@ namespace ankh
 
         Model model(path);
 
-        // --- Materials ---
-        std::vector<MaterialHandle> material_handles;
-        material_handles.reserve(gltf.materials.size());
-
-        for (const auto &gm : gltf.materials)
+        // --- Images (only those materials sample) ---
+        std::vector<int> images;
         {
-            glm::vec4 baseColor = load_base_color_factor(gm);
-            Material mat(baseColor);
-
-            auto cpuImg = load_base_color_image(gltf, gm);
-            if (cpuImg)
+            std::vector<uint8_t> used(gltf.images.size(), 0);
+            for (const auto &gm : gltf.materials)
             {
-                mat.set_base_color_image(cpuImg);
+                const int texture = gm.pbrMetallicRoughness.baseColorTexture.index;
+                if (texture >= 0 && texture < static_cast<int>(gltf.textures.size()))
+                {
+                    const int source = gltf.textures[texture].source;
+                    if (source >= 0 && source < static_cast<int>(used.size()) && !used[source])
+                    {
+                        used[source] = 1;
+                        images.push_back(source);
+                    }
+                }
             }
-            else
+        }
+
+        // Decoded once per image, however many materials sample it
+        std::vector<std::shared_ptr<CpuImage>> imageCache(gltf.images.size());
+        std::vector<std::string> imageErrors(images.size());
+        for_range(jobs,
+                  static_cast<uint32_t>(images.size()),
+                  1,
+                  [&](uint32_t first, uint32_t last)
+                  {
+                      for (uint32_t i = first; i < last; ++i)
+                      {
+                          imageCache[images[i]] =
+                              decode_image(gltf.images[images[i]], images[i], imageErrors[i]);
+                      }
+                  });
+
+        for (const std::string &message : imageErrors)
+        {
+            if (!message.empty())
             {
-                ANKH_LOG_DEBUG("[ModelLoader] Material has NO baseColorTexture");
+                ANKH_LOG_WARN("[ModelLoader] " + message);
             }
-
-            MaterialHandle mh = material_pool.create(mat);
-            material_handles.push_back(mh);
         }
 
+        // --- Materials ---
+        // Handles are reserved up front, so material i is firstMaterial + i however the
+        // jobs run
+        const uint32_t materialCount = static_cast<uint32_t>(gltf.materials.size());
+        const MaterialHandle firstMaterial = material_pool.reserve_handles(materialCount);
+
+        for_range(jobs,
+                  materialCount,
+                  kMaterialGrain,
+                  [&](uint32_t first, uint32_t last)
+                  {
+                      for (uint32_t i = first; i < last; ++i)
+                      {
+                          const tinygltf::Material &gm = gltf.materials[i];
+                          Material mat(load_base_color_factor(gm));
+
+                          auto cpuImg = load_base_color_image(gltf, gm, imageCache);
+                          if (cpuImg)
+                          {
+                              mat.set_base_color_image(cpuImg);
+                          }
+                          else
+                          {
+                              ANKH_LOG_DEBUG("[ModelLoader] Material has NO baseColorTexture");
+                          }
+
+                          material_pool.set(firstMaterial + i, std::move(mat));
+                      }
+                  });
+
         // --- Scene traversal ---
+        // Breadth-first, so model nodes come out in TransformHierarchy order. A glTF node
+        // becomes one model node carrying its first primitive; further primitives become
+        // identity children of it. With EXT_mesh_gpu_instancing the node itself carries
+        // no mesh and each instance becomes such a child carrying the instance transform.
+        std::vector<int> roots;
+
         int sceneIndex = gltf.defaultScene >= 0 ? gltf.defaultScene : 0;
 
-        auto processNode = [&](auto &&self, int nodeIndex, const glm::mat4 &parentTransform) -> void
+        if (sceneIndex >= 0 && sceneIndex < static_cast<int>(gltf.scenes.size()))
+        {
+            roots = gltf.scenes[sceneIndex].nodes;
+        }
+        else
         {
-            if (nodeIndex < 0 || nodeIndex >= static_cast<int>(gltf.nodes.size()))
+            ANKH_LOG_WARN("[ModelLoader] glTF has no valid scenes; traversing all nodes as roots");
+            for (int nodeIndex = 0; nodeIndex < static_cast<int>(gltf.nodes.size()); ++nodeIndex)
             {
-                return;
+                roots.push_back(nodeIndex);
             }
+        }
 
-            const tinygltf::Node &node = gltf.nodes[nodeIndex];
+        const auto valid_node = [&](int node)
+        {
+            return node >= 0 && node < static_cast<int>(gltf.nodes.size());
+        };
 
-            glm::mat4 local = node_local_transform(node);
-            glm::mat4 world = parentTransform * local;
+        const auto node_mesh = [&](int node)
+        {
+            const int mesh = gltf.nodes[node].mesh;
+            return (mesh >= 0 && mesh < static_cast<int>(gltf.meshes.size())) ? mesh : -1;
+        };
 
-            // Mesh + primitives
-            if (node.mesh >= 0 && node.mesh < static_cast<int>(gltf.meshes.size()))
+        // Pass 1: the glTF meshes the scene references, in the order nodes are visited.
+        // Each one is decoded once; every node and instance using it shares its handles.
+        std::vector<uint32_t> meshSlot(gltf.meshes.size(), kUnusedMesh);
+        std::vector<const tinygltf::Primitive *> primitives;
+        {
+            std::deque<int> pending(roots.begin(), roots.end());
+            while (!pending.empty())
             {
-                const tinygltf::Mesh &gltfMesh = gltf.meshes[node.mesh];
+                const int node = pending.front();
+                pending.pop_front();
 
-                for (const auto &prim : gltfMesh.primitives)
+                if (!valid_node(node))
                 {
-                    try
-                    {
-                        Mesh mesh = build_mesh_from_primitive(gltf, prim);
-                        MeshHandle mesh_handle = mesh_pool.create(std::move(mesh));
-
-                        MaterialHandle mat_handle = INVALID_MATERIAL_HANDLE;
-                        if (prim.material >= 0 &&
-                            prim.material < static_cast<int>(material_handles.size()))
-                        {
-                            mat_handle = material_handles[prim.material];
-                        }
-
-                        ModelNode nodeEntry{};
-                        nodeEntry.mesh = mesh_handle;
-                        nodeEntry.material = mat_handle;
-                        nodeEntry.local_transform = world; // baked world transform
-
-                        model.nodes().push_back(nodeEntry);
-                    }
-                    catch (const std::exception &e)
+                    continue;
+                }
+
+                const int mesh = node_mesh(node);
+                if (mesh >= 0 && meshSlot[mesh] == kUnusedMesh)
+                {
+                    meshSlot[mesh] = static_cast<uint32_t>(primitives.size());
+                    for (const auto &prim : gltf.meshes[mesh].primitives)
                     {
-                        ANKH_LOG_WARN("[ModelLoader] Skipping primitive: " + std::string(e.what()));
+                        primitives.push_back(&prim);
                     }
                 }
+
+                for (int child : gltf.nodes[node].children)
+                {
+                    pending.push_back(child);
+                }
+            }
+        }
+
+        // Decode every primitive as its own job into its reserved handle; a primitive
+        // that fails leaves its handle invalid
+        const uint32_t primitiveCount = static_cast<uint32_t>(primitives.size());
+        const MeshHandle firstMesh = mesh_pool.reserve_handles(primitiveCount);
+
+        std::vector<MeshOptimizationStats> optimizationStats(primitiveCount);
+
+        // Read on this thread; the jobs below only see the copy
+        const bool optimize = ankh::config().optimizeMeshes;
+
+        for_range(jobs,
+                  primitiveCount,
+                  1,
+                  [&](uint32_t first, uint32_t last)
+                  {
+                      for (uint32_t i = first; i < last; ++i)
+                      {
+                          try
+                          {
+                              mesh_pool.set(firstMesh + i,
+                                            build_mesh_from_primitive(gltf,
+                                                                      *primitives[i],
+                                                                      optimize,
+                                                                      optimizationStats[i],
+                                                                      jobs));
+                          }
+                          catch (const std::exception &e)
+                          {
+                              ANKH_LOG_WARN("[ModelLoader] Skipping primitive: " +
+                                            std::string(e.what()));
+                          }
+                      }
+                  });
+
+        // Pass 2: model nodes. Mesh-only nodes are GPU instances (child of their glTF
+        // node, carrying the instance transform) and extra primitives (identity child of
+        // the node carrying the first one).
+        struct PendingNode
+        {
+            int gltfNode{-1}; // -1: mesh-only node
+            int32_t parent{-1};
+            int instanceMesh{-1};                 // instance: glTF mesh to attach
+            glm::mat4 transform{1.0f};            // instance: local transform
+            MeshHandle mesh{INVALID_MESH_HANDLE}; // extra primitive: mesh/material to use
+            MaterialHandle material{INVALID_MATERIAL_HANDLE};
+        };
+
+        std::deque<PendingNode> pending;
+        for (int root : roots)
+        {
+            pending.push_back(PendingNode{root});
+        }
+
+        uint32_t meshReferences = 0;
+
+        // Give 'entry' (model node 'self') the first decoded primitive of glTF mesh
+        // 'mesh' and queue the others as its children
+        const auto attach_mesh = [&](ModelNode &entry, int32_t self, int mesh)
+        {
+            ++meshReferences;
+
+            const auto &prims = gltf.meshes[mesh].primitives;
+            for (uint32_t p = 0; p < prims.size(); ++p)
+            {
+                const MeshHandle mesh_handle = firstMesh + meshSlot[mesh] + p;
+                if (!mesh_pool.valid(mesh_handle))
+                {
+                    continue; // failed to decode (already reported)
+                }
+
+                MaterialHandle mat_handle = INVALID_MATERIAL_HANDLE;
+                if (prims[p].material >= 0 &&
+                    static_cast<uint32_t>(prims[p].material) < materialCount)
+                {
+                    mat_handle = firstMaterial + static_cast<MaterialHandle>(prims[p].material);
+                }
+
+                if (entry.mesh == INVALID_MESH_HANDLE)
+                {
+                    entry.mesh = mesh_handle;
+                    entry.material = mat_handle;
+                }
+                else
+                {
+                    PendingNode extra{};
+                    extra.parent = self;
+                    extra.mesh = mesh_handle;
+                    extra.material = mat_handle;
+                    pending.push_back(extra);
+                }
             }
+        };
+
+        uint32_t instanceCount = 0;
+
+        while (!pending.empty())
+        {
+            const PendingNode item = pending.front();
+            pending.pop_front();
+
+            const int32_t self = static_cast<int32_t>(model.nodes().size());
+
+            if (item.gltfNode < 0)
+            {
+                ModelNode meshNode{};
+                meshNode.local_transform = item.transform;
+                meshNode.parent = item.parent;
+
+                if (item.instanceMesh >= 0)
+                {
+                    attach_mesh(meshNode, self, item.instanceMesh);
+                }
+                else
+                {
+                    meshNode.mesh = item.mesh;
+                    meshNode.material = item.material;
+                }
+
+                model.nodes().push_back(meshNode);
+                continue;
+            }
+
+            if (!valid_node(item.gltfNode))
+            {
+                continue;
+            }
+
+            const tinygltf::Node &node = gltf.nodes[item.gltfNode];
+
+            ModelNode nodeEntry{};
+            nodeEntry.local_transform = node_local_transform(node);
+            nodeEntry.parent = item.parent;
+
+            // Mesh + primitives, drawn once per instance when the node has any
+            if (const int mesh = node_mesh(item.gltfNode); mesh >= 0)
+            {
+                const std::vector<glm::mat4> instances = node_instance_transforms(gltf, node);
+                if (instances.empty())
+                {
+                    attach_mesh(nodeEntry, self, mesh);
+                }
+
+                for (const glm::mat4 &transform : instances)
+                {
+                    PendingNode instance{};
+                    instance.parent = self;
+                    instance.instanceMesh = mesh;
+                    instance.transform = transform;
+                    pending.push_back(instance);
+                }
+                instanceCount += static_cast<uint32_t>(instances.size());
+            }
+
+            model.nodes().push_back(nodeEntry);
 
             // Children
             for (int childIndex : node.children)
             {
-                self(self, childIndex, world);
+                if (valid_node(childIndex))
+                {
+                    pending.push_back(PendingNode{childIndex, self});
+                }
             }
-        };
+        }
 
-        glm::mat4 identity(1.0f);
+        const uint32_t decodedMeshes = static_cast<uint32_t>(
+            std::count_if(meshSlot.begin(), meshSlot.end(), [](uint32_t slot)
+                          { return slot != kUnusedMesh; }));
 
-        if (sceneIndex >= 0 && sceneIndex < static_cast<int>(gltf.scenes.size()))
+        if (meshReferences > decodedMeshes)
+        {
+            ANKH_LOG_INFO("[ModelLoader] " + std::to_string(meshReferences) +
+                          " mesh references (" + std::to_string(instanceCount) +
+                          " GPU instances) share " + std::to_string(decodedMeshes) +
+                          " decoded glTF meshes");
+        }
+
+        ANKH_LOG_DEBUG("[ModelLoader] LoadGltf loaded " + std::to_string(model.nodes().size()) +
+                       " model nodes.");
+
+        MeshOptimizationStats optimization;
+        for (const MeshOptimizationStats &stats : optimizationStats)
+        {
+            optimization.before += stats.before;
+            optimization.after += stats.after;
+            optimization.meshes += stats.meshes;
+        }
+
+        if (optimization.meshes != 0)
+        {
+            std::ostringstream line;
+            line.precision(3);
+            line << "[ModelLoader] Optimized " << optimization.meshes << " meshes of '" << path
+                 << "': ACMR " << optimization.before.acmr() << " -> "
+                 << optimization.after.acmr() << ", ATVR " << optimization.before.atvr()
+                 << " -> " << optimization.after.atvr();
+
+            ANKH_LOG_INFO(line.str());
+        }
+
+        return model;
+    }
+
+    Model ModelLoader::load_package(const std::string &path,
+                                    MeshPool &mesh_pool,
+                                    MaterialPool &material_pool)
+    {
+        ANKH_LOG_DEBUG("[ModelLoader] LoadPackage(\"" + path + "\")");
+
+        std::shared_ptr<const CookedPackage> package;
+        try
+        {
+            package = CookedPackage::open(path);
+        }
+        catch (const std::exception &e)
+        {
+            ANKH_LOG_ERROR("[ModelLoader] Failed to load package: " + path + " error: " +
+                           e.what());
+            return Model(path);
+        }
+
+        Model model(path);
+
+        // --- Meshes: descriptors over the mapped blobs ---
+        const auto meshes = package->meshes();
+        const auto lods = package->lods();
+        const auto clusters = package->clusters();
+
+        const MeshHandle firstMesh =
+            mesh_pool.reserve_handles(static_cast<uint32_t>(meshes.size()));
+
+        for (uint32_t i = 0; i < meshes.size(); ++i)
         {
-            const tinygltf::Scene &scene = gltf.scenes[sceneIndex];
-            for (int nodeIndex : scene.nodes)
+            const PackageMesh &pm = meshes[i];
+
+            EncodedMeshData data{};
+            data.owner = package;
+            data.vertices = package->data(pm.vertices);
+            data.vertexCount = pm.vertexCount;
+            data.format = static_cast<VertexFormat>(pm.vertexFormat);
+            data.indexWidth = static_cast<IndexWidth>(pm.indexWidth);
+
+            std::vector<MeshLod> levels;
+            for (uint32_t l = 0; l < pm.lodCount; ++l)
             {
-                processNode(processNode, nodeIndex, identity);
+                const PackageLod &lod = lods[pm.firstLod + l];
+                data.indices[l] = package->data(lod.indices);
+                data.indexCounts[l] = lod.indexCount;
+
+                if (l != 0)
+                {
+                    levels.push_back(MeshLod{{}, lod.error});
+                }
             }
+
+            MeshBounds bounds{};
+            bounds.min = pm.boundsMin;
+            bounds.max = pm.boundsMax;
+            bounds.sphere = pm.sphere;
+            bounds.valid = pm.boundsValid != 0;
+
+            const auto meshlets = clusters.subspan(pm.firstCluster, pm.clusterCount);
+
+            mesh_pool.set(firstMesh + i,
+                          Mesh(std::move(data),
+                               bounds,
+                               std::move(levels),
+                               std::vector<Meshlet>(meshlets.begin(), meshlets.end())));
         }
-        else
+
+        // --- Materials ---
+        const auto images = package->images();
+        const auto materials = package->materials();
+
+        const MaterialHandle firstMaterial =
+            material_pool.reserve_handles(static_cast<uint32_t>(materials.size()));
+
+        // One CpuImage per package image, shared by the materials that sample it
+        std::vector<std::shared_ptr<CpuImage>> imageCache(images.size());
+
+        for (uint32_t i = 0; i < materials.size(); ++i)
         {
-            ANKH_LOG_WARN("[ModelLoader] glTF has no valid scenes; traversing all nodes as roots");
-            for (int nodeIndex = 0; nodeIndex < static_cast<int>(gltf.nodes.size()); ++nodeIndex)
+            const PackageMaterial &pm = materials[i];
+            Material mat(pm.albedo);
+
+            if (pm.image != PACKAGE_NONE)
             {
-                processNode(processNode, nodeIndex, identity);
+                std::shared_ptr<CpuImage> &cpuImg = imageCache[pm.image];
+                if (!cpuImg)
+                {
+                    const PackageImage &pi = images[pm.image];
+
+                    cpuImg = std::make_shared<CpuImage>();
+                    cpuImg->width = static_cast<int>(pi.width);
+                    cpuImg->height = static_cast<int>(pi.height);
+                    cpuImg->components = 4;
+                    cpuImg->mapped = {package->data(pi.pixels),
+                                      static_cast<std::size_t>(pi.pixels.size)};
+                    cpuImg->owner = package;
+                }
+                mat.set_base_color_image(cpuImg);
             }
+
+            material_pool.set(firstMaterial + i, std::move(mat));
         }
 
-        ANKH_LOG_DEBUG("[ModelLoader] LoadGltf loaded " + std::to_string(model.nodes().size()) +
-                       " model nodes.");
+        // --- Nodes (already breadth-first) ---
+        model.nodes().reserve(package->nodes().size());
+        for (const PackageNode &pn : package->nodes())
+        {
+            ModelNode node{};
+            node.local_transform = pn.localTransform;
+            node.parent = pn.parent;
+            node.mesh = pn.mesh == PACKAGE_NONE ? INVALID_MESH_HANDLE : firstMesh + pn.mesh;
+            node.material = pn.material == PACKAGE_NONE ? INVALID_MATERIAL_HANDLE
+                                                        : firstMaterial + pn.material;
+            model.nodes().push_back(node);
+        }
+
+        ANKH_LOG_INFO("[ModelLoader] Mapped package '" + path + "': " +
+                      std::to_string(meshes.size()) + " meshes, " +
+                      std::to_string(materials.size()) + " materials, " +
+                      std::to_string(model.nodes().size()) + " nodes");
 
         return model;
     }
@@ -7,13 +7,28 @@
 
 namespace ankh
 {
+    class JobSystem;
+
     class ModelLoader
     {
       public:
         // Loads .gltf or .glb, creates Mesh/Material in pools,
         // returns a Model whose nodes reference them via handles.
-        static Model
-        load_gltf(const std::string &path, MeshPool &mesh_pool, MaterialPool &material_pool);
+        // With a JobSystem, images, materials and primitives are decoded in parallel;
+        // the handles and nodes come out the same as a serial load.
+        // Each glTF mesh is decoded once: every node referencing it, and every instance of
+        // an EXT_mesh_gpu_instancing node, shares its handles.
+        static Model load_gltf(const std::string &path,
+                               MeshPool &mesh_pool,
+                               MaterialPool &material_pool,
+                               JobSystem *jobs = nullptr);
+
+        // Loads a package written by ankh_cook (scene/cooked-package.hpp). Meshes are
+        // GPU-only views of the mapped file and images view their pixels in place; the
+        // mapping stays open while any of them is alive.
+        static Model load_package(const std::string &path,
+                                  MeshPool &mesh_pool,
+                                  MaterialPool &material_pool);
     };
 
 } // namespace ankh
@@ -7,11 +7,14 @@
 
 namespace ankh
 {
+    // Model nodes are stored breadth-first (see TransformHierarchy): 'parent' indexes an
+    // earlier node of the same model, or is -1 for roots.
     struct ModelNode
     {
         MeshHandle mesh{INVALID_MESH_HANDLE};
         MaterialHandle material{INVALID_MATERIAL_HANDLE};
-        glm::mat4 local_transform{1.0f};
+        glm::mat4 local_transform{1.0f}; // relative to the parent node
+        int32_t parent{-1};
     };
 
     class Model
@@ -0,0 +1,48 @@
+// src/scene/renderable-store.cpp
+#include "scene/renderable-store.hpp"
+
+namespace ankh
+{
+
+    void RenderableStore::clear()
+    {
+        m_mesh.clear();
+        m_material.clear();
+        m_node.clear();
+        m_base.clear();
+        m_world.clear();
+    }
+
+    void RenderableStore::reserve(uint32_t count)
+    {
+        m_mesh.reserve(count);
+        m_material.reserve(count);
+        m_node.reserve(count);
+        m_base.reserve(count);
+        m_world.reserve(count);
+    }
+
+    uint32_t RenderableStore::add(const Renderable &r)
+    {
+        const uint32_t index = size();
+
+        m_mesh.push_back(r.mesh);
+        m_material.push_back(r.material);
+        m_node.push_back(r.node);
+        m_base.push_back(r.base_transform);
+        m_world.push_back(r.base_transform);
+
+        return index;
+    }
+
+    Renderable RenderableStore::get(uint32_t index) const
+    {
+        Renderable r{};
+        r.mesh = m_mesh[index];
+        r.material = m_material[index];
+        r.node = m_node[index];
+        r.base_transform = m_base[index];
+        return r;
+    }
+
+} // namespace ankh
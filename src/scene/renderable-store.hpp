@@ -0,0 +1,114 @@
+// src/scene/renderable-store.hpp
+#pragma once
+
+#include "scene/renderable.hpp"
+#include "utils/aligned-allocator.hpp"
+#include "utils/types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ankh
+{
+
+    // Structure-of-arrays storage for the scene's renderables.
+    // Handles (read by batching/culling), base transforms (read by the animation update)
+    // and world transforms (written by it, read by culling and the object buffer fill)
+    // live in separate 16-byte aligned arrays, so each per-frame pass streams only the
+    // data it touches. Index i refers to the same object in every array.
+    class RenderableStore
+    {
+      public:
+        uint32_t size() const
+        {
+            return static_cast<uint32_t>(m_mesh.size());
+        }
+
+        bool empty() const
+        {
+            return m_mesh.empty();
+        }
+
+        void clear();
+        void reserve(uint32_t count);
+
+        // Append an object (world transform starts as its base transform); returns its index
+        uint32_t add(const Renderable &r);
+
+        Renderable get(uint32_t index) const;
+
+        MeshHandle mesh(uint32_t index) const
+        {
+            return m_mesh[index];
+        }
+
+        MaterialHandle material(uint32_t index) const
+        {
+            return m_material[index];
+        }
+
+        NodeHandle node(uint32_t index) const
+        {
+            return m_node[index];
+        }
+
+        const glm::mat4 &base_transform(uint32_t index) const
+        {
+            return m_base[index];
+        }
+
+        void set_base_transform(uint32_t index, const glm::mat4 &m)
+        {
+            m_base[index] = m;
+        }
+
+        const glm::mat4 &world_transform(uint32_t index) const
+        {
+            return m_world[index];
+        }
+
+        glm::mat4 &world_transform(uint32_t index)
+        {
+            return m_world[index];
+        }
+
+        // Raw arrays for batch kernels, size() elements each
+        const MeshHandle *meshes() const
+        {
+            return m_mesh.data();
+        }
+
+        const MaterialHandle *materials() const
+        {
+            return m_material.data();
+        }
+
+        const glm::mat4 *base_transforms() const
+        {
+            return m_base.data();
+        }
+
+        glm::mat4 *world_transforms()
+        {
+            return m_world.data();
+        }
+
+        const glm::mat4 *world_transforms() const
+        {
+            return m_world.data();
+        }
+
+      private:
+        // hot: handles
+        AlignedVector<MeshHandle> m_mesh;
+        AlignedVector<MaterialHandle> m_material;
+
+        // cold: hierarchy attachment, read when nodes change
+        std::vector<NodeHandle> m_node;
+
+        // transforms (64 bytes each, one object per cache line)
+        AlignedVector<glm::mat4, 64> m_base;
+        AlignedVector<glm::mat4, 64> m_world;
+    };
+
+} // namespace ankh
@@ -10,16 +10,22 @@ namespace ankh
 
     using MeshHandle = uint32_t;
     using MaterialHandle = uint32_t;
+    using NodeHandle = uint32_t; // TransformHierarchy node
 
     inline constexpr MeshHandle INVALID_MESH_HANDLE = 0;
     inline constexpr MaterialHandle INVALID_MATERIAL_HANDLE = 0;
+    inline constexpr NodeHandle INVALID_NODE_HANDLE = UINT32_MAX;
 
+    // One object as it is added to / read back from a RenderableStore. The world
+    // transform is not part of it: the store derives it every frame.
+    // Objects attached to a hierarchy node take their base transform from the node's world
+    // transform; detached ones (INVALID_NODE_HANDLE) keep the one they were added with.
     struct Renderable
     {
         MeshHandle mesh{INVALID_MESH_HANDLE};
         MaterialHandle material{INVALID_MATERIAL_HANDLE};
+        NodeHandle node{INVALID_NODE_HANDLE};
         glm::mat4 base_transform{1.0f};
-        glm::mat4 transform{1.0f}; // model matrix
     };
 
 } // namespace ankh
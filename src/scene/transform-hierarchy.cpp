@@ -0,0 +1,135 @@
+// src/scene/transform-hierarchy.cpp
+#include "scene/transform-hierarchy.hpp"
+
+#include "utils/logging.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace ankh
+{
+
+    void TransformHierarchy::clear()
+    {
+        m_parent.clear();
+        m_first_child.clear();
+        m_child_count.clear();
+        m_local.clear();
+        m_world.clear();
+        m_dirty.clear();
+        m_dirty_list.clear();
+        m_visit_epoch.clear();
+        m_changed.clear();
+    }
+
+    void TransformHierarchy::reserve(uint32_t count)
+    {
+        m_parent.reserve(count);
+        m_first_child.reserve(count);
+        m_child_count.reserve(count);
+        m_local.reserve(count);
+        m_world.reserve(count);
+        m_dirty.reserve(count);
+        m_visit_epoch.reserve(count);
+    }
+
+    NodeHandle TransformHierarchy::add(NodeHandle parent, const glm::mat4 &local)
+    {
+        const NodeHandle node = size();
+        const NodeHandle previous = empty() ? INVALID_NODE_HANDLE : m_parent.back();
+
+        if (parent == INVALID_NODE_HANDLE)
+        {
+            if (previous != INVALID_NODE_HANDLE)
+            {
+                ANKH_THROW_MSG("TransformHierarchy::add: root added after a child node");
+            }
+        }
+        else if (parent >= node || (previous != INVALID_NODE_HANDLE && parent < previous))
+        {
+            ANKH_THROW_MSG("TransformHierarchy::add: node " + std::to_string(node) +
+                           " breaks breadth-first order (parent " + std::to_string(parent) + ")");
+        }
+
+        m_parent.push_back(parent);
+        m_first_child.push_back(0);
+        m_child_count.push_back(0);
+        m_local.push_back(local);
+        m_world.push_back(local);
+        m_dirty.push_back(1);
+        m_dirty_list.push_back(node);
+        m_visit_epoch.push_back(m_epoch);
+
+        if (parent != INVALID_NODE_HANDLE)
+        {
+            if (m_child_count[parent] == 0)
+            {
+                m_first_child[parent] = node;
+            }
+            ++m_child_count[parent];
+        }
+
+        return node;
+    }
+
+    void TransformHierarchy::set_local_transform(NodeHandle node, const glm::mat4 &local)
+    {
+        m_local[node] = local;
+
+        if (!m_dirty[node])
+        {
+            m_dirty[node] = 1;
+            m_dirty_list.push_back(node);
+        }
+    }
+
+    void TransformHierarchy::update()
+    {
+        m_changed.clear();
+
+        if (m_dirty_list.empty())
+        {
+            return;
+        }
+
+        // Ancestors first: a dirty node inside an already walked subtree is skipped
+        std::sort(m_dirty_list.begin(), m_dirty_list.end());
+        ++m_epoch;
+
+        for (NodeHandle root : m_dirty_list)
+        {
+            m_dirty[root] = 0;
+
+            if (m_visit_epoch[root] == m_epoch)
+            {
+                continue;
+            }
+
+            // Breadth-first walk of the subtree, using m_changed as the queue
+            size_t head = m_changed.size();
+            m_visit_epoch[root] = m_epoch;
+            m_changed.push_back(root);
+
+            while (head < m_changed.size())
+            {
+                const NodeHandle node = m_changed[head++];
+                const NodeHandle parent = m_parent[node];
+
+                m_world[node] = (parent == INVALID_NODE_HANDLE) ? m_local[node]
+                                                                : m_world[parent] * m_local[node];
+
+                const uint32_t first = m_first_child[node];
+                const uint32_t last = first + m_child_count[node];
+
+                for (uint32_t child = first; child < last; ++child)
+                {
+                    m_visit_epoch[child] = m_epoch;
+                    m_changed.push_back(child);
+                }
+            }
+        }
+
+        m_dirty_list.clear();
+    }
+
+} // namespace ankh
@@ -0,0 +1,89 @@
+// src/scene/transform-hierarchy.hpp
+#pragma once
+
+#include "scene/renderable.hpp" // for NodeHandle
+#include "utils/aligned-allocator.hpp"
+#include "utils/types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace ankh
+{
+
+    // Persistent node tree with local/world transforms, stored breadth-first: all roots
+    // first, then nodes grouped by parent in parent order. That makes every node's parent
+    // come before it and every node's children contiguous, so update() can walk only the
+    // subtrees below nodes whose local transform changed (O(changes), not O(nodes)).
+    class TransformHierarchy
+    {
+      public:
+        uint32_t size() const
+        {
+            return static_cast<uint32_t>(m_parent.size());
+        }
+
+        bool empty() const
+        {
+            return m_parent.empty();
+        }
+
+        void clear();
+        void reserve(uint32_t count);
+
+        // Append a node. Breadth-first order is required: 'parent' must be
+        // INVALID_NODE_HANDLE while only roots have been added, otherwise an existing node
+        // no lower than the previous node's parent. Throws on violations.
+        NodeHandle add(NodeHandle parent, const glm::mat4 &local);
+
+        NodeHandle parent(NodeHandle node) const
+        {
+            return m_parent[node];
+        }
+
+        const glm::mat4 &local_transform(NodeHandle node) const
+        {
+            return m_local[node];
+        }
+
+        // Marks the node (and so its subtree) for the next update()
+        void set_local_transform(NodeHandle node, const glm::mat4 &local);
+
+        // Valid for nodes that are not awaiting update()
+        const glm::mat4 &world_transform(NodeHandle node) const
+        {
+            return m_world[node];
+        }
+
+        bool has_pending_changes() const
+        {
+            return !m_dirty_list.empty();
+        }
+
+        // Recompute world transforms below every node changed since the last call.
+        void update();
+
+        // Nodes whose world transform was recomputed by the last update(), parents before
+        // their children
+        const std::vector<NodeHandle> &changed() const
+        {
+            return m_changed;
+        }
+
+      private:
+        std::vector<NodeHandle> m_parent;
+        std::vector<uint32_t> m_first_child;
+        std::vector<uint32_t> m_child_count;
+
+        AlignedVector<glm::mat4, 64> m_local;
+        AlignedVector<glm::mat4, 64> m_world;
+
+        std::vector<uint8_t> m_dirty;         // local changed since the last update()
+        std::vector<NodeHandle> m_dirty_list; // nodes with m_dirty set
+        std::vector<uint32_t> m_visit_epoch;  // update() that last recomputed the node
+        uint32_t m_epoch{0};
+
+        std::vector<NodeHandle> m_changed;
+    };
+
+} // namespace ankh
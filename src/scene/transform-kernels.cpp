@@ -0,0 +1,337 @@
+// src/scene/transform-kernels.cpp
+#include "scene/transform-kernels.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANKH_KERNELS_SSE 1
+#include <immintrin.h>
+#else
+#define ANKH_KERNELS_SSE 0
+#endif
+
+// AVX code is compiled per function, so the rest of the build keeps its baseline ISA
+#if ANKH_KERNELS_SSE && (defined(__GNUC__) || defined(__clang__))
+#define ANKH_KERNELS_AVX 1
+#define ANKH_TARGET_AVX __attribute__((target("avx")))
+#elif ANKH_KERNELS_SSE && defined(__AVX__)
+#define ANKH_KERNELS_AVX 1
+#define ANKH_TARGET_AVX
+#else
+#define ANKH_KERNELS_AVX 0
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace ankh
+{
+
+    static_assert(sizeof(ObjectDataGPU) == 16 * sizeof(float), "write_object_data layout");
+
+    namespace
+    {
+        // Relative tolerance for treating the 3x3 part as rotation * uniform scale
+        constexpr float kUniformScaleEpsilon = 1e-4f;
+
+        constexpr float kSnorm10Max = 511.0f;
+
+        uint32_t pack_snorm10(int32_t x, int32_t y, int32_t z)
+        {
+            return (static_cast<uint32_t>(x) & 0x3FFu) |
+                   ((static_cast<uint32_t>(y) & 0x3FFu) << 10) |
+                   ((static_cast<uint32_t>(z) & 0x3FFu) << 20);
+        }
+
+        // Columns with equal lengths that are mutually orthogonal: the inverse transpose is
+        // the matrix itself up to scale, which the shader removes by normalizing
+        bool is_uniform_scale(float l0, float l1, float l2, float d01, float d02, float d12)
+        {
+            const float tol = kUniformScaleEpsilon * std::max({l0, l1, l2});
+            return std::abs(l0 - l1) <= tol && std::abs(l0 - l2) <= tol &&
+                   std::abs(d01) <= tol && std::abs(d02) <= tol && std::abs(d12) <= tol;
+        }
+
+#if ANKH_KERNELS_AVX
+        bool cpu_has_avx()
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            static const bool has = __builtin_cpu_supports("avx");
+            return has;
+#else
+            return true; // compiled with /arch:AVX
+#endif
+        }
+
+        // Two output columns per 256-bit register: out[j], out[j + 1] for j = 0, 2
+        ANKH_TARGET_AVX void multiply_transforms_avx(const glm::mat4 *lhs,
+                                                     const glm::mat4 &rhs,
+                                                     glm::mat4 *out,
+                                                     uint32_t count)
+        {
+            // rhs coefficients are the same for every object: splat them once
+            __m256 r01[4], r23[4];
+            for (int k = 0; k < 4; ++k)
+            {
+                r01[k] = _mm256_set_m128(_mm_set1_ps(rhs[1][k]), _mm_set1_ps(rhs[0][k]));
+                r23[k] = _mm256_set_m128(_mm_set1_ps(rhs[3][k]), _mm_set1_ps(rhs[2][k]));
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const float *l = &lhs[i][0][0];
+
+                const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(l + 0));
+                const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(l + 4));
+                const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(l + 8));
+                const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(l + 12));
+
+                __m256 o01 = _mm256_mul_ps(c0, r01[0]);
+                o01 = _mm256_add_ps(o01, _mm256_mul_ps(c1, r01[1]));
+                o01 = _mm256_add_ps(o01, _mm256_mul_ps(c2, r01[2]));
+                o01 = _mm256_add_ps(o01, _mm256_mul_ps(c3, r01[3]));
+
+                __m256 o23 = _mm256_mul_ps(c0, r23[0]);
+                o23 = _mm256_add_ps(o23, _mm256_mul_ps(c1, r23[1]));
+                o23 = _mm256_add_ps(o23, _mm256_mul_ps(c2, r23[2]));
+                o23 = _mm256_add_ps(o23, _mm256_mul_ps(c3, r23[3]));
+
+                float *o = &out[i][0][0];
+                _mm256_storeu_ps(o + 0, o01);
+                _mm256_storeu_ps(o + 8, o23);
+            }
+        }
+#endif
+
+#if ANKH_KERNELS_SSE
+        // a x b in the xyz lanes; w is a.w * b.w - a.w * b.w = 0
+        inline __m128 cross3(__m128 a, __m128 b)
+        {
+            const __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+            return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        inline float dot3(__m128 a, __m128 b)
+        {
+            const __m128 p = _mm_mul_ps(a, b);
+            return _mm_cvtss_f32(p) + _mm_cvtss_f32(_mm_shuffle_ps(p, p, 1)) +
+                   _mm_cvtss_f32(_mm_shuffle_ps(p, p, 2));
+        }
+
+        void multiply_transforms_sse(const glm::mat4 *lhs,
+                                     const glm::mat4 &rhs,
+                                     glm::mat4 *out,
+                                     uint32_t count)
+        {
+            __m128 r[4][4];
+            for (int j = 0; j < 4; ++j)
+            {
+                for (int k = 0; k < 4; ++k)
+                {
+                    r[j][k] = _mm_set1_ps(rhs[j][k]);
+                }
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const float *l = &lhs[i][0][0];
+
+                const __m128 c0 = _mm_loadu_ps(l + 0);
+                const __m128 c1 = _mm_loadu_ps(l + 4);
+                const __m128 c2 = _mm_loadu_ps(l + 8);
+                const __m128 c3 = _mm_loadu_ps(l + 12);
+
+                float *o = &out[i][0][0];
+                for (int j = 0; j < 4; ++j)
+                {
+                    __m128 col = _mm_mul_ps(c0, r[j][0]);
+                    col = _mm_add_ps(col, _mm_mul_ps(c1, r[j][1]));
+                    col = _mm_add_ps(col, _mm_mul_ps(c2, r[j][2]));
+                    col = _mm_add_ps(col, _mm_mul_ps(c3, r[j][3]));
+                    _mm_storeu_ps(o + 4 * j, col);
+                }
+            }
+        }
+#endif
+    } // namespace
+
+    void multiply_transforms(const glm::mat4 *lhs,
+                             const glm::mat4 &rhs,
+                             glm::mat4 *out,
+                             uint32_t count)
+    {
+#if ANKH_KERNELS_AVX
+        if (cpu_has_avx())
+        {
+            multiply_transforms_avx(lhs, rhs, out, count);
+            return;
+        }
+#endif
+
+#if ANKH_KERNELS_SSE
+        multiply_transforms_sse(lhs, rhs, out, count);
+#else
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            out[i] = lhs[i] * rhs;
+        }
+#endif
+    }
+
+    void write_object_data(const glm::mat4 *world,
+                           const MaterialHandle *materials,
+                           uint32_t material_count,
+                           const uint32_t *index,
+                           uint32_t count,
+                           ObjectDataGPU *dst)
+    {
+#if ANKH_KERNELS_SSE
+        const bool stream = (reinterpret_cast<std::uintptr_t>(dst) & 15u) == 0;
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t src = index[i];
+            const MaterialHandle m = materials[src];
+
+            const float *s = &world[src][0][0];
+            float *d = reinterpret_cast<float *>(dst + i);
+
+            __m128 r0 = _mm_loadu_ps(s + 0);
+            __m128 r1 = _mm_loadu_ps(s + 4);
+            __m128 r2 = _mm_loadu_ps(s + 8);
+            __m128 r3 = _mm_loadu_ps(s + 12);
+
+            // Columns of the 3x3 part (before the transpose below turns them into rows)
+            const __m128 c0 = r0;
+            const __m128 c1 = r1;
+            const __m128 c2 = r2;
+
+            uint32_t tail = m < material_count ? m : 0u;
+            int32_t n[3] = {0, 0, 0};
+
+            if (is_uniform_scale(dot3(c0, c0),
+                                 dot3(c1, c1),
+                                 dot3(c2, c2),
+                                 dot3(c0, c1),
+                                 dot3(c0, c2),
+                                 dot3(c1, c2)))
+            {
+                tail |= OBJECT_UNIFORM_SCALE_BIT;
+            }
+            else
+            {
+                // Cofactor columns: det * inverse transpose
+                const __m128 n0 = cross3(c1, c2);
+                const __m128 n1 = cross3(c2, c0);
+                const __m128 n2 = cross3(c0, c1);
+                const float det = dot3(c0, n0);
+
+                const __m128 a = _mm_max_ps(_mm_and_ps(n0, absMask),
+                                            _mm_max_ps(_mm_and_ps(n1, absMask),
+                                                       _mm_and_ps(n2, absMask)));
+                const float largest = std::max({_mm_cvtss_f32(a),
+                                                _mm_cvtss_f32(_mm_shuffle_ps(a, a, 1)),
+                                                _mm_cvtss_f32(_mm_shuffle_ps(a, a, 2))});
+
+                if (largest > 0.0f)
+                {
+                    // Keep the sign of det so mirrored objects don't flip their normals
+                    const __m128 k = _mm_set1_ps((det < 0.0f ? -kSnorm10Max : kSnorm10Max) /
+                                                 largest);
+
+                    alignas(16) int32_t q[3][4];
+                    _mm_store_si128(reinterpret_cast<__m128i *>(q[0]),
+                                    _mm_cvtps_epi32(_mm_mul_ps(n0, k)));
+                    _mm_store_si128(reinterpret_cast<__m128i *>(q[1]),
+                                    _mm_cvtps_epi32(_mm_mul_ps(n1, k)));
+                    _mm_store_si128(reinterpret_cast<__m128i *>(q[2]),
+                                    _mm_cvtps_epi32(_mm_mul_ps(n2, k)));
+
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        n[c] = static_cast<int32_t>(pack_snorm10(q[c][0], q[c][1], q[c][2]));
+                    }
+                }
+            }
+
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            const __m128 v3 = _mm_castsi128_ps(
+                _mm_set_epi32(static_cast<int32_t>(tail), n[2], n[1], n[0]));
+
+            if (stream)
+            {
+                _mm_stream_ps(d + 0, r0);
+                _mm_stream_ps(d + 4, r1);
+                _mm_stream_ps(d + 8, r2);
+                _mm_stream_ps(d + 12, v3);
+            }
+            else
+            {
+                _mm_storeu_ps(d + 0, r0);
+                _mm_storeu_ps(d + 4, r1);
+                _mm_storeu_ps(d + 8, r2);
+                _mm_storeu_ps(d + 12, v3);
+            }
+        }
+
+        if (stream)
+        {
+            _mm_sfence(); // order the streamed records before the submit that reads them
+        }
+#else
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t src = index[i];
+            const MaterialHandle m = materials[src];
+            const glm::mat4 &w = world[src];
+
+            ObjectDataGPU &o = dst[i];
+            for (int r = 0; r < 3; ++r)
+            {
+                o.modelRows[r] = glm::vec4(w[0][r], w[1][r], w[2][r], w[3][r]);
+            }
+
+            const glm::vec3 c0{w[0]};
+            const glm::vec3 c1{w[1]};
+            const glm::vec3 c2{w[2]};
+
+            o.material = m < material_count ? m : 0u;
+            o.normal[0] = o.normal[1] = o.normal[2] = 0;
+
+            if (is_uniform_scale(glm::dot(c0, c0),
+                                 glm::dot(c1, c1),
+                                 glm::dot(c2, c2),
+                                 glm::dot(c0, c1),
+                                 glm::dot(c0, c2),
+                                 glm::dot(c1, c2)))
+            {
+                o.material |= OBJECT_UNIFORM_SCALE_BIT;
+                continue;
+            }
+
+            const glm::vec3 n[3] = {glm::cross(c1, c2), glm::cross(c2, c0), glm::cross(c0, c1)};
+            const float det = glm::dot(c0, n[0]);
+
+            float largest = 0.0f;
+            for (const glm::vec3 &c : n)
+            {
+                largest = std::max({largest, std::abs(c.x), std::abs(c.y), std::abs(c.z)});
+            }
+
+            if (largest > 0.0f)
+            {
+                const float k = (det < 0.0f ? -kSnorm10Max : kSnorm10Max) / largest;
+                for (int c = 0; c < 3; ++c)
+                {
+                    const glm::ivec3 q{glm::round(n[c] * k)};
+                    o.normal[c] = pack_snorm10(q.x, q.y, q.z);
+                }
+            }
+        }
+#endif
+    }
+
+} // namespace ankh
@@ -0,0 +1,35 @@
+// src/scene/transform-kernels.hpp
+#pragma once
+
+#include "scene/renderable.hpp"
+#include "utils/types.hpp"
+
+#include <cstdint>
+
+namespace ankh
+{
+
+    // Batch kernels over RenderableStore arrays. x86 builds use SSE, with an AVX path
+    // selected at runtime on CPUs that support it; other targets fall back to glm.
+    // Callers split large ranges across jobs themselves.
+
+    // out[i] = lhs[i] * rhs for i in [0, count). 'out' may alias 'lhs'.
+    void multiply_transforms(const glm::mat4 *lhs,
+                             const glm::mat4 &rhs,
+                             glm::mat4 *out,
+                             uint32_t count);
+
+    // Fill dst[0..count) straight from SoA arrays for objects index[0..count): the rows of
+    // world[index[i]]'s affine part, its normal matrix (inverse transpose of the 3x3 part,
+    // or OBJECT_UNIFORM_SCALE_BIT when that is the 3x3 part itself) and the material
+    // index (0 for handles >= material_count). 'dst' is usually mapped, write-combined
+    // memory, so every record is written once, front to back, with non-temporal stores
+    // when it is 16-byte aligned.
+    void write_object_data(const glm::mat4 *world,
+                           const MaterialHandle *materials,
+                           uint32_t material_count,
+                           const uint32_t *index,
+                           uint32_t count,
+                           ObjectDataGPU *dst);
+
+} // namespace ankh
@@ -0,0 +1,84 @@
+// src/swapchain/offscreen-targets.cpp
+
+#include "swapchain/offscreen-targets.hpp"
+
+#include "memory/image.hpp"
+#include "utils/logging.hpp"
+
+namespace ankh
+{
+
+    OffscreenTargets::OffscreenTargets(VkDevice device,
+                                       VmaAllocator allocator,
+                                       VkExtent2D extent,
+                                       VkFormat color_format,
+                                       uint32_t image_count,
+                                       GpuResourceTracker *tracker)
+        : m_device{device}
+        , m_extent{extent}
+        , m_color_format{color_format}
+        , m_tracker{tracker}
+    {
+        ANKH_ASSERT(image_count > 0);
+        ANKH_ASSERT(extent.width > 0 && extent.height > 0);
+
+        m_color_images.reserve(image_count);
+
+        for (uint32_t i = 0; i < image_count; ++i)
+        {
+            m_color_images.push_back(
+                std::make_unique<Image>(allocator,
+                                        m_device,
+                                        m_extent.width,
+                                        m_extent.height,
+                                        m_color_format,
+                                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                            VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                        VMA_MEMORY_USAGE_GPU_ONLY,
+                                        VK_IMAGE_ASPECT_COLOR_BIT));
+        }
+
+        m_depth_image = std::make_unique<Image>(allocator,
+                                                m_device,
+                                                m_extent.width,
+                                                m_extent.height,
+                                                m_depth_format,
+                                                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                                                VMA_MEMORY_USAGE_GPU_ONLY,
+                                                VK_IMAGE_ASPECT_DEPTH_BIT);
+
+        ANKH_LOG_DEBUG("[OffscreenTargets] Created " + std::to_string(image_count) + " " +
+                       std::to_string(m_extent.width) + "x" + std::to_string(m_extent.height) +
+                       " color targets");
+    }
+
+    OffscreenTargets::~OffscreenTargets()
+    {
+        // Framebuffers reference the image views, so they go first
+        m_framebuffers.clear();
+        m_depth_image.reset();
+        m_color_images.clear();
+    }
+
+    VkImage OffscreenTargets::color_image(uint32_t index) const
+    {
+        return m_color_images.at(index)->image();
+    }
+
+    void OffscreenTargets::create_framebuffers(VkRenderPass renderPass)
+    {
+        m_framebuffers.clear();
+        m_framebuffers.reserve(m_color_images.size());
+
+        for (const auto &color : m_color_images)
+        {
+            std::vector<VkImageView> attachments = {
+                color->view(),        // color
+                m_depth_image->view() // depth
+            };
+
+            m_framebuffers.emplace_back(m_device, renderPass, attachments, m_extent, m_tracker);
+        }
+    }
+
+} // namespace ankh
@@ -0,0 +1,78 @@
+// src/swapchain/offscreen-targets.hpp
+#pragma once
+
+#include "renderpass/frame-buffer.hpp"
+#include "utils/types.hpp"
+#include <vk_mem_alloc.h>
+
+#include <memory>
+#include <vector>
+
+namespace ankh
+{
+
+    class Image;
+    class GpuResourceTracker;
+
+    // Swapchain stand-in for headless rendering: a fixed ring of color images plus a
+    // shared depth image, rendered into directly with no surface, acquire or present.
+    // Color images end each frame in TRANSFER_SRC layout so they can be read back.
+    class OffscreenTargets
+    {
+      public:
+        OffscreenTargets(VkDevice device,
+                         VmaAllocator allocator,
+                         VkExtent2D extent,
+                         VkFormat color_format,
+                         uint32_t image_count,
+                         GpuResourceTracker *tracker = nullptr);
+
+        ~OffscreenTargets();
+
+        OffscreenTargets(const OffscreenTargets &) = delete;
+        OffscreenTargets &operator=(const OffscreenTargets &) = delete;
+
+        VkFormat image_format() const
+        {
+            return m_color_format;
+        }
+
+        VkExtent2D extent() const
+        {
+            return m_extent;
+        }
+
+        VkFormat depth_format() const
+        {
+            return m_depth_format;
+        }
+
+        uint32_t image_count() const
+        {
+            return static_cast<uint32_t>(m_color_images.size());
+        }
+
+        VkImage color_image(uint32_t index) const;
+
+        // Called after render pass exists / changes
+        void create_framebuffers(VkRenderPass renderPass);
+
+        const Framebuffer &framebuffer(uint32_t index) const
+        {
+            return m_framebuffers.at(index);
+        }
+
+      private:
+        VkDevice m_device{VK_NULL_HANDLE};
+        VkExtent2D m_extent{};
+        VkFormat m_color_format{VK_FORMAT_UNDEFINED};
+        VkFormat m_depth_format{VK_FORMAT_D32_SFLOAT}; // must match RenderPass depth attachment
+
+        std::vector<std::unique_ptr<Image>> m_color_images;
+        std::unique_ptr<Image> m_depth_image;
+        std::vector<Framebuffer> m_framebuffers;
+
+        GpuResourceTracker *m_tracker{nullptr};
+    };
+
+} // namespace ankh
@@ -0,0 +1,54 @@
+// src/utils/aligned-allocator.hpp
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace ankh
+{
+
+    // std::allocator replacement that over-aligns every allocation to 'Align' bytes, so
+    // SIMD kernels can use aligned loads/stores on the data of an AlignedVector.
+    template <typename T, std::size_t Align>
+    struct AlignedAllocator
+    {
+        static_assert(Align >= alignof(T), "alignment weaker than the element type's");
+        static_assert((Align & (Align - 1)) == 0, "alignment must be a power of two");
+
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, Align>;
+        };
+
+        AlignedAllocator() noexcept = default;
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Align> &) noexcept
+        {
+        }
+
+        T *allocate(std::size_t n)
+        {
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{Align}));
+        }
+
+        void deallocate(T *p, std::size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t{Align});
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Align> &) const noexcept
+        {
+            return true;
+        }
+    };
+
+    template <typename T, std::size_t Align = 16>
+    using AlignedVector = std::vector<T, AlignedAllocator<T, Align>>;
+
+} // namespace ankh
@@ -1,20 +1,106 @@
 // src/utils/config.cpp
 #include "utils/config.hpp"
-#include "utils/logging.hpp"
 
 namespace ankh
 {
     Config &config()
     {
         static Config cfg{};
+        return cfg;
+    }
 
-#ifndef NDEBUG
-        log::SetLevel(log::Level::Debug);
-#else
-        log::SetLevel(log::Level::Warn);
-#endif
+    bool apply_config_arg(std::string_view arg)
+    {
+        Config &cfg = config();
 
-        return cfg;
+        // Value of '--key=value' when 'arg' starts with 'key'
+        std::string value;
+        const auto has_value = [&](std::string_view key)
+        {
+            if (!arg.starts_with(key))
+            {
+                return false;
+            }
+            value = std::string{arg.substr(key.size())};
+            return true;
+        };
+
+        const auto as_u32 = [&value]() { return static_cast<uint32_t>(std::stoul(value)); };
+
+        if (has_value("--model="))
+        {
+            cfg.modelPath = value;
+        }
+        else if (arg == "--validation")
+        {
+            cfg.validation = true;
+        }
+        else if (arg == "--no-indirect")
+        {
+            cfg.indirectDraw = false;
+        }
+        else if (arg == "--no-gpu-cull")
+        {
+            cfg.gpuCulling = false;
+        }
+        else if (arg == "--no-cpu-cull")
+        {
+            cfg.cpuCulling = false;
+        }
+        else if (arg == "--no-animate")
+        {
+            cfg.animate = false;
+        }
+        else if (arg == "--no-vertex-compression")
+        {
+            cfg.compactVertices = false;
+        }
+        else if (arg == "--no-mesh-opt")
+        {
+            cfg.optimizeMeshes = false;
+        }
+        else if (arg == "--no-meshlets")
+        {
+            cfg.meshlets = false;
+        }
+        else if (has_value("--max-cluster-draws="))
+        {
+            cfg.maxClusterDraws = as_u32();
+        }
+        else if (has_value("--lod-levels="))
+        {
+            cfg.lodLevels = as_u32();
+        }
+        else if (has_value("--lod-error="))
+        {
+            cfg.lodPixelError = std::stof(value);
+        }
+        else if (has_value("--job-threads="))
+        {
+            cfg.jobThreads = as_u32();
+        }
+        else if (has_value("--record-threads="))
+        {
+            cfg.recordThreads = as_u32();
+        }
+        else if (has_value("--parallel-record-min-draws="))
+        {
+            cfg.parallelRecordMinDraws = as_u32();
+        }
+        else if (has_value("--gpu-profile="))
+        {
+            cfg.gpuProfileInterval = as_u32();
+        }
+        else if (has_value("--gpu-profile-json="))
+        {
+            cfg.gpuProfileJsonPath = value;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
     }
 
 } // namespace ankh
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
+#include <string_view>
 
 namespace ankh
 {
@@ -14,10 +16,31 @@ namespace ankh
 #endif
 
         bool vsync = true;      // use FIFO (vsync) vs MAILBOX/IMMEDIATE
+        bool headless = false;  // render into offscreen images; no window, surface or present
+        uint32_t headlessFrames = 0; // frames to render in headless mode before exiting (0 = forever)
         int framesInFlight = 2; // number of frame contexts
         std::uint32_t maxObjects = 4096;
+        bool indirectDraw = true; // one multi-draw-indirect call for the scene (if supported)
+        bool gpuCulling = true;   // compute frustum culling feeding the indirect draw
+        bool cpuCulling = true;   // SceneRenderer frustum culling before object upload and draws
+        bool animate = true;      // demo spin on every object; off = only hierarchy edits move things
+        bool compactVertices = true; // per-mesh packed vertex formats (see VertexFormat)
+        bool optimizeMeshes = true; // reorder imported meshes for vertex cache/overdraw/fetch
+        uint32_t lodLevels = 3;     // simplified levels generated per mesh at load (0 = off)
+        float lodPixelError = 1.0f; // coarsest LOD whose projected error stays under this (px)
+        bool meshlets = true;       // split large meshes into clusters for GPU cluster culling
+        uint32_t maxClusterDraws = 32768; // GPU cull commands per frame beyond one per object
+        uint32_t jobThreads = 0;    // JobSystem threads including the main one (0 = all cores)
+        uint32_t recordThreads = 0; // direct-draw recording slices (0 = auto, 1 = inline only)
+        uint32_t parallelRecordMinDraws = 2048; // draw batches; below this, record inline
         uint32_t Width = 800;
         uint32_t Height = 600;
+        // .gltf/.glb, or a package cooked by ankh_cook (.ankhpkg, mapped instead of imported)
+        std::string modelPath = "D:\\Rep\\Ankh\\assets\\models\\cerberus\\cerberus.gltf";
+
+        uint32_t gpuProfileInterval = 0; // frames between GPU pass timing reports (0 = off)
+        std::string gpuProfileJsonPath;  // rewritten with the latest report when not empty
+
         const uint32_t uploadContexts = 2; // number of async upload contexts
         
         // 16ms in nanoseconds:
@@ -26,4 +49,12 @@ namespace ankh
 
     Config &config();
 
+    // Apply one command line flag shared by Ankh, ankh_bench and ankh_cook to config():
+    //   --model=PATH --validation --no-indirect --no-gpu-cull --no-cpu-cull --no-animate
+    //   --no-vertex-compression --no-mesh-opt --no-meshlets --max-cluster-draws=N
+    //   --lod-levels=N --lod-error=PX --job-threads=N --record-threads=N
+    //   --parallel-record-min-draws=N --gpu-profile=FRAMES --gpu-profile-json=PATH
+    // Returns false if 'arg' is not one of them. Throws on a malformed number.
+    bool apply_config_arg(std::string_view arg);
+
 } // namespace ankh
@@ -2,6 +2,19 @@
 #include "logging.hpp"
 #include <fstream>
 #include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace ankh
 {
@@ -24,4 +37,149 @@ namespace ankh
         return data;
     }
 
+#ifdef _WIN32
+
+    MappedFile::MappedFile(const std::string &path)
+    {
+        HANDLE file = CreateFileA(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                  nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            ANKH_THROW_MSG("Failed to open file: " + path);
+        }
+        m_file = file;
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size))
+        {
+            close();
+            ANKH_THROW_MSG("Failed to stat file: " + path);
+        }
+
+        m_size = static_cast<std::size_t>(size.QuadPart);
+        if (m_size == 0)
+        {
+            return; // empty files can't be mapped
+        }
+
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void *view =
+            m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view)
+        {
+            close();
+            ANKH_THROW_MSG("Failed to map file: " + path);
+        }
+
+        m_data = static_cast<const uint8_t *>(view);
+    }
+
+    void MappedFile::close() noexcept
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+        if (m_file)
+        {
+            CloseHandle(m_file);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_mapping = nullptr;
+        m_file = nullptr;
+    }
+
+#else
+
+    MappedFile::MappedFile(const std::string &path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            ANKH_THROW_MSG("Failed to open file: " + path);
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            ANKH_THROW_MSG("Failed to stat file: " + path);
+        }
+
+        m_size = static_cast<std::size_t>(info.st_size);
+        if (m_size == 0)
+        {
+            ::close(fd);
+            return; // empty files can't be mapped
+        }
+
+        void *view = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps the file referenced
+
+        if (view == MAP_FAILED)
+        {
+            m_size = 0;
+            ANKH_THROW_MSG("Failed to map file: " + path);
+        }
+
+        // Start reading the whole file in now rather than one faulting page at a time
+        ::madvise(view, m_size, MADV_WILLNEED);
+
+        m_data = static_cast<const uint8_t *>(view);
+    }
+
+    void MappedFile::close() noexcept
+    {
+        if (m_data)
+        {
+            ::munmap(const_cast<uint8_t *>(m_data), m_size);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+#endif
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+#ifdef _WIN32
+        , m_file(std::exchange(other.m_file, nullptr))
+        , m_mapping(std::exchange(other.m_mapping, nullptr))
+#endif
+    {
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+            m_file = std::exchange(other.m_file, nullptr);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
 } // namespace ankh
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -7,4 +9,43 @@ namespace ankh
 
     std::vector<char> read_binary(const std::string &path);
 
+    // Read-only memory mapping of a whole file. Pages are read in on first touch (the
+    // kernel is asked to start reading ahead right away), so callers can hand ranges of
+    // data() straight to memcpy/upload code without staging the file in a vector.
+    class MappedFile
+    {
+      public:
+        MappedFile() = default;
+
+        // Throws if the file can't be opened or mapped
+        explicit MappedFile(const std::string &path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        const uint8_t *data() const noexcept
+        {
+            return m_data;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+      private:
+        void close() noexcept;
+
+        const uint8_t *m_data{nullptr};
+        std::size_t m_size{0};
+#ifdef _WIN32
+        void *m_file{nullptr};
+        void *m_mapping{nullptr};
+#endif
+    };
+
 } // namespace ankh
@@ -1,6 +1,7 @@
 // src/utils/logging.cpp
 #include "utils/logging.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
@@ -11,7 +12,14 @@ namespace ankh::log
 {
     namespace
     {
-        Level g_level = Level::Debug;
+#ifndef NDEBUG
+        constexpr Level kDefaultLevel = Level::Debug;
+#else
+        constexpr Level kDefaultLevel = Level::Warn;
+#endif
+
+        // Read by every log call, from any thread
+        std::atomic<Level> g_level{kDefaultLevel};
         std::mutex g_log_mutex;
 
         std::string current_time_string()
@@ -75,8 +83,12 @@ namespace ankh::log
         write_log(Level::Debug, msg, false);
     }
 
-    // For now this is just a hook for future routing (file, platform logger, etc.).
-    void init() {}
+    // Resets the level to the build's default. Otherwise just a hook for future routing
+    // (file, platform logger, etc.).
+    void init()
+    {
+        g_level = kDefaultLevel;
+    }
 
     void info(const std::string &msg)
     {
@@ -17,7 +17,8 @@ namespace ankh
             None
         };
 
-        // Initialize logging backend (currently no-op, but hook point for future)
+        // Initialize logging backend: sets the build's default level (Debug, Warn with
+        // NDEBUG), which only SetLevel changes afterwards
         void init();
         void SetLevel(Level level);
         void info(const std::string &msg);
@@ -53,12 +53,37 @@ namespace ankh
         alignas(16) glm::mat4 proj;
         alignas(16) glm::vec4 globalAlbedo;
         alignas(16) glm::vec4 lightDir;
+        alignas(16) glm::vec4 frustumPlanes[6]; // xyz = inward normal, w = distance
     };
 
+    // Normal matrix == the model matrix's 3x3 part (up to scale): ObjectDataGPU::normal unused
+    inline constexpr uint32_t OBJECT_UNIFORM_SCALE_BIT = 1u << 31;
+
+    // Per-object record of the ObjectBuffer (64 bytes, shaders/vert.vert and cull.comp)
     struct ObjectDataGPU
     {
-        alignas(16) glm::mat4 model;
+        alignas(16) glm::vec4 modelRows[3]; // affine world matrix, rows (last row is 0,0,0,1)
+        uint32_t normal[3];                 // normal matrix columns, snorm 10:10:10, unscaled
+        uint32_t material;                  // MaterialGPU index | OBJECT_UNIFORM_SCALE_BIT
+    };
+    static_assert(sizeof(ObjectDataGPU) == 64);
+
+    // Per-material record of the ObjectBuffer's material table, indexed by MaterialHandle
+    struct MaterialGPU
+    {
         alignas(16) glm::vec4 albedo;
     };
 
+    // Input of the GPU culling pass (shaders/cull.comp), one per object or meshlet cluster
+    struct CullObjectGPU
+    {
+        alignas(16) glm::vec4 sphere; // mesh-local bounding sphere: xyz center, w radius
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t objectIndex;
+        glm::vec4 cone; // mesh-local normal cone: xyz axis, w cutoff (1 = no backface test)
+    };
+    static_assert(sizeof(CullObjectGPU) == 48);
+
 } // namespace ankh
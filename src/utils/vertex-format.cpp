@@ -0,0 +1,189 @@
+// src/utils/vertex-format.cpp
+#include "utils/vertex-format.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <glm/gtc/packing.hpp>
+
+namespace ankh
+{
+    namespace
+    {
+        // Half positions may round by this fraction of the mesh's largest extent
+        constexpr float kHalfPositionTolerance = 1.0f / 2048.0f;
+        constexpr float kHalfMax = 65504.0f;
+
+        // Octahedral mapping of a unit vector to [-1, 1]^2 (decoded in vert.vert)
+        uint32_t encode_octahedral(const glm::vec3 &n)
+        {
+            const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            if (l1 <= 0.0f)
+            {
+                return glm::packSnorm2x16(glm::vec2(0.0f)); // decodes to +Z
+            }
+
+            glm::vec2 e = glm::vec2(n.x, n.y) / l1;
+            if (n.z < 0.0f)
+            {
+                const glm::vec2 s(e.x >= 0.0f ? 1.0f : -1.0f, e.y >= 0.0f ? 1.0f : -1.0f);
+                e = (1.0f - glm::abs(glm::vec2(e.y, e.x))) * s;
+            }
+
+            return glm::packSnorm2x16(e);
+        }
+
+        // False for NaN too
+        template <glm::length_t N>
+        bool in_unit_range(const glm::vec<N, float> &v)
+        {
+            return glm::all(glm::greaterThanEqual(v, glm::vec<N, float>(0.0f))) &&
+                   glm::all(glm::lessThanEqual(v, glm::vec<N, float>(1.0f)));
+        }
+
+        template <typename Packed>
+        void encode_attributes(const Vertex &v, Packed &out)
+        {
+            out.normal = encode_octahedral(v.normal);
+            out.uv = glm::packUnorm2x16(v.uv);
+            out.color = glm::packUnorm4x8(glm::vec4(v.color, 1.0f));
+        }
+
+        VkVertexInputAttributeDescription attribute(uint32_t location,
+                                                    VkFormat format,
+                                                    uint32_t offset)
+        {
+            VkVertexInputAttributeDescription a{};
+            a.binding = 0;
+            a.location = location;
+            a.format = format;
+            a.offset = offset;
+            return a;
+        }
+    } // namespace
+
+    uint32_t vertex_stride(VertexFormat format)
+    {
+        switch (format)
+        {
+        case VertexFormat::Packed:
+            return sizeof(PackedVertex);
+        case VertexFormat::PackedHalf:
+            return sizeof(PackedHalfVertex);
+        case VertexFormat::Float:
+        default:
+            return sizeof(Vertex);
+        }
+    }
+
+    VertexInputLayout vertex_input_layout(VertexFormat format)
+    {
+        VertexInputLayout layout{};
+        layout.binding.binding = 0;
+        layout.binding.stride = vertex_stride(format);
+        layout.binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        switch (format)
+        {
+        case VertexFormat::Packed:
+            layout.attributes = {
+                attribute(0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(PackedVertex, pos)),
+                attribute(1, VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex, normal)),
+                attribute(2, VK_FORMAT_R8G8B8A8_UNORM, offsetof(PackedVertex, color)),
+                attribute(3, VK_FORMAT_R16G16_UNORM, offsetof(PackedVertex, uv)),
+            };
+            break;
+        case VertexFormat::PackedHalf:
+            layout.attributes = {
+                attribute(0, VK_FORMAT_R16G16B16A16_SFLOAT, offsetof(PackedHalfVertex, pos)),
+                attribute(1, VK_FORMAT_R16G16_SNORM, offsetof(PackedHalfVertex, normal)),
+                attribute(2, VK_FORMAT_R8G8B8A8_UNORM, offsetof(PackedHalfVertex, color)),
+                attribute(3, VK_FORMAT_R16G16_UNORM, offsetof(PackedHalfVertex, uv)),
+            };
+            break;
+        case VertexFormat::Float:
+        default:
+            layout.binding = Vertex::getBindingDescription();
+            layout.attributes = Vertex::getAttributeDescriptions();
+            break;
+        }
+
+        return layout;
+    }
+
+    VertexFormat select_vertex_format(const std::vector<Vertex> &vertices)
+    {
+        if (vertices.empty())
+        {
+            return VertexFormat::Float;
+        }
+
+        glm::vec3 min(vertices[0].pos);
+        glm::vec3 max(vertices[0].pos);
+
+        for (const Vertex &v : vertices)
+        {
+            // unorm16 UVs cannot tile, and unorm8 colors would clamp anything outside [0, 1]
+            if (!in_unit_range(v.uv) || !in_unit_range(v.color))
+            {
+                return VertexFormat::Float;
+            }
+
+            min = glm::min(min, v.pos);
+            max = glm::max(max, v.pos);
+        }
+
+        const glm::vec3 extent = max - min;
+        const float tolerance =
+            kHalfPositionTolerance * std::max({extent.x, extent.y, extent.z});
+
+        for (const Vertex &v : vertices)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                const float x = v.pos[k];
+                if (std::abs(x) > kHalfMax ||
+                    std::abs(glm::unpackHalf1x16(glm::packHalf1x16(x)) - x) > tolerance)
+                {
+                    return VertexFormat::Packed;
+                }
+            }
+        }
+
+        return VertexFormat::PackedHalf;
+    }
+
+    void encode_vertices(VertexFormat format, const Vertex *src, std::size_t count, void *dst)
+    {
+        switch (format)
+        {
+        case VertexFormat::Packed:
+        {
+            auto *out = static_cast<PackedVertex *>(dst);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                out[i].pos = src[i].pos;
+                encode_attributes(src[i], out[i]);
+            }
+            break;
+        }
+        case VertexFormat::PackedHalf:
+        {
+            auto *out = static_cast<PackedHalfVertex *>(dst);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const glm::uint64 pos = glm::packHalf4x16(glm::vec4(src[i].pos, 1.0f));
+                std::memcpy(out[i].pos, &pos, sizeof(out[i].pos));
+                encode_attributes(src[i], out[i]);
+            }
+            break;
+        }
+        case VertexFormat::Float:
+        default:
+            std::memcpy(dst, src, sizeof(Vertex) * count);
+            break;
+        }
+    }
+
+} // namespace ankh
@@ -0,0 +1,88 @@
+// src/utils/vertex-format.hpp
+#pragma once
+
+#include "utils/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ankh
+{
+    // GPU vertex encodings. Each mesh is stored in one of them (picked at import, see
+    // select_vertex_format) and drawn with the matching GraphicsPipeline variant.
+    enum class VertexFormat : uint8_t
+    {
+        Float = 0,      // Vertex as is, 44 bytes
+        Packed = 1,     // PackedVertex, 24 bytes
+        PackedHalf = 2, // PackedHalfVertex, 20 bytes
+    };
+
+    inline constexpr uint32_t VERTEX_FORMAT_COUNT = 3;
+
+    // Float position, octahedral normal (snorm16 x2), uv (unorm16 x2), color (unorm8 x4)
+    struct PackedVertex
+    {
+        glm::vec3 pos;
+        uint32_t normal;
+        uint32_t uv;
+        uint32_t color;
+    };
+    static_assert(sizeof(PackedVertex) == 24);
+
+    // PackedVertex with a half-float position (w = 1)
+    struct PackedHalfVertex
+    {
+        uint16_t pos[4];
+        uint32_t normal;
+        uint32_t uv;
+        uint32_t color;
+    };
+    static_assert(sizeof(PackedHalfVertex) == 20);
+
+    struct VertexInputLayout
+    {
+        VkVertexInputBindingDescription binding{};
+        std::array<VkVertexInputAttributeDescription, 4> attributes{};
+    };
+
+    uint32_t vertex_stride(VertexFormat format);
+
+    // Binding 0, locations 0-3 (position, normal, color, uv) as read by shaders/vert.vert
+    VertexInputLayout vertex_input_layout(VertexFormat format);
+
+    // Most compact format that represents 'vertices' faithfully: packed needs UVs and colors
+    // inside [0, 1] (colors outside it, e.g. HDR float COLOR_0, keep Float); half
+    // positions must round by less than 1/2048 of the mesh's largest extent
+    VertexFormat select_vertex_format(const std::vector<Vertex> &vertices);
+
+    // Write 'count' vertices to 'dst' (vertex_stride(format) * count bytes)
+    void encode_vertices(VertexFormat format, const Vertex *src, std::size_t count, void *dst);
+
+    // GPU index width. Meshes keep 32-bit indices on the CPU and are stored with the
+    // narrowest width that addresses all of their vertices (select_index_width).
+    enum class IndexWidth : uint8_t
+    {
+        U16 = 0,
+        U32 = 1,
+    };
+
+    inline constexpr uint32_t INDEX_WIDTH_COUNT = 2;
+
+    inline uint32_t index_size(IndexWidth width)
+    {
+        return width == IndexWidth::U16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    }
+
+    inline VkIndexType vk_index_type(IndexWidth width)
+    {
+        return width == IndexWidth::U16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    }
+
+    inline IndexWidth select_index_width(std::size_t vertex_count)
+    {
+        return vertex_count <= 65536 ? IndexWidth::U16 : IndexWidth::U32;
+    }
+
+} // namespace ankh
@@ -16,6 +16,10 @@ Usage:
     pytest tests/test_integration.py -v --ankh-path=/path/to/Ankh.exe
 """
 
+import base64
+import json
+import math
+import struct
 import subprocess
 import time
 import os
@@ -29,6 +33,15 @@ STARTUP_TIMEOUT_SEC = 5
 # Timing tolerance in seconds for content rendering test
 TIMING_TOLERANCE_SEC = 1.0
 
+# Frames rendered by the headless test before the app exits on its own
+HEADLESS_FRAMES = 60
+
+# Timeout in seconds for the headless run to finish
+HEADLESS_TIMEOUT_SEC = 30
+
+# Timeout in seconds for a tool run (ankh_cook, ankh_bench)
+TOOL_TIMEOUT_SEC = 120
+
 # Global to cache the executable path
 _ankh_executable_path = None
 
@@ -98,12 +111,129 @@ def get_ankh_path() -> str:
     )
 
 
-def run_app_with_timeout(timeout_sec: int) -> tuple[int, str, float]:
+def get_tool_path(name: str) -> str:
+    """Get the path to a tool built next to the Ankh executable (ankh_bench, ankh_cook)."""
+    ankh_path = Path(get_ankh_path())
+    tool_path = ankh_path.with_name(name + ankh_path.suffix)
+
+    if not tool_path.exists():
+        raise FileNotFoundError(f"{tool_path.name} not found next to {ankh_path}")
+
+    return str(tool_path)
+
+
+def run_tool(name: str, args: tuple[str, ...]) -> subprocess.CompletedProcess:
+    """Run a tool to completion, capturing stdout and stderr as text."""
+    return subprocess.run(
+        [get_tool_path(name), *args],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        text=True,
+        errors='replace',
+        timeout=TOOL_TIMEOUT_SEC,
+    )
+
+
+def write_uv_sphere_gltf(path: Path, segments: int = 64, rings: int = 32) -> None:
+    """
+    Write an indexed UV sphere as a self-contained .gltf.
+
+    Like exported content it has attribute seams: the first column of vertices is repeated
+    with u = 1, and every pole is one vertex per segment with its own u.
+    """
+    positions, normals, uvs = [], [], []
+    for r in range(rings + 1):
+        theta = math.pi * r / rings
+        for s in range(segments + 1):
+            phi = 2.0 * math.pi * (s % segments) / segments
+            if r == 0 or r == rings:
+                p = (0.0, 1.0 if r == 0 else -1.0, 0.0)
+            else:
+                p = (math.sin(theta) * math.cos(phi), math.cos(theta),
+                     math.sin(theta) * math.sin(phi))
+            positions.append(p)
+            normals.append(p)
+            uvs.append((s / segments, r / rings))
+
+    indices = []
+    for r in range(rings):
+        for s in range(segments):
+            a = r * (segments + 1) + s
+            b, c = a + 1, a + segments + 1
+            if r != 0:
+                indices += [a, b, c]
+            if r != rings - 1:
+                indices += [b, c + 1, c]
+
+    count = len(positions)
+    blob = b''.join([
+        b''.join(struct.pack('<3f', *p) for p in positions),
+        b''.join(struct.pack('<3f', *n) for n in normals),
+        b''.join(struct.pack('<2f', *t) for t in uvs),
+        struct.pack(f'<{len(indices)}I', *indices),
+    ])
+
+    views, offset = [], 0
+    for size in (12 * count, 12 * count, 8 * count, 4 * len(indices)):
+        views.append({"buffer": 0, "byteOffset": offset, "byteLength": size})
+        offset += size
+
+    gltf = {
+        "asset": {"version": "2.0"},
+        "buffers": [{
+            "byteLength": len(blob),
+            "uri": "data:application/octet-stream;base64," + base64.b64encode(blob).decode(),
+        }],
+        "bufferViews": views,
+        "accessors": [
+            {"bufferView": 0, "componentType": 5126, "count": count, "type": "VEC3",
+             "min": [-1.0, -1.0, -1.0], "max": [1.0, 1.0, 1.0]},
+            {"bufferView": 1, "componentType": 5126, "count": count, "type": "VEC3"},
+            {"bufferView": 2, "componentType": 5126, "count": count, "type": "VEC2"},
+            {"bufferView": 3, "componentType": 5125, "count": len(indices), "type": "SCALAR"},
+        ],
+        "meshes": [{"primitives": [{
+            "attributes": {"POSITION": 0, "NORMAL": 1, "TEXCOORD_0": 2}, "indices": 3}]}],
+        "nodes": [{"mesh": 0}],
+        "scenes": [{"nodes": [0]}],
+        "scene": 0,
+    }
+    path.write_text(json.dumps(gltf))
+
+
+def read_package_lods(path: Path) -> list[list[int]]:
+    """Index counts of every mesh's levels of detail in a cooked package, finest first."""
+    data = path.read_bytes()
+
+    # PackageHeader: magic, version, sourceHash, flags, lodLevels, then (offset, size) ranges
+    # for nodes, meshes, lods, clusters, materials and images (scene/cooked-package.hpp)
+    magic, _version = struct.unpack_from('<II', data, 0)
+    assert magic == 0x474B5041, f"{path} is not a package"
+    meshes_offset, meshes_size = struct.unpack_from('<QQ', data, 40)
+    lods_offset, _lods_size = struct.unpack_from('<QQ', data, 56)
+
+    result = []
+    for m in range(meshes_size // 80):  # sizeof(PackageMesh)
+        mesh = meshes_offset + 80 * m
+        (first_lod,) = struct.unpack_from('<I', data, mesh + 20)
+        (lod_count,) = struct.unpack_from('<B', data, mesh + 34)
+
+        counts = []
+        for level in range(lod_count):
+            lod = lods_offset + 24 * (first_lod + level)  # sizeof(PackageLod)
+            counts.append(struct.unpack_from('<I', data, lod + 16)[0])
+        result.append(counts)
+
+    return result
+
+
+def run_app_with_timeout(timeout_sec: int, args: tuple[str, ...] = ()) -> tuple[int, str, float]:
     """
     Run the Ankh application for a specified duration and capture output.
 
     Args:
         timeout_sec: How long to wait before terminating the app.
+        args: Extra command line arguments passed to the app.
 
     Returns:
         A tuple of (exit_code, stderr_output, elapsed_time_seconds):
@@ -117,7 +247,7 @@ def run_app_with_timeout(timeout_sec: int) -> tuple[int, str, float]:
 
     try:
         proc = subprocess.Popen(
-            [ankh_path],
+            [ankh_path, *args],
             stdout=subprocess.PIPE,
             stderr=subprocess.PIPE,
         )
@@ -192,5 +322,186 @@ class TestAppStartup:
         )
 
 
+class TestHeadless:
+    """Integration tests for the headless (offscreen) rendering mode."""
+
+    def test_Ok(self):
+        """Verify a fixed number of headless frames render and the app exits cleanly."""
+        exit_code, stderr, elapsed = run_app_with_timeout(
+            HEADLESS_TIMEOUT_SEC, ("--headless", f"--frames={HEADLESS_FRAMES}"))
+
+        assert exit_code == 0, (
+            f"Headless run failed with exit code {exit_code}\n"
+            f"Stderr: {stderr}"
+        )
+
+        assert elapsed < HEADLESS_TIMEOUT_SEC, (
+            f"Headless run did not finish within {HEADLESS_TIMEOUT_SEC}s\n"
+            f"Stderr: {stderr}"
+        )
+
+        assert not has_validation_errors(stderr), (
+            f"Vulkan validation errors detected:\n{stderr}"
+        )
+
+    # Parallel recording only runs for direct draws (--no-indirect) and from
+    # parallelRecordMinDraws batches up; a threshold of 1 makes every frame take it. With
+    # --job-threads=1 parallel_for runs all slices inline in one call.
+    PARALLEL_RECORD = ("--no-indirect", "--record-threads=4", "--parallel-record-min-draws=1")
+
+    @pytest.mark.parametrize("options", [
+        ("--no-indirect",),
+        ("--no-gpu-cull",),
+        ("--no-meshlets",),
+        ("--no-vertex-compression",),
+        PARALLEL_RECORD,
+        PARALLEL_RECORD + ("--job-threads=1",),
+    ], ids=" ".join)
+    def test_option(self, options):
+        """Verify each alternative draw path renders cleanly with validation enabled."""
+        exit_code, stderr, elapsed = run_app_with_timeout(
+            HEADLESS_TIMEOUT_SEC,
+            ("--headless", f"--frames={HEADLESS_FRAMES}", "--validation", *options))
+
+        assert exit_code == 0, (
+            f"Headless run with {options} failed with exit code {exit_code}\n"
+            f"Stderr: {stderr}"
+        )
+
+        assert not has_validation_errors(stderr), (
+            f"Vulkan validation errors detected with {options}:\n{stderr}"
+        )
+
+
+class TestBench:
+    """Integration tests for the ankh_bench frame-loop benchmark."""
+
+    SIZES = (1, 64)
+    FRAMES = 5
+
+    # Per-series statistics written by summarize() in bench/bench-main.cpp
+    STATS = ("samples", "mean", "min", "p50", "p95", "p99", "max")
+
+    def test_report(self):
+        """Verify the JSON report's schema and that every percentile series is ordered."""
+        sizes = ",".join(str(size) for size in self.SIZES)
+        result = run_tool(
+            "ankh_bench", (f"--sizes={sizes}", "--warmup=2", f"--frames={self.FRAMES}", "--out=-"))
+
+        assert result.returncode == 0, f"ankh_bench failed:\n{result.stderr}"
+
+        # With --out=- stdout must be the report and nothing else (logs included)
+        try:
+            report = json.loads(result.stdout)
+        except json.JSONDecodeError as e:
+            pytest.fail(f"stdout is not only the JSON report ({e}):\n{result.stdout}")
+        for key in ("device", "build", "validation", "extent", "framesInFlight", "indirectDraw",
+                    "gpuCulling", "meshlets", "jobThreads", "recordThreads", "gpuTimestamps",
+                    "warmupFrames", "measuredFrames", "runs"):
+            assert key in report, f"Report is missing '{key}'"
+
+        assert [run["objects"] for run in report["runs"]] == list(self.SIZES)
+
+        for run in report["runs"]:
+            series = ["cpu_ms", "fence_wait_ms", "packets_rebuilt", "changed_objects",
+                      "uploaded_objects"]
+            if report["gpuTimestamps"]:
+                series.append("gpu_ms")
+
+            for name in series:
+                stats = run[name]
+                assert stats is not None, f"{name} has no samples"
+                assert set(stats) == set(self.STATS), f"{name}: unexpected keys {sorted(stats)}"
+                assert stats["samples"] == self.FRAMES, f"{name}: {stats}"
+                assert (stats["min"] <= stats["p50"] <= stats["p95"] <= stats["p99"]
+                        <= stats["max"]), f"{name}: percentiles out of order {stats}"
+
+
+class TestCook:
+    """Integration tests for ankh_cook and loading its packages."""
+
+    def test_cook_and_load(self, tmp_path):
+        """Verify a cook, an up-to-date rerun, and a headless run from the package."""
+        source = tmp_path / "sphere.gltf"
+        write_uv_sphere_gltf(source)
+        args = (f"--out-dir={tmp_path}", str(source))
+
+        result = run_tool("ankh_cook", args)
+        assert result.returncode == 0, f"ankh_cook failed:\n{result.stderr}"
+        assert "1 cooked" in result.stderr, f"Expected one package cooked:\n{result.stderr}"
+
+        package = tmp_path / "sphere.ankhpkg"
+        assert package.exists(), f"{package} was not written"
+
+        result = run_tool("ankh_cook", args)
+        assert result.returncode == 0, f"ankh_cook rerun failed:\n{result.stderr}"
+        assert "1 up to date" in result.stderr, (
+            f"Unchanged input was cooked again:\n{result.stderr}"
+        )
+
+        exit_code, stderr, elapsed = run_app_with_timeout(
+            HEADLESS_TIMEOUT_SEC,
+            ("--headless", f"--frames={HEADLESS_FRAMES}", "--validation", f"--model={package}"))
+
+        assert exit_code == 0, (
+            f"Headless run of {package.name} failed with exit code {exit_code}\n"
+            f"Stderr: {stderr}"
+        )
+
+        assert not has_validation_errors(stderr), (
+            f"Vulkan validation errors detected:\n{stderr}"
+        )
+
+
+    def test_parallel_inputs(self, tmp_path):
+        """Verify concurrent cooks match single-threaded ones and one failure stays isolated."""
+        sources = []
+        for segments in (16, 24, 32, 48):
+            source = tmp_path / f"sphere{segments}.gltf"
+            write_uv_sphere_gltf(source, segments=segments, rings=segments // 2)
+            sources.append(str(source))
+
+        broken = tmp_path / "broken.gltf"
+        broken.write_text("{")
+        sources.append(str(broken))
+
+        # Inputs run as jobs that nest their own parallel_for calls and waits; one thread
+        # runs everything inline
+        levels = {}
+        for threads in (4, 1):
+            out_dir = tmp_path / f"threads{threads}"
+            result = run_tool(
+                "ankh_cook", (f"--out-dir={out_dir}", f"--job-threads={threads}", *sources))
+
+            assert result.returncode != 0, "A failed input must fail the cook"
+            assert "4 cooked" in result.stderr and "1 failed" in result.stderr, (
+                f"Expected four packages and one failure:\n{result.stderr}"
+            )
+
+            levels[threads] = [read_package_lods(out_dir / (Path(s).stem + ".ankhpkg"))
+                               for s in sources[:-1]]
+
+        assert levels[4] == levels[1], "Cooking in parallel changed the packages"
+
+
+class TestMeshLods:
+    """Integration tests for level-of-detail generation, through ankh_cook packages."""
+
+    def test_seamed_sphere_reaches_target(self, tmp_path):
+        """Verify a UV sphere, seams and poles included, halves its triangles per level."""
+        source = tmp_path / "sphere.gltf"
+        write_uv_sphere_gltf(source)
+
+        result = run_tool("ankh_cook", (f"--out-dir={tmp_path}", "--lod-levels=3", str(source)))
+        assert result.returncode == 0, f"ankh_cook failed:\n{result.stderr}"
+
+        (levels,) = read_package_lods(tmp_path / "sphere.ankhpkg")
+        assert len(levels) == 4, f"Expected 3 levels of detail below level 0, got {levels}"
+
+        # Mesh::build_lods asks each level for half the previous level's triangles
+        for previous, level in zip(levels, levels[1:]):
+            assert level // 3 <= (previous // 3) // 2, f"Level missed its target: {levels}"
+
+
 if __name__ == "__main__":
     pytest.main([__file__, "-v"])